@@ -12,72 +12,130 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <condition_variable>
-#include <deque>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
 #include <limits>
 #include <mutex>
+#include <utility>
 #include <vector>
 
+/**
+ * @brief Single producer, single consumer queue of audio samples.
+ *
+ * The samples are stored in a preallocated ring buffer. emplace() (only called by the producer) and pop() (only called
+ * by the consumer) never lock and never allocate, so they can be used from the real-time PortAudio callbacks. If the
+ * buffer is full, emplace() drops the samples which do not fit (an overrun); if pop() is asked for more samples than
+ * available before the end of the stream, it returns the available ones (an underrun). Both are counted.
+ *
+ * The non real-time side (the Vorbis encoder/decoder threads) waits for the other side with waitForProducer() and
+ * waitForConsumer(). A notification can be missed, in which case the waiting thread wakes up on the next one, one
+ * callback later.
+ */
 template <typename T>
 class AudioQueue {
 public:
+    /**
+     * Default capacity, in samples: about 5 seconds of stereo audio at 48kHz
+     */
+    static constexpr size_t DEFAULT_CAPACITY = size_t(1) << 19;
+
+    /**
+     * @param capacity The maximal number of samples in the queue, rounded up to a power of 2
+     */
+    explicit AudioQueue(size_t capacity = DEFAULT_CAPACITY) {
+        size_t roundedCapacity = 1;
+        while (roundedCapacity < capacity) { roundedCapacity <<= 1; }
+        this->buffer.resize(roundedCapacity);
+        this->mask = roundedCapacity - 1;
+    }
+
+    /**
+     * Must not be called while the producer or the consumer is running
+     */
     void reset() {
-        std::lock_guard<std::mutex> lock(internalLock);
+        std::lock_guard<std::mutex> lock(queueLock);
         this->popNotified = false;
         this->pushNotified = false;
         this->streamEnd = false;
-        internalQueue.clear();
+        this->head = 0;
+        this->tail = 0;
+        this->underruns = 0;
+        this->overruns = 0;
 
         this->sampleRate = -1;
         this->channels = 0;
     }
 
-    bool empty() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.empty();
-    }
+    bool empty() const { return size() == 0; }
 
-    size_t size() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return internalQueue.size();
+    size_t size() const {
+        // Load the tail first: the head can only increase meanwhile, so that the difference never underflows
+        size_t t = this->tail.load(std::memory_order_acquire);
+        return this->head.load(std::memory_order_acquire) - t;
     }
 
+    size_t capacity() const { return this->buffer.size(); }
+
+    /**
+     * @brief Append the samples [begI, endI) to the queue. Only called by the producer.
+     * If they do not all fit, the last ones are dropped and an overrun is counted.
+     */
     template <typename Iter>
     void emplace(Iter begI, Iter endI) {
-        std::lock_guard<std::mutex> lock(internalLock);
-        std::move(begI, endI, std::front_inserter(internalQueue));
+        const size_t h = this->head.load(std::memory_order_relaxed);
+        const size_t available = capacity() - (h - this->tail.load(std::memory_order_acquire));
+
+        auto n = static_cast<size_t>(std::distance(begI, endI));
+        if (n > available) {
+            this->overruns.fetch_add(1, std::memory_order_relaxed);
+            n = available;
+            // Only keep whole frames
+            if (uint32_t ch = this->channels.load(std::memory_order_relaxed); ch != 0) {
+                n -= n % ch;
+            }
+        }
 
-        this->pushNotified = true;
+        for (size_t i = 0; i < n; ++i, ++begI) { this->buffer[(h + i) & this->mask] = std::move(*begI); }
+        this->head.store(h + n, std::memory_order_release);
+
+        this->pushNotified.store(true, std::memory_order_release);
         this->pushLockCondition.notify_one();
     }
 
+    /**
+     * @brief Move up to nSamples samples (whole frames only) out of the queue. Only called by the consumer.
+     * Returning less than nSamples samples before the end of the stream counts as an underrun.
+     */
     template <typename InsertIter>
     InsertIter pop(InsertIter insertIter, size_t nSamples) {
-        std::lock_guard<std::mutex> lock(internalLock);
-
-        if (this->channels == 0) {
-            this->popNotified = true;
-            this->popLockCondition.notify_one();
+        const uint32_t ch = this->channels.load(std::memory_order_relaxed);
+        if (ch == 0) {
+            notifyConsumed();
             return insertIter;
         }
 
+        const size_t t = this->tail.load(std::memory_order_relaxed);
+        const size_t queueSize = this->head.load(std::memory_order_acquire) - t;
+        const size_t returnBufferLength = std::min<size_t>(nSamples, queueSize - queueSize % ch);
+        if (returnBufferLength < nSamples && !hasStreamEnded()) {
+            this->underruns.fetch_add(1, std::memory_order_relaxed);
+        }
 
-        auto queueSize = internalQueue.size();
-        auto returnBufferLength = std::min<size_t>(nSamples, queueSize - queueSize % this->channels);
-        auto begI = rbegin(internalQueue);
-        auto endI = std::next(begI, returnBufferLength);
-
-        auto ret = std::move(begI, endI, insertIter);
-        internalQueue.erase(endI.base(), begI.base());
+        for (size_t i = 0; i < returnBufferLength; ++i, ++insertIter) {
+            *insertIter = std::move(this->buffer[(t + i) & this->mask]);
+        }
+        this->tail.store(t + returnBufferLength, std::memory_order_release);
 
-        this->popNotified = true;
-        this->popLockCondition.notify_one();
-        return ret;
+        notifyConsumed();
+        return insertIter;
     }
 
     void signalEndOfStream() {
-        std::lock_guard<std::mutex> lock(internalLock);
+        std::lock_guard<std::mutex> lock(queueLock);
         this->streamEnd = true;
         this->pushNotified = true;
         this->popNotified = true;
@@ -88,31 +146,20 @@ public:
     void waitForProducer(std::unique_lock<std::mutex>& lock) {
         // static_assert(lock.mutex() == &this->queueLock);
         assert(lock.mutex() == &this->queueLock);
-        while (!this->pushNotified && !hasStreamEnded()) { this->pushLockCondition.wait(lock); }
-        this->pushNotified = false;
+        while (!this->pushNotified.exchange(false) && !hasStreamEnded()) { this->pushLockCondition.wait(lock); }
     }
 
     void waitForConsumer(std::unique_lock<std::mutex>& lock) {
         // static_assert(lock.mutex() == &this->queueLock);
         assert(lock.mutex() == &this->queueLock);
-        while (!this->popNotified && !hasStreamEnded()) { this->popLockCondition.wait(lock); }
-        this->popNotified = false;
+        while (!this->popNotified.exchange(false) && !hasStreamEnded()) { this->popLockCondition.wait(lock); }
     }
 
-    bool hasStreamEnded() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return this->streamEnd;
-    }
+    bool hasStreamEnded() const { return this->streamEnd.load(std::memory_order_acquire); }
 
-    [[nodiscard]] std::unique_lock<std::mutex> acquire_lock() {
-        std::unique_lock retLock{this->queueLock, std::defer_lock};
-        std::lock(retLock, this->internalLock);
-        std::lock_guard{this->internalLock, std::adopt_lock};
-        return retLock;
-    }
+    [[nodiscard]] std::unique_lock<std::mutex> acquire_lock() { return std::unique_lock{this->queueLock}; }
 
     void setAudioAttributes(double lSampleRate, unsigned int lChannels) {
-        std::lock_guard<std::mutex> lock(internalLock);
         this->sampleRate = lSampleRate;
         this->channels = lChannels;
     }
@@ -123,24 +170,47 @@ public:
      * Todo (readability, type-safety): create a struct AudioAttributes; remove this comment
      */
 
-    [[nodiscard]] std::pair<double, uint32_t> getAudioAttributes() {
-        std::lock_guard<std::mutex> lock(internalLock);
-        return {this->sampleRate, this->channels};
+    [[nodiscard]] std::pair<double, uint32_t> getAudioAttributes() const { return {this->sampleRate, this->channels}; }
+
+    /**
+     * @return The number of calls to pop() which got less samples than requested, before the end of the stream
+     */
+    size_t getUnderrunCount() const { return this->underruns.load(std::memory_order_relaxed); }
+
+    /**
+     * @return The number of calls to emplace() which had to drop samples, as the queue was full
+     */
+    size_t getOverrunCount() const { return this->overruns.load(std::memory_order_relaxed); }
+
+private:
+    void notifyConsumed() {
+        this->popNotified.store(true, std::memory_order_release);
+        this->popLockCondition.notify_one();
     }
 
 private:
     std::mutex queueLock;
-    std::mutex internalLock;
 
-    std::deque<T> internalQueue;
+    std::vector<T> buffer;
+    size_t mask = 0;
+
+    /**
+     * Number of samples ever pushed (written by the producer) and popped (written by the consumer). The samples in the
+     * queue are buffer[tail & mask], ..., buffer[(head - 1) & mask].
+     */
+    alignas(64) std::atomic<size_t> head{0};
+    alignas(64) std::atomic<size_t> tail{0};
+
+    std::atomic<size_t> underruns{0};
+    std::atomic<size_t> overruns{0};
 
     std::condition_variable pushLockCondition;
     std::condition_variable popLockCondition;
 
-    double sampleRate{std::numeric_limits<double>::quiet_NaN()};
-    uint32_t channels{0};
+    std::atomic<double> sampleRate{std::numeric_limits<double>::quiet_NaN()};
+    std::atomic<uint32_t> channels{0};
 
-    bool streamEnd{false};
-    bool pushNotified{false};
-    bool popNotified{false};
+    std::atomic<bool> streamEnd{false};
+    std::atomic<bool> pushNotified{false};
+    std::atomic<bool> popNotified{false};
 };
@@ -61,6 +61,7 @@ auto PortAudioConsumer::startPlaying() -> bool {
     }
 
     this->outputChannels = channels;
+    this->underrunsAtStart = this->audioQueue.getUnderrunCount();
     portaudio::DirectionSpecificStreamParameters outParams(*device, channels, portaudio::FLOAT32, true,
                                                            device->defaultLowOutputLatency(), nullptr);
     portaudio::StreamParameters params(portaudio::DirectionSpecificStreamParameters::null(), outParams, sampleRate,
@@ -99,11 +100,7 @@ auto PortAudioConsumer::playCallback(const void* /*inputBuffer*/, void* outputBu
         // Fill buffer to requested length if necessary
 
         if (midI != endI) {
-            // Show underflow warning if there are not enough samples and the stream is not yet finished
-            if (!this->audioQueue.hasStreamEnded()) {
-                g_warning("PortAudioConsumer: Not enough audio samples available to fill requested frame");
-            }
-
+            // Underruns are counted by the queue, and reported when the playback stops
             if (midI > std::next(begI, this->outputChannels)) {
                 // If there is previous audio data use this data to ramp down the audio samples
                 std::transform(std::prev(midI, this->outputChannels), std::prev(endI, this->outputChannels), midI,
@@ -133,6 +130,10 @@ auto PortAudioConsumer::playCallback(const void* /*inputBuffer*/, void* outputBu
 void PortAudioConsumer::stopPlaying() {
     // Stop the playback
     if (this->outputStream) {
+        if (auto underruns = this->audioQueue.getUnderrunCount() - this->underrunsAtStart; underruns > 0) {
+            g_warning("PortAudioConsumer: Not enough audio samples available to fill %zu requested buffers", underruns);
+        }
+
         try {
             if (this->outputStream->isActive()) {
                 this->outputStream->stop();
@@ -46,4 +46,9 @@ private:
     std::unique_ptr<portaudio::MemFunCallbackStream<PortAudioConsumer>> outputStream;
 
     int outputChannels = 0;
+
+    /**
+     * Underruns of the queue before the current playback
+     */
+    size_t underrunsAtStart = 0;
 };
@@ -100,6 +100,10 @@ void PortAudioProducer::stopRecording() {
         } catch (portaudio::PaException& e) { g_message("PortAudioProducer: Closing stream failed"); }
     }
 
+    if (auto overruns = this->audioQueue.getOverrunCount(); overruns > 0) {
+        g_warning("PortAudioProducer: The audio queue was full, %zu recorded buffers were dropped", overruns);
+    }
+
     // Notify the consumer at the other side that there will be no more data
     this->audioQueue.signalEndOfStream();
 
@@ -3,6 +3,8 @@
 #include <cinttypes>
 #include <filesystem>
 
+#include "model/Document.h"
+
 #include "util/Util.h"
 #include "util/XojMsgBox.h"
 #include "util/i18n.h"
@@ -110,3 +112,15 @@ auto AudioController::getStartTime() const -> size_t { return this->timestamp; }
 auto AudioController::getOutputDevices() const -> vector<DeviceInfo> { return this->audioPlayer->getOutputDevices(); }
 
 auto AudioController::getInputDevices() const -> vector<DeviceInfo> { return this->audioRecorder->getInputDevices(); }
+
+auto AudioController::getAudioEntries(const PageRef& page) -> vector<AudioIndex::Entry> {
+    Document* doc = this->control.getDocument();
+    doc->lockShared();
+    vector<AudioIndex::Entry> entries = this->audioIndex.getPageEntries(page);
+    doc->unlockShared();
+    return entries;
+}
+
+void AudioController::invalidateAudioIndex(const PageRef& page) { this->audioIndex.invalidatePage(page); }
+
+void AudioController::invalidateAudioIndex() { this->audioIndex.clear(); }
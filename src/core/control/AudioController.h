@@ -18,6 +18,7 @@
 #include "audio/AudioRecorder.h"
 #include "control/settings/Settings.h"
 #include "gui/toolbarMenubar/ToolMenuHandler.h"
+#include "model/AudioIndex.h"
 
 #include "Control.h"
 #include "filesystem.h"
@@ -47,6 +48,21 @@ public:
     std::vector<DeviceInfo> getOutputDevices() const;
     std::vector<DeviceInfo> getInputDevices() const;
 
+    /**
+     * @return The audio enabled elements of the page, from the audio index
+     */
+    std::vector<AudioIndex::Entry> getAudioEntries(const PageRef& page);
+
+    /**
+     * Must be called whenever elements of the page are added, removed or modified
+     */
+    void invalidateAudioIndex(const PageRef& page);
+
+    /**
+     * Must be called when another document is loaded
+     */
+    void invalidateAudioIndex();
+
 private:
     Settings& settings;
     Control& control;
@@ -61,4 +77,6 @@ private:
 
     fs::path audioFilename;
     size_t timestamp = 0;
+
+    AudioIndex audioIndex;
 };
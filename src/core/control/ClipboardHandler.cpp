@@ -1,6 +1,9 @@
 #include "ClipboardHandler.h"
 
+#include <algorithm>
+#include <optional>
 #include <set>
+#include <string>
 #include <utility>
 
 #include <cairo-svg.h>
@@ -9,7 +12,6 @@
 #include "model/Text.h"
 #include "util/Util.h"
 #include "util/pixbuf-utils.h"
-#include "util/serializing/BinObjectEncoding.h"
 #include "util/serializing/ObjectInputStream.h"
 #include "util/serializing/ObjectOutputStream.h"
 #include "view/SelectionView.h"
@@ -20,49 +22,8 @@ using std::string;
 
 ClipboardListener::~ClipboardListener() = default;
 
-ClipboardHandler::ClipboardHandler(ClipboardListener* listener, GtkWidget* widget) {
-    this->listener = listener;
-    this->clipboard = gtk_widget_get_clipboard(widget, GDK_SELECTION_CLIPBOARD);
-
-    this->hanlderId = g_signal_connect(this->clipboard, "owner-change", G_CALLBACK(&ownerChangedCallback), this);
-
-    this->listener->clipboardCutCopyEnabled(false);
-
-    gtk_clipboard_request_contents(clipboard, gdk_atom_intern_static_string("TARGETS"),
-                                   reinterpret_cast<GtkClipboardReceivedFunc>(receivedClipboardContents), this);
-}
-
-ClipboardHandler::~ClipboardHandler() { g_signal_handler_disconnect(this->clipboard, this->hanlderId); }
-
 static GdkAtom atomXournal = gdk_atom_intern_static_string("application/xournal");
 
-auto ClipboardHandler::paste() -> bool {
-    if (this->containsXournal) {
-        gtk_clipboard_request_contents(this->clipboard, atomXournal,
-                                       reinterpret_cast<GtkClipboardReceivedFunc>(pasteClipboardContents), this);
-        return true;
-    }
-    if (this->containsText) {
-        gtk_clipboard_request_text(this->clipboard, reinterpret_cast<GtkClipboardTextReceivedFunc>(pasteClipboardText),
-                                   this);
-        return true;
-    }
-    if (this->containsImage) {
-        gtk_clipboard_request_image(this->clipboard,
-                                    reinterpret_cast<GtkClipboardImageReceivedFunc>(pasteClipboardImage), this);
-        return true;
-    }
-
-    return false;
-}
-
-auto ClipboardHandler::cut() -> bool {
-    bool result = this->copy();
-    this->listener->deleteSelection();
-
-    return result;
-}
-
 auto ElementCompareFunc(Element* a, Element* b) -> bool {
     if (a->getY() == b->getY()) {
         return (a->getX() - b->getX()) < 0;
@@ -73,139 +34,267 @@ auto ElementCompareFunc(Element* a, Element* b) -> bool {
 static GdkAtom atomSvg1 = gdk_atom_intern_static_string("image/svg");
 static GdkAtom atomSvg2 = gdk_atom_intern_static_string("image/svg+xml");
 
-// The contents of the clipboard
-class ClipboardContents {
+static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
+    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
+    return CAIRO_STATUS_SUCCESS;
+}
+
+// The contents of the clipboard: copies of the selected elements, from which the formats are produced when they
+// are requested
+class ClipboardContents: public ElementContainer {
 public:
-    ClipboardContents(string text, GdkPixbuf* image, string svg, GString* str) {
-        this->text = std::move(text);
-        this->image = image;
-        this->svg = std::move(svg);
-        this->str = str;
+    ClipboardContents(ClipboardHandler* handler, const EditSelection* selection): handler(handler) {
+        ObjectOutputStream out;
+        out.writeString(PROJECT_STRING);
+        selection->serializeBounds(out);
+        this->header = out.getStr();
+
+        // The copies of the strokes share the point data of the originals until one of them is edited
+        this->elements.reserve(selection->getElements().size());
+        for (Element* e: selection->getElements()) { this->elements.push_back(e->clone()); }
+
+        this->x = selection->getXOnView();
+        this->y = selection->getYOnView();
+        this->width = selection->getWidth();
+        this->height = selection->getHeight();
     }
 
-    ~ClipboardContents() {
-        g_object_unref(this->image);
-        g_string_free(this->str, true);
+    ~ClipboardContents() override {
+        if (this->handler && this->handler->ownContents == this) {
+            this->handler->ownContents = nullptr;
+        }
+        for (Element* e: this->elements) { delete e; }
+        g_string_free(this->header, true);
+        if (this->xournal) {
+            g_string_free(this->xournal, true);
+        }
+        if (this->image) {
+            g_object_unref(this->image);
+        }
+    }
+
+    auto getElements() const -> const std::vector<Element*>& override { return this->elements; }
+
+    auto hasText() const -> bool {
+        return std::any_of(this->elements.begin(), this->elements.end(),
+                           [](Element* e) { return e->getType() == ELEMENT_TEXT; });
+    }
+
+    /**
+     * @return New copies of the elements, to be pasted
+     */
+    auto cloneElements() const -> std::vector<std::unique_ptr<Element>> {
+        std::vector<std::unique_ptr<Element>> copies;
+        copies.reserve(this->elements.size());
+        for (Element* e: this->elements) { copies.emplace_back(e->clone()); }
+        return copies;
     }
 
+    /**
+     * @return The selection, without the elements
+     */
+    auto getHeader() const -> const GString* { return this->header; }
+
+    /**
+     * The handler is destroyed before the clipboard releases the contents
+     */
+    void detach() { this->handler = nullptr; }
 
     static void getFunction(GtkClipboard* clipboard, GtkSelectionData* selection, guint info,
                             ClipboardContents* contents) {
         GdkAtom target = gtk_selection_data_get_target(selection);
 
         if (target == gdk_atom_intern_static_string("UTF8_STRING")) {
-            gtk_selection_data_set_text(selection, contents->text.c_str(), -1);
+            gtk_selection_data_set_text(selection, contents->getText().c_str(), -1);
         } else if (target == gdk_atom_intern_static_string("image/png") ||
                    target == gdk_atom_intern_static_string("image/jpeg") ||
                    target == gdk_atom_intern_static_string("image/gif")) {
-            gtk_selection_data_set_pixbuf(selection, contents->image);
+            gtk_selection_data_set_pixbuf(selection, contents->getImage());
         } else if (atomSvg1 == target || atomSvg2 == target) {
-            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(contents->svg.c_str()),
-                                   static_cast<gint>(contents->svg.length()));
+            const std::string& svg = contents->getSvg();
+            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar const*>(svg.c_str()),
+                                   static_cast<gint>(svg.length()));
         } else if (atomXournal == target) {
-            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar*>(contents->str->str),
-                                   static_cast<gint>(contents->str->len));
+            const GString* str = contents->getXournal();
+            gtk_selection_data_set(selection, target, 8, reinterpret_cast<guchar*>(str->str),
+                                   static_cast<gint>(str->len));
         }
     }
 
     static void clearFunction(GtkClipboard* clipboard, ClipboardContents* contents) { delete contents; }
 
 private:
-    string text;
-    GdkPixbuf* image;
-    string svg;
-    GString* str;
-};
+    auto getText() const -> string {
+        std::multiset<Text*, decltype(&ElementCompareFunc)> textElements(ElementCompareFunc);
 
-static auto svgWriteFunction(GString* string, const unsigned char* data, unsigned int length) -> cairo_status_t {
-    g_string_append_len(string, reinterpret_cast<const gchar*>(data), length);
-    return CAIRO_STATUS_SUCCESS;
-}
+        for (Element* e: this->elements) {
+            if (e->getType() == ELEMENT_TEXT) {
+                textElements.insert(dynamic_cast<Text*>(e));
+            }
+        }
 
-auto ClipboardHandler::copy() -> bool {
-    if (!this->selection) {
-        return false;
+        string text{};
+        for (Text* t: textElements) {
+            if (!text.empty()) {
+                text += "\n";
+            }
+            text += t->getText();
+        }
+        return text;
     }
 
-    /////////////////////////////////////////////////////////////////
-    // prepare xournal contents
-    /////////////////////////////////////////////////////////////////
+    auto getImage() -> GdkPixbuf* {
+        if (this->image) {
+            return this->image;
+        }
 
-    ObjectOutputStream out(new BinObjectEncoding());
+        double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
 
-    out.writeString(PROJECT_STRING);
+        int width = static_cast<int>(this->width * dpiFactor);
+        int height = static_cast<int>(this->height * dpiFactor);
+        cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+        cairo_t* crPng = cairo_create(surfacePng);
+        cairo_scale(crPng, dpiFactor, dpiFactor);
 
-    this->selection->serialize(out);
+        cairo_translate(crPng, -this->x, -this->y);
 
-    /////////////////////////////////////////////////////////////////
-    // prepare text contents
-    /////////////////////////////////////////////////////////////////
+        xoj::view::SelectionView view(this);
+        view.draw(xoj::view::Context::createDefault(crPng));
 
-    std::multiset<Text*, decltype(&ElementCompareFunc)> textElements(ElementCompareFunc);
+        cairo_destroy(crPng);
 
-    for (Element* e: this->selection->getElements()) {
-        if (e->getType() == ELEMENT_TEXT) {
-            textElements.insert(dynamic_cast<Text*>(e));
-        }
+        this->image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
+
+        cairo_surface_destroy(surfacePng);
+        return this->image;
     }
 
-    string text{};
-    for (Text* t: textElements) {
-        if (!text.empty()) {
-            text += "\n";
+    auto getSvg() -> const string& {
+        if (this->svg) {
+            return *this->svg;
         }
-        text += t->getText();
+
+        GString* svgString = g_string_sized_new(1048576);  // 1MB
+
+        cairo_surface_t* surfaceSVG = cairo_svg_surface_create_for_stream(
+                reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString, this->width, this->height);
+        cairo_t* crSVG = cairo_create(surfaceSVG);
+
+        xoj::view::SelectionView view(this);
+        view.draw(xoj::view::Context::createDefault(crSVG));
+
+        cairo_surface_destroy(surfaceSVG);
+        cairo_destroy(crSVG);
+
+        this->svg.emplace(svgString->str, svgString->len);
+        g_string_free(svgString, true);
+        return *this->svg;
     }
 
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: PNG
-    /////////////////////////////////////////////////////////////////
+    auto getXournal() -> const GString* {
+        if (this->xournal) {
+            return this->xournal;
+        }
 
-    double dpiFactor = 1.0 / Util::DPI_NORMALIZATION_FACTOR * 300.0;
+        ObjectOutputStream out;
+        out.writeInt(static_cast<int>(this->elements.size()));
+        for (Element* e: this->elements) { e->serialize(out); }
+        GString* elementData = out.getStr();
+
+        // Both streams begin with the version string: the one of the elements is dropped
+        GString* version = ObjectOutputStream().getStr();
+        this->xournal = g_string_new_len(this->header->str, static_cast<gssize>(this->header->len));
+        g_string_append_len(this->xournal, elementData->str + version->len,
+                            static_cast<gssize>(elementData->len - version->len));
+        g_string_free(version, true);
+        g_string_free(elementData, true);
+        return this->xournal;
+    }
 
-    int width = static_cast<int>(selection->getWidth() * dpiFactor);
-    int height = static_cast<int>(selection->getHeight() * dpiFactor);
-    cairo_surface_t* surfacePng = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
-    cairo_t* crPng = cairo_create(surfacePng);
-    cairo_scale(crPng, dpiFactor, dpiFactor);
+private:
+    ClipboardHandler* handler;
+
+    std::vector<Element*> elements;
+    GString* header = nullptr;  ///< Version, project string and selection, as written by EditSelection::serialize
+    double x = 0;
+    double y = 0;
+    double width = 0;
+    double height = 0;
+
+    GdkPixbuf* image = nullptr;      ///< Rendered on first request
+    std::optional<std::string> svg;  ///< Rendered on first request
+    GString* xournal = nullptr;      ///< Serialized on first request, for other instances
+};
 
-    cairo_translate(crPng, -selection->getXOnView(), -selection->getYOnView());
+ClipboardHandler::ClipboardHandler(ClipboardListener* listener, GtkWidget* widget) {
+    this->listener = listener;
+    this->clipboard = gtk_widget_get_clipboard(widget, GDK_SELECTION_CLIPBOARD);
 
-    xoj::view::SelectionView view(this->selection);
-    view.draw(xoj::view::Context::createDefault(crPng));
+    this->hanlderId = g_signal_connect(this->clipboard, "owner-change", G_CALLBACK(&ownerChangedCallback), this);
 
-    cairo_destroy(crPng);
+    this->listener->clipboardCutCopyEnabled(false);
 
-    GdkPixbuf* image = xoj_pixbuf_get_from_surface(surfacePng, 0, 0, width, height);
+    gtk_clipboard_request_contents(clipboard, gdk_atom_intern_static_string("TARGETS"),
+                                   reinterpret_cast<GtkClipboardReceivedFunc>(receivedClipboardContents), this);
+}
 
-    cairo_surface_destroy(surfacePng);
+ClipboardHandler::~ClipboardHandler() {
+    g_signal_handler_disconnect(this->clipboard, this->hanlderId);
+    if (this->ownContents) {
+        this->ownContents->detach();
+    }
+}
 
-    /////////////////////////////////////////////////////////////////
-    // prepare image contents: SVG
-    /////////////////////////////////////////////////////////////////
+auto ClipboardHandler::paste() -> bool {
+    if (this->ownContents) {
+        // Copied by this instance: the elements are copied again, without serialization
+        ObjectInputStream in;
+        const GString* header = this->ownContents->getHeader();
+        if (in.read(header->str, static_cast<int>(header->len))) {
+            this->listener->clipboardPasteElements(in, this->ownContents->cloneElements());
+        }
+        return true;
+    }
+    if (this->containsXournal) {
+        gtk_clipboard_request_contents(this->clipboard, atomXournal,
+                                       reinterpret_cast<GtkClipboardReceivedFunc>(pasteClipboardContents), this);
+        return true;
+    }
+    if (this->containsText) {
+        gtk_clipboard_request_text(this->clipboard, reinterpret_cast<GtkClipboardTextReceivedFunc>(pasteClipboardText),
+                                   this);
+        return true;
+    }
+    if (this->containsImage) {
+        gtk_clipboard_request_image(this->clipboard,
+                                    reinterpret_cast<GtkClipboardImageReceivedFunc>(pasteClipboardImage), this);
+        return true;
+    }
 
-    GString* svgString = g_string_sized_new(1048576);  // 1MB
+    return false;
+}
 
-    cairo_surface_t* surfaceSVG =
-            cairo_svg_surface_create_for_stream(reinterpret_cast<cairo_write_func_t>(svgWriteFunction), svgString,
-                                                selection->getWidth(), selection->getHeight());
-    cairo_t* crSVG = cairo_create(surfaceSVG);
+auto ClipboardHandler::cut() -> bool {
+    bool result = this->copy();
+    this->listener->deleteSelection();
 
-    view.draw(xoj::view::Context::createDefault(crSVG));
+    return result;
+}
 
-    cairo_surface_destroy(surfaceSVG);
-    cairo_destroy(crSVG);
+auto ClipboardHandler::copy() -> bool {
+    if (!this->selection) {
+        return false;
+    }
 
-    /////////////////////////////////////////////////////////////////
-    // copy to clipboard
-    /////////////////////////////////////////////////////////////////
+    // Only the elements are copied: the other formats are produced when another application requests them
+    auto* contents = new ClipboardContents(this, this->selection);
 
     GtkTargetList* list = gtk_target_list_new(nullptr, 0);
     GtkTargetEntry* targets = nullptr;
     int n_targets = 0;
 
     // if we have text elements...
-    if (!text.empty()) {
+    if (contents->hasText()) {
         gtk_target_list_add_text_targets(list, 0);
     }
     // we always copy an image to clipboard
@@ -216,18 +305,16 @@ auto ClipboardHandler::copy() -> bool {
 
     targets = gtk_target_table_new_from_list(list, &n_targets);
 
-    auto* contents = new ClipboardContents(text, image, svgString->str, out.getStr());
-
     gtk_clipboard_set_with_data(this->clipboard, targets, static_cast<guint>(n_targets),
                                 reinterpret_cast<GtkClipboardGetFunc>(ClipboardContents::getFunction),
                                 reinterpret_cast<GtkClipboardClearFunc>(ClipboardContents::clearFunction), contents);
     gtk_clipboard_set_can_store(this->clipboard, nullptr, 0);
+    // Set after the contents replaced have been cleared
+    this->ownContents = contents;
 
     gtk_target_table_free(targets, n_targets);
     gtk_target_list_unref(list);
 
-    g_string_free(svgString, true);
-
     return true;
 }
 
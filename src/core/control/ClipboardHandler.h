@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -19,6 +20,8 @@
 #include "control/tools/EditSelection.h"
 
 
+class ClipboardContents;
+class Element;
 class ObjectInputStream;
 
 class ClipboardListener {
@@ -28,6 +31,12 @@ public:
     virtual void clipboardPasteText(std::string text) = 0;
     virtual void clipboardPasteImage(GdkPixbuf* img) = 0;
     virtual void clipboardPasteXournal(ObjectInputStream& in) = 0;
+    /**
+     * Paste elements copied in this instance
+     * @param in The selection, without the elements
+     * @param elements Copies of the elements, which share the immutable data of the copied ones
+     */
+    virtual void clipboardPasteElements(ObjectInputStream& in, std::vector<std::unique_ptr<Element>> elements) = 0;
     virtual void deleteSelection() = 0;
 
     virtual ~ClipboardListener();
@@ -69,4 +78,11 @@ private:
     bool containsText = false;
     bool containsXournal = false;
     bool containsImage = false;
+
+    /**
+     * The contents of the clipboard if they were copied by this handler, pasted without serialization
+     */
+    ClipboardContents* ownContents = nullptr;
+
+    friend class ClipboardContents;
 };
@@ -29,6 +29,8 @@
 #include "gui/inputdevices/HandRecognition.h"
 #include "gui/toolbarMenubar/model/ToolbarData.h"
 #include "gui/toolbarMenubar/model/ToolbarModel.h"
+#include "model/Layer.h"
+#include "model/StrokeDecodeCache.h"
 #include "model/StrokeStyle.h"
 #include "plugin/PluginController.h"
 #include "stockdlg/XojOpenDlg.h"
@@ -89,6 +91,9 @@ Control::Control(GApplication* gtkApp, GladeSearchpath* gladeSearchPath): gtkApp
 
     this->doc = new Document(this);
 
+    this->searchIndex = std::make_unique<SearchIndex>(this->doc, this->scheduler);
+    this->pdfTextLayoutCache = std::make_unique<PdfTextLayoutCache>(this->doc, this->scheduler);
+
     // for crashhandling
     setEmergencyDocument(this->doc);
 
@@ -230,6 +235,7 @@ auto Control::checkChangedDocument(Control* control) -> bool {
         }
     }
     control->changedPages.clear();
+    StrokeDecodeCache::trim(control->doc);
     control->doc->unlock();
 
     // Call again
@@ -1733,7 +1739,11 @@ void Control::undoRedoChanged() {
 
 void Control::undoRedoPageChanged(PageRef page) {
     if (std::find(begin(this->changedPages), end(this->changedPages), page) == end(this->changedPages)) {
-        this->changedPages.emplace_back(std::move(page));
+        this->changedPages.emplace_back(page);
+    }
+    this->searchIndex->invalidatePage(page);
+    if (audioController) {
+        audioController->invalidateAudioIndex(page);
     }
 }
 
@@ -2083,6 +2093,7 @@ auto Control::openFile(fs::path filepath, int scrollToPage, bool forceOpen) -> b
     }
 
     LoadHandler loadHandler;
+    loadHandler.setStrokeStorage(this->settings->getStrokeStorage());
     Document* loadedDocument = loadHandler.loadDocument(filepath);
     if ((loadedDocument != nullptr && loadHandler.isAttachedPdfMissing()) ||
         !loadHandler.getMissingPdfFilename().empty()) {
@@ -2201,6 +2212,12 @@ auto Control::loadXoptTemplate(fs::path const& filepath) -> bool {
 }
 
 void Control::fileLoaded(int scrollToPage) {
+    if (audioController) {
+        audioController->invalidateAudioIndex();
+    }
+    searchIndex->reset();
+    pdfTextLayoutCache->reset();
+
     this->doc->lock();
     auto filepath = this->doc->getEvMetadataFilename();
     this->doc->unlock();
@@ -2307,6 +2324,11 @@ auto Control::annotatePdf(fs::path filepath, bool /*attachPdf*/, bool attachToDo
     }
     getCursor()->setCursorBusy(false);
 
+    if (audioController) {
+        audioController->invalidateAudioIndex();
+    }
+    searchIndex->reset();
+    pdfTextLayoutCache->reset();
     fireDocumentChanged(DOCUMENT_CHANGE_COMPLETE);
 
     getCursor()->updateCursor();
@@ -2734,7 +2756,13 @@ void Control::clipboardPaste(Element* e) {
     win->getXournal()->setSelection(selection);
 }
 
-void Control::clipboardPasteXournal(ObjectInputStream& in) {
+void Control::clipboardPasteXournal(ObjectInputStream& in) { pasteXournal(in, nullptr); }
+
+void Control::clipboardPasteElements(ObjectInputStream& in, std::vector<std::unique_ptr<Element>> elements) {
+    pasteXournal(in, &elements);
+}
+
+void Control::pasteXournal(ObjectInputStream& in, std::vector<std::unique_ptr<Element>>* copies) {
     auto pNr = getCurrentPageNo();
     if (pNr == npos && win != nullptr) {
         return;
@@ -2765,27 +2793,33 @@ void Control::clipboardPasteXournal(ObjectInputStream& in) {
         // document lock not needed anymore, because we don't change the document, we only change the selection
         this->doc->unlock();
 
-        int count = in.readInt();
+        // The elements copied from another instance follow the selection in the stream
+        int count = copies ? static_cast<int>(copies->size()) : in.readInt();
         auto pasteAddUndoAction = std::make_unique<AddUndoAction>(page, false);
         // this will undo a group of elements that are inserted
 
         for (int i = 0; i < count; i++) {
-            string name = in.getNextObjectName();
             element.reset();
 
-            if (name == "Stroke") {
-                element = std::make_unique<Stroke>();
-            } else if (name == "Image") {
-                element = std::make_unique<Image>();
-            } else if (name == "TexImage") {
-                element = std::make_unique<TexImage>();
-            } else if (name == "Text") {
-                element = std::make_unique<Text>();
+            if (copies) {
+                element = std::move((*copies)[static_cast<size_t>(i)]);
             } else {
-                throw InputStreamException(FS(FORMAT_STR("Get unknown object {1}") % name), __FILE__, __LINE__);
-            }
+                string name = in.getNextObjectName();
+
+                if (name == "Stroke") {
+                    element = std::make_unique<Stroke>();
+                } else if (name == "Image") {
+                    element = std::make_unique<Image>();
+                } else if (name == "TexImage") {
+                    element = std::make_unique<TexImage>();
+                } else if (name == "Text") {
+                    element = std::make_unique<Text>();
+                } else {
+                    throw InputStreamException(FS(FORMAT_STR("Get unknown object {1}") % name), __FILE__, __LINE__);
+                }
 
-            element->readSerialized(in);
+                element->readSerialized(in);
+            }
 
             pasteAddUndoAction->addElement(layer, element.get(), layer->indexOf(element.get()));
             // Todo: unique_ptr
@@ -2932,6 +2966,10 @@ auto Control::getToolHandler() -> ToolHandler* { return this->toolHandler; }
 
 auto Control::getScheduler() -> XournalScheduler* { return this->scheduler; }
 
+auto Control::getSearchIndex() -> SearchIndex* { return this->searchIndex.get(); }
+
+auto Control::getPdfTextLayoutCache() -> PdfTextLayoutCache* { return this->pdfTextLayoutCache.get(); }
+
 auto Control::getWindow() -> MainWindow* { return this->win; }
 
 auto Control::getGtkWindow() const -> GtkWindow* { return GTK_WINDOW(this->win->getWindow()); }
@@ -32,8 +32,10 @@
 #include "Actions.h"
 #include "AudioController.h"
 #include "ClipboardHandler.h"
+#include "PdfTextLayoutCache.h"
 #include "RecentManager.h"
 #include "ScrollHandler.h"
+#include "SearchIndex.h"
 #include "ToolHandler.h"
 
 
@@ -226,6 +228,8 @@ public:
     void disableSidebarTmp(bool disabled);
 
     XournalScheduler* getScheduler();
+    SearchIndex* getSearchIndex();
+    PdfTextLayoutCache* getPdfTextLayoutCache();
 
     void block(const std::string& name);
     void unblock();
@@ -289,6 +293,7 @@ public:
     void clipboardPasteText(std::string text) override;
     void clipboardPasteImage(GdkPixbuf* img) override;
     void clipboardPasteXournal(ObjectInputStream& in) override;
+    void clipboardPasteElements(ObjectInputStream& in, std::vector<std::unique_ptr<Element>> elements) override;
     void deleteSelection() override;
 
     void clipboardPaste(Element* e);
@@ -343,6 +348,12 @@ private:
      */
     void applyPreferredLanguage();
 
+    /**
+     * Paste a selection of Xournal++ elements
+     * @param copies The elements, if they were copied in this instance. Otherwise they are read from the stream.
+     */
+    void pasteXournal(ObjectInputStream& in, std::vector<std::unique_ptr<Element>>* copies);
+
     RecentManager* recent = nullptr;
     UndoRedoHandler* undoRedo = nullptr;
     ZoomControl* zoom = nullptr;
@@ -397,6 +408,10 @@ private:
 
     XournalScheduler* scheduler;
 
+    std::unique_ptr<SearchIndex> searchIndex;
+
+    std::unique_ptr<PdfTextLayoutCache> pdfTextLayoutCache;
+
     /**
      * State / Blocking attributes
      */
@@ -31,11 +31,15 @@ LatexController::LatexController(Control* control):
         dlg(control->getGladeSearchPath(), settings),
         doc(control->getDocument()),
         texTmpDir(Util::getTmpDirSubfolder("tex")),
-        generator(settings) {
+        generator(settings),
+        cache(Util::getCacheSubfolder("latex")) {
     Util::ensureFolderExists(this->texTmpDir);
 }
 
 LatexController::~LatexController() {
+    auto stats = LatexCache::getStatistics();
+    g_debug("LaTeX cache: %zu hits, %zu misses (hit rate %.0f%%)", stats.hits, stats.misses, 100 * stats.hitRate());
+
     if (updating_cancellable) {
         g_cancellable_cancel(updating_cancellable);
         g_object_unref(updating_cancellable);
@@ -163,6 +167,20 @@ void LatexController::triggerImageUpdate(const string& texString) {
 
     this->lastPreviewedTex = texString;
     const std::string texContents = LatexGenerator::templateSub(texString, this->latexTemplate, textColor);
+
+    // The same formula was rendered before, with the same template, color and command
+    this->pendingCacheKey = LatexCache::computeKey(texContents, this->settings.genCmd);
+    if (auto cachedPdf = this->cache.lookup(this->pendingCacheKey)) {
+        this->isValidTex = true;
+        this->texProcessOutput = _("The formula was loaded from the cache.");
+        this->temporaryRender = this->loadRendered(texString, *cachedPdf);
+        if (this->temporaryRender != nullptr) {
+            this->dlg.setTempRender(this->temporaryRender->getPdf());
+        }
+        updateStatus();
+        return;
+    }
+
     auto result = generator.asyncRun(this->texTmpDir, texContents);
     if (auto* err = std::get_if<LatexGenerator::GenError>(&result)) {
         XojMsgBox::showErrorToUser(this->control->getGtkWindow(), err->message);
@@ -234,16 +252,18 @@ void LatexController::onPdfRenderComplete(GObject* procObj, GAsyncResult* res, L
         self->isValidTex = true;
     }
 
-    // Delete the PDF if the TeX is invalid.
+    // Delete the PDF if the TeX is invalid, cache it otherwise.
+    fs::path pdfPath = self->texTmpDir / "tex.pdf";
     if (!self->isValidTex) {
-        fs::path pdfPath = self->texTmpDir / "tex.pdf";
         fs::remove(pdfPath);
+    } else {
+        self->cache.store(self->pendingCacheKey, pdfPath);
     }
 
     const string currentTex = self->dlg.getBufferContents();
     bool shouldUpdate = self->lastPreviewedTex != currentTex;
     if (self->isValidTex) {
-        self->temporaryRender = self->loadRendered(currentTex);
+        self->temporaryRender = self->loadRendered(currentTex, pdfPath);
         if (self->temporaryRender != nullptr) {
             self->dlg.setTempRender(self->temporaryRender->getPdf());
         }
@@ -294,12 +314,11 @@ void LatexController::deleteOldImage() {
     }
 }
 
-auto LatexController::loadRendered(string renderedTex) -> std::unique_ptr<TexImage> {
+auto LatexController::loadRendered(string renderedTex, const fs::path& pdfPath) -> std::unique_ptr<TexImage> {
     if (!this->isValidTex) {
         return nullptr;
     }
 
-    fs::path pdfPath = texTmpDir / "tex.pdf";
     auto contents = Util::readString(pdfPath, true);
     if (!contents) {
         return nullptr;
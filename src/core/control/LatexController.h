@@ -20,6 +20,7 @@
 
 #include <poppler.h>
 
+#include "control/latex/LatexCache.h"
 #include "control/latex/LatexGenerator.h"
 #include "control/settings/LatexSettings.h"
 #include "gui/dialog/LatexDialog.h"
@@ -111,7 +112,7 @@ private:
     /**
      * Load the preview PDF from disk and create a TexImage object.
      */
-    std::unique_ptr<TexImage> loadRendered(std::string renderedTex);
+    std::unique_ptr<TexImage> loadRendered(std::string renderedTex, const fs::path& pdfPath);
 
     /**
      * Insert the generated preview TexImage into the current page.
@@ -222,4 +223,14 @@ private:
     std::unique_ptr<TexImage> temporaryRender;
 
     LatexGenerator generator;
+
+    /**
+     * PDFs generated previously, shared with other documents
+     */
+    LatexCache cache;
+
+    /**
+     * The cache key of the PDF being generated
+     */
+    std::string pendingCacheKey;
 };
@@ -0,0 +1,69 @@
+#include "PdfTextLayoutCache.h"
+
+#include "control/jobs/PdfTextLayoutJob.h"
+#include "control/jobs/Scheduler.h"
+#include "model/Document.h"
+#include "pdf/base/XojPdfTextLayout.h"
+
+PdfTextLayoutCache::PdfTextLayoutCache(Document* doc, Scheduler* scheduler): doc(doc), scheduler(scheduler) {}
+
+PdfTextLayoutCache::~PdfTextLayoutCache() = default;
+
+void PdfTextLayoutCache::reset() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    this->generation++;
+    this->layouts.clear();
+    this->pending.clear();
+}
+
+auto PdfTextLayoutCache::get(size_t pdfPage) -> std::shared_ptr<const XojPdfTextLayout> {
+    uint64_t jobGeneration = 0;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        for (auto it = this->layouts.begin(); it != this->layouts.end(); ++it) {
+            if (it->first == pdfPage) {
+                this->layouts.splice(this->layouts.begin(), this->layouts, it);
+                return it->second;
+            }
+        }
+
+        if (!this->pending.insert(pdfPage).second) {
+            return nullptr;
+        }
+        jobGeneration = this->generation;
+    }
+
+    auto* job = new PdfTextLayoutJob(this, jobGeneration, pdfPage);
+    this->scheduler->addJob(job, JOB_PRIORITY_HIGH);
+    job->unref();
+    return nullptr;
+}
+
+void PdfTextLayoutCache::extract(uint64_t generation, size_t pdfPage) {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex);
+        if (generation != this->generation) {
+            return;
+        }
+    }
+
+    doc->lockShared();
+    XojPdfPageSPtr pdf = doc->getPdfPage(pdfPage);
+    doc->unlockShared();
+
+    // The page is kept alive by the shared pointer: the document is not locked during the slow extraction
+    std::shared_ptr<const XojPdfTextLayout> layout = pdf ? pdf->getTextLayout() : nullptr;
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (generation != this->generation) {
+        return;
+    }
+    this->pending.erase(pdfPage);
+    if (!layout) {
+        return;
+    }
+    this->layouts.emplace_front(pdfPage, std::move(layout));
+    if (this->layouts.size() > MAX_PAGES) {
+        this->layouts.pop_back();
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * Xournal++
+ *
+ * Caches the text layouts of the PDF pages, for text selection
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+
+class Document;
+class Scheduler;
+class XojPdfTextLayout;
+
+/**
+ * @brief The text layouts (see XojPdfTextLayout) of the most recently used PDF pages.
+ *
+ * The layouts are extracted in the background by a PdfTextLayoutJob, the first time they are requested. Until then,
+ * the PDF text selection asks the PDF backend directly.
+ */
+class PdfTextLayoutCache {
+public:
+    static constexpr size_t MAX_PAGES = 32;
+
+    PdfTextLayoutCache(Document* doc, Scheduler* scheduler);
+    ~PdfTextLayoutCache();
+
+    PdfTextLayoutCache(const PdfTextLayoutCache&) = delete;
+    PdfTextLayoutCache& operator=(const PdfTextLayoutCache&) = delete;
+
+public:
+    /**
+     * @brief Drop all the layouts and cancel the pending extractions. Called after a document was loaded.
+     */
+    void reset();
+
+    /**
+     * @return The layout of the PDF page, nullptr if it is not extracted yet. In this case, its extraction is
+     * scheduled.
+     */
+    std::shared_ptr<const XojPdfTextLayout> get(size_t pdfPage);
+
+    /**
+     * @brief Extract the layout of the PDF page. Called by PdfTextLayoutJob, on the scheduler thread.
+     *
+     * @param generation Nothing is done if the cache was reset since the job was created
+     */
+    void extract(uint64_t generation, size_t pdfPage);
+
+private:
+    Document* doc;
+    Scheduler* scheduler;
+
+    std::mutex cacheMutex;
+    uint64_t generation = 0;
+
+    /**
+     * Most recently used first
+     */
+    std::list<std::pair<size_t, std::shared_ptr<const XojPdfTextLayout>>> layouts;
+
+    /**
+     * The PDF pages whose extraction is scheduled
+     */
+    std::set<size_t> pending;
+};
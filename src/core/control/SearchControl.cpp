@@ -3,7 +3,9 @@
 #include <utility>
 
 #include "model/Layer.h"
+#include "model/TexImage.h"
 #include "model/Text.h"
+#include "util/StringUtils.h"
 #include "view/TextView.h"
 
 using std::string;
@@ -54,6 +56,14 @@ auto SearchControl::search(std::string text, int* occures, double* top) -> bool
                 std::vector<XojPdfRectangle> textResult = xoj::view::TextView::findText(t, text);
 
                 this->results.insert(this->results.end(), textResult.begin(), textResult.end());
+            } else if (e->getType() == ELEMENT_TEXIMAGE) {
+                // Matches in the LaTeX source: mark the whole element
+                std::string source = StringUtils::toLowerCase(static_cast<TexImage*>(e)->getText());
+                std::string pattern = StringUtils::toLowerCase(text);
+                for (size_t pos = source.find(pattern); pos != std::string::npos; pos = source.find(pattern, pos + 1)) {
+                    this->results.emplace_back(e->getX(), e->getY(), e->getX() + e->getElementWidth(),
+                                               e->getY() + e->getElementHeight());
+                }
             }
         }
     }
@@ -0,0 +1,209 @@
+#include "SearchIndex.h"
+
+#include <utility>
+
+#include "control/jobs/Scheduler.h"
+#include "control/jobs/SearchIndexJob.h"
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/TexImage.h"
+#include "model/Text.h"
+#include "util/StringUtils.h"
+
+/**
+ * Separates the texts of the elements, so that a match never spans two elements
+ */
+constexpr char ELEMENT_SEPARATOR = '\0';
+
+SearchIndex::SearchIndex(Document* doc, Scheduler* scheduler): doc(doc), scheduler(scheduler) {}
+
+SearchIndex::~SearchIndex() = default;
+
+void SearchIndex::reset() {
+    doc->lock();
+    size_t pdfPageCount = doc->getPdfPageCount();
+    doc->unlock();
+
+    uint64_t newGeneration = 0;
+    {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        newGeneration = ++this->generation;
+        this->pdfTexts.clear();
+        this->pdfTexts.resize(pdfPageCount);
+        this->nextPdfPage = 0;
+    }
+    this->pageTexts.clear();
+    this->countedPattern.clear();
+
+    continueIndexing(newGeneration);
+}
+
+void SearchIndex::invalidatePage(const PageRef& page) { this->pageTexts.erase(page); }
+
+auto SearchIndex::isComplete() const -> bool {
+    std::lock_guard<std::mutex> lock(indexMutex);
+    for (auto&& text: this->pdfTexts) {
+        if (!text) {
+            return false;
+        }
+    }
+    return true;
+}
+
+auto SearchIndex::countMatches(size_t page, const std::string& text) -> std::optional<size_t> {
+    if (text.empty()) {
+        return 0;
+    }
+
+    doc->lock();
+    PageRef p = doc->getPage(page);
+    doc->unlock();
+    if (!p) {
+        return 0;
+    }
+
+    std::string pattern = StringUtils::toLowerCase(text);
+    setPattern(pattern);
+    return countOnPage(p, pattern);
+}
+
+auto SearchIndex::countInDocument(const std::string& text) -> std::optional<size_t> {
+    if (text.empty()) {
+        return 0;
+    }
+
+    std::vector<PageRef> pages;
+    doc->lock();
+    pages.reserve(doc->getPageCount());
+    for (size_t i = 0; i < doc->getPageCount(); i++) { pages.push_back(doc->getPage(i)); }
+    doc->unlock();
+
+    std::string pattern = StringUtils::toLowerCase(text);
+    setPattern(pattern);
+
+    size_t total = 0;
+    for (const PageRef& p: pages) {
+        auto count = countOnPage(p, pattern);
+        if (!count) {
+            return std::nullopt;
+        }
+        total += *count;
+    }
+    return total;
+}
+
+void SearchIndex::setPattern(const std::string& pattern) {
+    if (pattern == this->countedPattern) {
+        return;
+    }
+
+    // Every match of a longer pattern contains a match of the previous one: the pages without one still have none
+    const bool narrowed = !this->countedPattern.empty() && pattern.find(this->countedPattern) != std::string::npos;
+    for (auto& [page, text]: this->pageTexts) {
+        if (!narrowed || text.count != 0U) {
+            text.count.reset();
+        }
+    }
+    this->countedPattern = pattern;
+}
+
+auto SearchIndex::countOnPage(const PageRef& page, const std::string& pattern) -> std::optional<size_t> {
+    PageText& text = getPageText(page);
+    if (text.count) {
+        return text.count;
+    }
+
+    size_t count = countOccurrences(text.elements, pattern);
+    if (size_t pdfPage = page->getPdfPageNr(); pdfPage != npos) {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        if (pdfPage < this->pdfTexts.size()) {
+            if (!this->pdfTexts[pdfPage]) {
+                return std::nullopt;
+            }
+            count += countOccurrences(*this->pdfTexts[pdfPage], pattern);
+        }
+    }
+
+    text.count = count;
+    return count;
+}
+
+auto SearchIndex::getPageText(const PageRef& page) -> PageText& {
+    auto it = this->pageTexts.find(page);
+    if (it != this->pageTexts.end()) {
+        return it->second;
+    }
+
+    std::string text;
+    for (Layer* l: *page->getLayers()) {
+        for (Element* e: l->getElements()) {
+            // Each text is lowercased on its own: StringUtils::toLowerCase() stops at the first separator
+            if (e->getType() == ELEMENT_TEXT) {
+                text += StringUtils::toLowerCase(static_cast<Text*>(e)->getText());
+            } else if (e->getType() == ELEMENT_TEXIMAGE) {
+                text += StringUtils::toLowerCase(static_cast<TexImage*>(e)->getText());
+            } else {
+                continue;
+            }
+            text += ELEMENT_SEPARATOR;
+        }
+    }
+
+    return this->pageTexts.emplace(page, PageText{std::move(text), std::nullopt}).first->second;
+}
+
+auto SearchIndex::indexPdfPages(uint64_t generation, size_t maxPages) -> bool {
+    for (size_t n = 0; n < maxPages; n++) {
+        size_t pdfPage = 0;
+        {
+            std::lock_guard<std::mutex> lock(indexMutex);
+            if (generation != this->generation || this->nextPdfPage >= this->pdfTexts.size()) {
+                return false;
+            }
+            pdfPage = this->nextPdfPage++;
+        }
+
+        doc->lock();
+        XojPdfPageSPtr pdf = doc->getPdfPage(pdfPage);
+        doc->unlock();
+
+        // The page is kept alive by the shared pointer: the document is not locked during the slow extraction
+        std::string text = pdf ? StringUtils::toLowerCase(pdf->getText()) : std::string();
+
+        std::lock_guard<std::mutex> lock(indexMutex);
+        if (generation != this->generation) {
+            return false;
+        }
+        this->pdfTexts[pdfPage] = std::move(text);
+    }
+
+    std::lock_guard<std::mutex> lock(indexMutex);
+    return generation == this->generation && this->nextPdfPage < this->pdfTexts.size();
+}
+
+void SearchIndex::continueIndexing(uint64_t generation) {
+    if (this->scheduler == nullptr) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(indexMutex);
+        if (generation != this->generation || this->nextPdfPage >= this->pdfTexts.size()) {
+            return;
+        }
+    }
+
+    auto* job = new SearchIndexJob(this, generation);
+    this->scheduler->addJob(job, JOB_PRIORITY_NONE);
+    job->unref();
+}
+
+auto SearchIndex::countOccurrences(const std::string& text, const std::string& pattern) -> size_t {
+    if (pattern.empty()) {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) { count++; }
+    return count;
+}
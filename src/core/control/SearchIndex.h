@@ -0,0 +1,136 @@
+/*
+ * Xournal++
+ *
+ * Text index of a document, for searching all the pages at once
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "model/PageRef.h"
+
+class Document;
+class Scheduler;
+
+/**
+ * @brief Lowercased text of the pages of a document: the text of the PDF background pages, of the Text elements and
+ * the LaTeX sources of the TexImage elements.
+ *
+ * Extracting the text of the PDF pages is slow, and is done in the background by a chain of SearchIndexJob%s, a few
+ * pages per job so that rendering is not delayed. Until the PDF page of a page is indexed, its matches are unknown.
+ *
+ * The texts of the elements are extracted (on the main thread) when a page is first searched, and again after the
+ * page was changed, see invalidatePage(). The elements of all the layers are indexed, including the hidden ones.
+ *
+ * The number of matches of each page is kept for the last text searched, so that counting in the whole document only
+ * searches the pages which changed. While the text is being typed, the pages without a match of the previous text are
+ * not searched again.
+ */
+class SearchIndex {
+public:
+    /**
+     * @param scheduler Runs the background indexing of the PDF text. If nullptr, the PDF pages are only indexed by
+     *                  explicit calls to indexPdfPages().
+     */
+    SearchIndex(Document* doc, Scheduler* scheduler);
+    ~SearchIndex();
+
+    SearchIndex(const SearchIndex&) = delete;
+    SearchIndex& operator=(const SearchIndex&) = delete;
+
+public:
+    /**
+     * @brief Drop the whole index, and start indexing the PDF again. Called after a document was loaded.
+     */
+    void reset();
+
+    /**
+     * @brief The elements of the page changed
+     */
+    void invalidatePage(const PageRef& page);
+
+    /**
+     * @return The number of (case insensitive, possibly overlapping) occurrences of text on the page, std::nullopt if
+     * its PDF background page is not indexed yet
+     */
+    std::optional<size_t> countMatches(size_t page, const std::string& text);
+
+    /**
+     * @return The number of occurrences of text in the whole document, std::nullopt if the PDF is not indexed yet
+     */
+    std::optional<size_t> countInDocument(const std::string& text);
+
+    /**
+     * @return Whether the text of all the PDF pages is indexed
+     */
+    bool isComplete() const;
+
+    /**
+     * @brief Extract the text of the next (at most) maxPages PDF pages. Called by SearchIndexJob, on the scheduler
+     * thread.
+     *
+     * @param generation Nothing is done if the index was reset since the job was created
+     * @return Whether there are pages left to index
+     */
+    bool indexPdfPages(uint64_t generation, size_t maxPages);
+
+    /**
+     * @brief Schedule the indexing of the next PDF pages, if the index was not reset meanwhile
+     */
+    void continueIndexing(uint64_t generation);
+
+    /**
+     * @return The number of occurrences of pattern in text, overlapping occurrences included
+     */
+    static size_t countOccurrences(const std::string& text, const std::string& pattern);
+
+private:
+    struct PageText {
+        std::string elements;         ///< Lowercased texts of the elements, separated by ELEMENT_SEPARATOR
+        std::optional<size_t> count;  ///< Number of matches of countedPattern on the page, if known
+    };
+
+    PageText& getPageText(const PageRef& page);
+
+    /**
+     * @brief Forget the counts of the matches of the previous pattern, except those which remain valid
+     */
+    void setPattern(const std::string& pattern);
+
+    /**
+     * @return The number of matches of the pattern (lowercased, set with setPattern()) on the page, std::nullopt if
+     * its PDF background page is not indexed yet
+     */
+    std::optional<size_t> countOnPage(const PageRef& page, const std::string& pattern);
+
+private:
+    Document* doc;
+    Scheduler* scheduler;
+
+    /**
+     * Protects the PDF part of the index, which is filled by the scheduler thread
+     */
+    mutable std::mutex indexMutex;
+    uint64_t generation = 0;
+    std::vector<std::optional<std::string>> pdfTexts;
+    size_t nextPdfPage = 0;
+
+    /**
+     * Only used on the main thread. The weak pointers keep the keys of removed pages unique.
+     */
+    std::map<std::weak_ptr<XojPage>, PageText, std::owner_less<std::weak_ptr<XojPage>>> pageTexts;
+    std::string countedPattern;  ///< Lowercased
+};
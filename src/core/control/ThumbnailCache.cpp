@@ -0,0 +1,290 @@
+#include "ThumbnailCache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <glib.h>
+
+#include "model/Element.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+#include "util/PathUtil.h"
+#include "util/serializing/ObjectEncoding.h"
+#include "util/serializing/ObjectOutputStream.h"
+
+namespace {
+
+/**
+ * Feeds the serialized values into a checksum instead of a buffer. Only the type tags are kept in the buffer.
+ */
+class ChecksumEncoding: public ObjectEncoding {
+public:
+    explicit ChecksumEncoding(GChecksum* checksum): checksum(checksum) {}
+
+    void addData(const void* data, int len) override {
+        g_checksum_update(checksum, static_cast<const guchar*>(data), static_cast<gssize>(len));
+    }
+
+private:
+    GChecksum* checksum;
+};
+
+/**
+ * Points hashed at once by addStroke()
+ */
+constexpr size_t POINT_CHUNK_SIZE = 256;
+
+/**
+ * Strokes are not serialized: that would decode the points of compact strokes
+ */
+void addStroke(ObjectOutputStream& out, GChecksum* checksum, const Stroke* s) {
+    out.writeInt(static_cast<int>(uint32_t(s->getColor())));
+    out.writeDouble(s->getWidth());
+    out.writeInt(s->getToolType());
+    out.writeInt(s->getFill());
+    out.writeInt(s->getStrokeCapStyle());
+    s->getLineStyle().serialize(out);
+
+    double chunk[3 * POINT_CHUNK_SIZE];
+    size_t n = 0;
+    auto addPoint = [&](const Point& p) {
+        chunk[n++] = p.x;
+        chunk[n++] = p.y;
+        chunk[n++] = p.z;
+        if (n == 3 * POINT_CHUNK_SIZE) {
+            g_checksum_update(checksum, reinterpret_cast<const guchar*>(chunk), static_cast<gssize>(sizeof(chunk)));
+            n = 0;
+        }
+    };
+    if (const StrokeGeometry* geometry = s->getCompactGeometry()) {
+        geometry->forEachPoint(addPoint);
+    } else {
+        for (const Point& p: s->getPointVector()) { addPoint(p); }
+    }
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(chunk), static_cast<gssize>(n * sizeof(double)));
+}
+
+/**
+ * Extension of the files of the cache
+ */
+constexpr auto EXTENSION = ".thumb";
+
+}  // namespace
+
+ThumbnailCache::ThumbnailCache(fs::path dir, uintmax_t maxSize): dir(std::move(dir)), maxSize(maxSize) {
+    Util::ensureFolderExists(this->dir);
+}
+
+auto ThumbnailCache::computeDocumentId(const fs::path& file, const fs::path& pdf) -> std::string {
+    std::string id = file.u8string();
+    if (!pdf.empty()) {
+        // Replacing the PDF changes the backgrounds, but not the pages
+        std::error_code ec;
+        auto size = fs::file_size(pdf, ec);
+        auto time = fs::last_write_time(pdf, ec).time_since_epoch();
+        id += '\0';
+        id += pdf.u8string();
+        id += '\0';
+        id += std::to_string(size) + ":" + std::to_string(time.count());
+    }
+    return id;
+}
+
+auto ThumbnailCache::computeKey(const std::string& documentId, size_t pageNr, const PageRef& page, int width,
+                                int height, double zoom) -> std::optional<Key> {
+    PageType type = page->getBackgroundType();
+    if (type.isImagePage()) {
+        return std::nullopt;
+    }
+
+    std::string slot = documentId;
+    slot += '\0';
+    slot += std::to_string(pageNr) + ":" + std::to_string(width) + "x" + std::to_string(height);
+    gchar* file = g_compute_checksum_for_string(G_CHECKSUM_SHA256, slot.c_str(), static_cast<gssize>(slot.size()));
+    Key key{file, {}};
+    g_free(file);
+
+    // The values are streamed into the checksum: the appearance of the page is never copied
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    ObjectOutputStream out(new ChecksumEncoding(checksum));
+    out.writeString(documentId);
+    out.writeInt(width);
+    out.writeInt(height);
+    out.writeDouble(zoom);
+    out.writeDouble(page->getWidth());
+    out.writeDouble(page->getHeight());
+    out.writeInt(static_cast<int>(type.format));
+    out.writeString(type.config);
+    out.writeInt(static_cast<int>(uint32_t(page->getBackgroundColor())));
+    out.writeSizeT(page->getPdfPageNr());
+    for (Layer* layer: *page->getLayers()) {
+        out.writeInt(layer->isVisible());
+        for (Element* e: layer->getElements()) {
+            out.writeInt(e->getType());
+            if (e->getType() == ELEMENT_STROKE) {
+                addStroke(out, checksum, static_cast<Stroke*>(e));
+            } else {
+                e->serialize(out);
+            }
+        }
+    }
+
+    key.contents = g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+    // Only the type tags
+    g_string_free(out.getStr(), true);
+    return key;
+}
+
+auto ThumbnailCache::getPath(const std::string& file) const -> fs::path { return dir / (file + EXTENSION); }
+
+auto ThumbnailCache::lookup(const Key& key, int width, int height) -> cairo_surface_t* {
+    fs::path path = getPath(key.file);
+    std::error_code ec;
+    if (!fs::is_regular_file(path, ec)) {
+        return nullptr;
+    }
+
+    // The file starts with the hash of the contents of the page, then the PNG image
+    std::ifstream in(path, std::ios::binary);
+    std::string data((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (data.size() < key.contents.size() || data.compare(0, key.contents.size(), key.contents) != 0) {
+        // Another version of the page
+        return nullptr;
+    }
+
+    struct Reader {
+        const std::string& data;
+        size_t pos;
+    } reader{data, key.contents.size()};
+    cairo_surface_t* thumbnail = cairo_image_surface_create_from_png_stream(
+            [](void* closure, unsigned char* buffer, unsigned int length) {
+                auto* r = static_cast<Reader*>(closure);
+                if (r->data.size() - r->pos < length) {
+                    return CAIRO_STATUS_READ_ERROR;
+                }
+                std::memcpy(buffer, r->data.data() + r->pos, length);
+                r->pos += length;
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &reader);
+    if (cairo_surface_status(thumbnail) != CAIRO_STATUS_SUCCESS ||
+        cairo_image_surface_get_width(thumbnail) != width || cairo_image_surface_get_height(thumbnail) != height) {
+        cairo_surface_destroy(thumbnail);
+        return nullptr;
+    }
+
+    // The modification time orders the entries for eviction
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return thumbnail;
+}
+
+void ThumbnailCache::store(const Key& key, cairo_surface_t* thumbnail) {
+    std::string data = key.contents;
+    auto status = cairo_surface_write_to_png_stream(
+            thumbnail,
+            [](void* closure, const unsigned char* buffer, unsigned int length) {
+                static_cast<std::string*>(closure)->append(reinterpret_cast<const char*>(buffer), length);
+                return CAIRO_STATUS_SUCCESS;
+            },
+            &data);
+    if (status != CAIRO_STATUS_SUCCESS) {
+        g_warning("Could not store the page preview in the cache");
+        return;
+    }
+
+    // Write, then rename, so that other instances never see a partial file
+    fs::path path = getPath(key.file);
+    fs::path tmpPath = path;
+    tmpPath += ".tmp";
+    std::error_code ec;
+    auto previousSize = fs::file_size(path, ec);
+    if (ec) {
+        previousSize = 0;
+    }
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        out.write(data.data(), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            g_warning("Could not store the page preview in the cache");
+            out.close();
+            fs::remove(tmpPath, ec);
+            return;
+        }
+    }
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        g_warning("Could not store the page preview in the cache: %s", ec.message().c_str());
+        fs::remove(tmpPath, ec);
+        return;
+    }
+
+    std::lock_guard lock(this->mutex);
+    if (!this->size) {
+        this->size = scanSize();
+    } else {
+        // The previous preview of the page was replaced
+        *this->size -= std::min<uintmax_t>(previousSize, *this->size);
+        *this->size += data.size();
+    }
+    if (*this->size > this->maxSize) {
+        evict();
+    }
+}
+
+auto ThumbnailCache::scanSize() const -> uintmax_t {
+    uintmax_t total = 0;
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        if (it->path().extension() == EXTENSION) {
+            std::error_code entryEc;
+            auto fileSize = fs::file_size(it->path(), entryEc);
+            if (!entryEc) {
+                total += fileSize;
+            }
+        }
+    }
+    return total;
+}
+
+void ThumbnailCache::evict() {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type time;
+        uintmax_t size;
+    };
+
+    std::vector<Entry> entries;
+    uintmax_t totalSize = 0;
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        const fs::path& path = it->path();
+        if (path.extension() != EXTENSION) {
+            continue;
+        }
+        std::error_code entryEc;
+        Entry e{path, fs::last_write_time(path, entryEc), fs::file_size(path, entryEc)};
+        if (!entryEc) {
+            totalSize += e.size;
+            entries.push_back(std::move(e));
+        }
+    }
+
+    const uintmax_t targetSize = this->maxSize / 4 * 3;
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    for (auto&& e: entries) {
+        if (totalSize <= targetSize) {
+            break;
+        }
+        if (fs::remove(e.path, ec)) {
+            totalSize -= e.size;
+        }
+    }
+    this->size = totalSize;
+}
@@ -0,0 +1,99 @@
+/*
+ * Xournal++
+ *
+ * On-disk cache of the page previews of the sidebar
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+
+#include <cairo.h>
+
+#include "model/PageRef.h"
+
+#include "filesystem.h"
+
+/**
+ * The previews are stored in a directory shared by all documents (and all instances of the application). Each page of
+ * a saved document has one file per preview size, overwritten whenever a new preview of the page is stored. The file
+ * holds the PNG image after a hash of everything that determines the preview: the document, the contents of the page
+ * and the size of the preview. Opening a document again therefore shows the previews of the unchanged pages without
+ * rendering them. The least recently used previews are removed once the directory grows larger than its maximal size.
+ */
+class ThumbnailCache {
+public:
+    static constexpr uintmax_t DEFAULT_MAX_SIZE = 128 * 1024 * 1024;
+
+    struct Key {
+        std::string file;      ///< Hash of the document, page number and preview size: names the file of the preview
+        std::string contents;  ///< Hash of everything that determines the preview
+    };
+
+    explicit ThumbnailCache(fs::path dir, uintmax_t maxSize = DEFAULT_MAX_SIZE);
+
+    /**
+     * @param file The file of the document, may be empty
+     * @param pdf The PDF background of the document, may be empty
+     * @return An identifier of the document, which changes with the PDF file
+     */
+    static std::string computeDocumentId(const fs::path& file, const fs::path& pdf);
+
+    /**
+     * The document must be locked, a shared lock is enough.
+     *
+     * @param documentId See computeDocumentId()
+     * @param pageNr The number of the page in the document
+     * @param width The width of the preview in pixels
+     * @param height The height of the preview in pixels
+     * @param zoom The zoom of the page in the preview
+     * @return The key under which the preview of the page is cached, nothing if the preview cannot be cached (the
+     * contents of background images are not part of the page)
+     */
+    static std::optional<Key> computeKey(const std::string& documentId, size_t pageNr, const PageRef& page, int width,
+                                         int height, double zoom);
+
+    /**
+     * @return A new surface with the cached preview, nullptr if there is no preview of this size for this key
+     */
+    cairo_surface_t* lookup(const Key& key, int width, int height);
+
+    /**
+     * @brief Write the preview into the cache under this key, replacing the previous preview of the page, then remove
+     * the least recently used previews if the cache is too large
+     */
+    void store(const Key& key, cairo_surface_t* thumbnail);
+
+private:
+    fs::path getPath(const std::string& file) const;
+
+    /**
+     * Removes the least recently used previews until the cache takes at most 3/4 of its maximal size, so that the
+     * directory is not scanned for every new preview. Requires the mutex.
+     */
+    void evict();
+
+    /**
+     * @return The size of all the previews. Requires the mutex.
+     */
+    uintmax_t scanSize() const;
+
+private:
+    fs::path dir;
+    uintmax_t maxSize;
+
+    /**
+     * Size of the directory, known after the first preview was stored
+     */
+    std::optional<uintmax_t> size;
+
+    std::mutex mutex;
+};
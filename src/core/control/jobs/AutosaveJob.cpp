@@ -19,6 +19,7 @@ void AutosaveJob::afterRun() {
 
 void AutosaveJob::run() {
     SaveHandler handler;
+    handler.setWriteStrokeGeometry(control->getSettings()->getSaveStrokeGeometry());
 
     control->getUndoRedoHandler()->documentAutosaved();
 
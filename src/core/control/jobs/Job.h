@@ -13,7 +13,14 @@
 
 #include <atomic>
 
-enum JobType { JOB_TYPE_BLOCKING, JOB_TYPE_PREVIEW, JOB_TYPE_RENDER, JOB_TYPE_AUTOSAVE };
+enum JobType {
+    JOB_TYPE_BLOCKING,
+    JOB_TYPE_PREVIEW,
+    JOB_TYPE_RENDER,
+    JOB_TYPE_AUTOSAVE,
+    JOB_TYPE_SEARCH_INDEX,
+    JOB_TYPE_PDF_TEXT_LAYOUT
+};
 
 /**
  * A manually ref-counted class representing an asynchronous job to be used with
@@ -0,0 +1,12 @@
+#include "PdfTextLayoutJob.h"
+
+#include "control/PdfTextLayoutCache.h"
+
+PdfTextLayoutJob::PdfTextLayoutJob(PdfTextLayoutCache* cache, uint64_t generation, size_t pdfPage):
+        cache(cache), generation(generation), pdfPage(pdfPage) {}
+
+PdfTextLayoutJob::~PdfTextLayoutJob() = default;
+
+void PdfTextLayoutJob::run() { this->cache->extract(this->generation, this->pdfPage); }
+
+auto PdfTextLayoutJob::getType() -> JobType { return JOB_TYPE_PDF_TEXT_LAYOUT; }
@@ -0,0 +1,40 @@
+/*
+ * Xournal++
+ *
+ * Extracts the text layout of a PDF page
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Job.h"
+
+class PdfTextLayoutCache;
+
+/**
+ * @brief Fills the PdfTextLayoutCache with the layout of a PDF page
+ */
+class PdfTextLayoutJob: public Job {
+public:
+    PdfTextLayoutJob(PdfTextLayoutCache* cache, uint64_t generation, size_t pdfPage);
+
+protected:
+    ~PdfTextLayoutJob() override;
+
+public:
+    void run() override;
+
+    JobType getType() override;
+
+private:
+    PdfTextLayoutCache* cache;
+    uint64_t generation;
+    size_t pdfPage;
+};
@@ -61,7 +61,7 @@ void PreviewJob::drawPage() {
     PreviewRenderType type = this->sidebarPreview->getRenderType();
     Layer::Index layer = 0;
 
-    doc->lock();
+    doc->lockShared();
 
     // getLayer is not defined for page preview
     if (type != RENDER_TYPE_PAGE_PREVIEW) {
@@ -107,7 +107,7 @@ void PreviewJob::drawPage() {
     }
 
     cairo_destroy(cr2);
-    doc->unlock();
+    doc->unlockShared();
 }
 
 void PreviewJob::clipToPage() {
@@ -117,14 +117,59 @@ void PreviewJob::clipToPage() {
     cairo_clip(cr2);
 }
 
+auto PreviewJob::loadThumbnail() -> bool {
+    ThumbnailCache* cache = this->sidebarPreview->sidebar->getThumbnailCache();
+    if (cache == nullptr || this->sidebarPreview->getRenderType() != RENDER_TYPE_PAGE_PREVIEW) {
+        return false;
+    }
+
+    int width = cairo_image_surface_get_width(crBuffer);
+    int height = cairo_image_surface_get_height(crBuffer);
+
+    Document* doc = this->sidebarPreview->sidebar->getControl()->getDocument();
+    doc->lockShared();
+    // The previews of documents never saved would pile up in the cache, to be never found again
+    if (fs::path file = doc->getFilepath(); !file.empty()) {
+        if (size_t pageNr = doc->indexOf(this->sidebarPreview->page); pageNr != npos) {
+            std::string documentId = ThumbnailCache::computeDocumentId(file, doc->getPdfFilepath());
+            this->thumbnailKey = ThumbnailCache::computeKey(documentId, pageNr, this->sidebarPreview->page, width,
+                                                            height, zoom);
+        }
+    }
+    doc->unlockShared();
+
+    if (!this->thumbnailKey) {
+        return false;
+    }
+
+    cairo_surface_t* thumbnail = cache->lookup(*this->thumbnailKey, width, height);
+    if (thumbnail == nullptr) {
+        return false;
+    }
+
+    cairo_destroy(cr2);
+    cairo_surface_destroy(crBuffer);
+    crBuffer = thumbnail;
+    return true;
+}
+
+void PreviewJob::storeThumbnail() {
+    if (this->thumbnailKey) {
+        this->sidebarPreview->sidebar->getThumbnailCache()->store(*this->thumbnailKey, crBuffer);
+    }
+}
+
 void PreviewJob::run() {
     if (this->sidebarPreview == nullptr) {
         return;
     }
 
     initGraphics();
-    drawBorder();
-    clipToPage();
-    drawPage();
+    if (!loadThumbnail()) {
+        drawBorder();
+        clipToPage();
+        drawPage();
+        storeThumbnail();
+    }
     finishPaint();
 }
@@ -11,11 +11,14 @@
 
 #pragma once
 
+#include <optional>
 #include <string>
 #include <vector>
 
 #include <gtk/gtk.h>
 
+#include "control/ThumbnailCache.h"
+
 #include "Job.h"
 
 
@@ -47,6 +50,14 @@ private:
     void finishPaint();
     void drawPage();
 
+    /**
+     * Replaces the buffer by the cached preview of the page, if there is one
+     *
+     * @return true if the cached preview was loaded
+     */
+    bool loadThumbnail();
+    void storeThumbnail();
+
 private:
     /**
      * Graphics buffer
@@ -63,6 +74,11 @@ private:
      */
     double zoom = 0;
 
+    /**
+     * Key of the preview in the ThumbnailCache, if it is cached
+     */
+    std::optional<ThumbnailCache::Key> thumbnailKey;
+
     /**
      * Sidebar preview
      */
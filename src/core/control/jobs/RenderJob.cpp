@@ -40,10 +40,11 @@ void RenderJob::rerenderRectangle(Rectangle<double> const& rect) {
     Control* control = view->getXournal()->getControl();
     v.setMarkAudioStroke(control->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT);
     v.setPdfCache(view->xournal->getCache());
+    v.setTexImageCache(view->xournal->getTexImageCache());
 
-    doc->lock();
+    doc->lockShared();
     v.drawPage(view->page, crRect, false);
-    doc->unlock();
+    doc->unlockShared();
 
     cairo_destroy(crRect);
 
@@ -91,12 +92,13 @@ void RenderJob::run() {
         cairo_t* cr2 = cairo_create(crBuffer);
         cairo_scale(cr2, zoom, zoom);
 
-        doc->lock();
+        doc->lockShared();
 
         Control* control = view->getXournal()->getControl();
         DocumentView localView;
         localView.setMarkAudioStroke(control->getToolHandler()->getToolType() == TOOL_PLAY_OBJECT);
         localView.setPdfCache(this->view->xournal->getCache());
+        localView.setTexImageCache(this->view->xournal->getTexImageCache());
         localView.drawPage(this->view->page, cr2, false);
 
         cairo_destroy(cr2);
@@ -109,7 +111,7 @@ void RenderJob::run() {
         this->view->crBuffer = crBuffer;
 
         this->view->drawingMutex.unlock();
-        doc->unlock();
+        doc->unlockShared();
     } else {
         for (Rectangle<double> const& rect: rerenderRects) { rerenderRectangle(rect); }
     }
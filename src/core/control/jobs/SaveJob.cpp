@@ -87,6 +87,7 @@ auto SaveJob::save() -> bool {
     updatePreview(control);
     Document* doc = this->control->getDocument();
     SaveHandler h;
+    h.setWriteStrokeGeometry(control->getSettings()->getSaveStrokeGeometry());
 
     doc->lock();
     h.prepareSave(doc);
@@ -0,0 +1,17 @@
+#include "SearchIndexJob.h"
+
+#include "control/SearchIndex.h"
+
+SearchIndexJob::SearchIndexJob(SearchIndex* index, uint64_t generation): index(index), generation(generation) {}
+
+SearchIndexJob::~SearchIndexJob() = default;
+
+void SearchIndexJob::run() {
+    if (this->index->indexPdfPages(this->generation, PAGES_PER_JOB)) {
+        callAfterRun();
+    }
+}
+
+void SearchIndexJob::afterRun() { this->index->continueIndexing(this->generation); }
+
+auto SearchIndexJob::getType() -> JobType { return JOB_TYPE_SEARCH_INDEX; }
@@ -0,0 +1,42 @@
+/*
+ * Xournal++
+ *
+ * Extracts the text of some PDF pages for the search index
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "Job.h"
+
+class SearchIndex;
+
+/**
+ * @brief Indexes the text of the next PAGES_PER_JOB PDF pages, then schedules the next job
+ */
+class SearchIndexJob: public Job {
+public:
+    SearchIndexJob(SearchIndex* index, uint64_t generation);
+
+    static constexpr size_t PAGES_PER_JOB = 8;
+
+protected:
+    ~SearchIndexJob() override;
+
+public:
+    void run() override;
+    void afterRun() override;
+
+    JobType getType() override;
+
+private:
+    SearchIndex* index;
+    uint64_t generation;
+};
@@ -14,7 +14,29 @@ void XournalScheduler::removeSidebar(SidebarPreviewBaseEntry* preview) {
     removeSource(preview, JOB_TYPE_PREVIEW, JOB_PRIORITY_HIGH, waitForTaskCompletion);
 }
 
-void XournalScheduler::removePage(XojPageView* view) { removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT); }
+void XournalScheduler::removePage(XojPageView* view) {
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW, false);
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT);
+}
+
+void XournalScheduler::removePrefetchJobs() {
+    std::lock_guard lock{this->jobQueueMutex};
+    std::deque<Job*>& queue = *this->jobQueue[JOB_PRIORITY_LOW];
+
+    auto it = queue.begin();
+    while (it != queue.end()) {
+        Job* job = *it;
+
+        if (job->getType() == JOB_TYPE_RENDER) {
+            it = queue.erase(it);
+
+            job->deleteJob();
+            job->unref();
+        } else {
+            ++it;
+        }
+    }
+}
 
 void XournalScheduler::removeAllJobs() {
     std::lock_guard lock{this->jobQueueMutex};
@@ -99,6 +121,9 @@ void XournalScheduler::addRepaintSidebar(SidebarPreviewBaseEntry* preview) {
 }
 
 void XournalScheduler::addRerenderPage(XojPageView* view) {
+    // The page is needed now: a pending prefetch would only render it a second time
+    removeSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW, false);
+
     if (existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT)) {
         return;
     }
@@ -107,3 +132,14 @@ void XournalScheduler::addRerenderPage(XojPageView* view) {
     addJob(job, JOB_PRIORITY_URGENT);
     job->unref();
 }
+
+void XournalScheduler::addPrefetchPage(XojPageView* view) {
+    if (existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_URGENT) ||
+        existsSource(view, JOB_TYPE_RENDER, JOB_PRIORITY_LOW)) {
+        return;
+    }
+
+    auto* job = new RenderJob(view);
+    addJob(job, JOB_PRIORITY_LOW);
+    job->unref();
+}
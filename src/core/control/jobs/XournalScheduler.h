@@ -39,9 +39,19 @@ public:
      */
     void removeAllJobs();
 
+    /**
+     * Removes the RenderJob%s of prefetched pages which have not been started yet
+     */
+    void removePrefetchJobs();
+
     void addRepaintSidebar(SidebarPreviewBaseEntry* preview);
     void addRerenderPage(XojPageView* view);
 
+    /**
+     * Renders a page which is not visible yet, after all the more urgent jobs
+     */
+    void addPrefetchPage(XojPageView* view);
+
     /**
      * Blocks until all currently running Job%s have been executed
      */
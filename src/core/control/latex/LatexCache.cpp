@@ -0,0 +1,108 @@
+#include "LatexCache.h"
+
+#include <algorithm>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <glib.h>
+
+#include "util/PathUtil.h"
+
+static LatexCache::Statistics statistics;
+
+auto LatexCache::Statistics::hitRate() const -> double {
+    size_t lookups = hits + misses;
+    return lookups == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(lookups);
+}
+
+LatexCache::LatexCache(fs::path dir, uintmax_t maxSize): dir(std::move(dir)), maxSize(maxSize) {
+    Util::ensureFolderExists(this->dir);
+}
+
+auto LatexCache::computeKey(const std::string& texFileContents, const std::string& genCmd) -> std::string {
+    GChecksum* checksum = g_checksum_new(G_CHECKSUM_SHA256);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(texFileContents.data()),
+                      static_cast<gssize>(texFileContents.size()));
+    // Separate the fields, so that moving characters from one to the other changes the key
+    const guchar separator = 0;
+    g_checksum_update(checksum, &separator, 1);
+    g_checksum_update(checksum, reinterpret_cast<const guchar*>(genCmd.data()), static_cast<gssize>(genCmd.size()));
+    std::string key = g_checksum_get_string(checksum);
+    g_checksum_free(checksum);
+    return key;
+}
+
+auto LatexCache::getPath(const std::string& key) const -> fs::path { return dir / (key + ".pdf"); }
+
+auto LatexCache::lookup(const std::string& key) -> std::optional<fs::path> {
+    fs::path path = getPath(key);
+    std::error_code ec;
+    if (!fs::is_regular_file(path, ec)) {
+        statistics.misses++;
+        return std::nullopt;
+    }
+
+    statistics.hits++;
+    // The modification time orders the entries for eviction
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return path;
+}
+
+void LatexCache::store(const std::string& key, const fs::path& pdf) {
+    // Copy, then rename, so that other instances never see a partial file
+    fs::path path = getPath(key);
+    fs::path tmpPath = path;
+    tmpPath += ".tmp";
+    std::error_code ec;
+    fs::copy_file(pdf, tmpPath, fs::copy_options::overwrite_existing, ec);
+    if (!ec) {
+        fs::rename(tmpPath, path, ec);
+    }
+    if (ec) {
+        g_warning("Could not store the LaTeX PDF in the cache: %s", ec.message().c_str());
+        fs::remove(tmpPath, ec);
+        return;
+    }
+
+    evict();
+}
+
+void LatexCache::evict() {
+    struct Entry {
+        fs::path path;
+        fs::file_time_type time;
+        uintmax_t size;
+    };
+
+    std::vector<Entry> entries;
+    uintmax_t totalSize = 0;
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        const fs::path& path = it->path();
+        if (path.extension() != ".pdf") {
+            continue;
+        }
+        std::error_code entryEc;
+        Entry e{path, fs::last_write_time(path, entryEc), fs::file_size(path, entryEc)};
+        if (!entryEc) {
+            totalSize += e.size;
+            entries.push_back(std::move(e));
+        }
+    }
+    if (totalSize <= maxSize) {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.time < b.time; });
+    for (auto&& e: entries) {
+        if (totalSize <= maxSize) {
+            break;
+        }
+        if (fs::remove(e.path, ec)) {
+            totalSize -= e.size;
+        }
+    }
+}
+
+auto LatexCache::getStatistics() -> Statistics { return statistics; }
@@ -0,0 +1,74 @@
+/*
+ * Xournal++
+ *
+ * On-disk cache of the PDFs generated from LaTeX formulas
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "filesystem.h"
+
+/**
+ * The PDFs are stored in a directory shared by all documents (and all instances of the application), named after a
+ * hash of everything that determines the output of the LaTeX command: the instantiated template (so the formula, the
+ * template and the text color) and the command itself. The least recently used PDFs are removed once the directory
+ * grows larger than its maximal size.
+ */
+class LatexCache {
+public:
+    static constexpr uintmax_t DEFAULT_MAX_SIZE = 32 * 1024 * 1024;
+
+    struct Statistics {
+        size_t hits = 0;
+        size_t misses = 0;
+
+        /**
+         * @return The fraction of the lookups which were hits, 0 if there was no lookup
+         */
+        double hitRate() const;
+    };
+
+    explicit LatexCache(fs::path dir, uintmax_t maxSize = DEFAULT_MAX_SIZE);
+
+    /**
+     * @param texFileContents The instantiated LaTeX template, see LatexGenerator::templateSub
+     * @param genCmd The LaTeX generator command
+     * @return The key under which the resulting PDF is cached
+     */
+    static std::string computeKey(const std::string& texFileContents, const std::string& genCmd);
+
+    /**
+     * @return The path of the cached PDF for this key, if there is one. The lookup is counted in the statistics.
+     */
+    std::optional<fs::path> lookup(const std::string& key);
+
+    /**
+     * @brief Copy the PDF into the cache under this key, then remove the least recently used PDFs if the cache is too
+     * large
+     */
+    void store(const std::string& key, const fs::path& pdf);
+
+    /**
+     * @return The hit and miss counts of all the caches of this process
+     */
+    static Statistics getStatistics();
+
+private:
+    fs::path getPath(const std::string& key) const;
+
+    void evict();
+
+private:
+    fs::path dir;
+    uintmax_t maxSize;
+};
@@ -189,6 +189,8 @@ void Settings::loadDefault() {
 
     this->snapRecognizedShapesEnabled = false;
     this->restoreLineWidthEnabled = false;
+    this->strokeStorage = StrokeStorage::POINTS;
+    this->saveStrokeGeometry = false;
 
     this->inTransaction = false;
 
@@ -546,6 +548,10 @@ void Settings::parseItem(xmlDocPtr doc, xmlNodePtr cur) {
         this->snapRecognizedShapesEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("restoreLineWidthEnabled")) == 0) {
         this->restoreLineWidthEnabled = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("strokeStorage")) == 0) {
+        setStrokeStorage(static_cast<StrokeStorage>(g_ascii_strtoll(reinterpret_cast<const char*>(value), nullptr, 10)));
+    } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("saveStrokeGeometry")) == 0) {
+        this->saveStrokeGeometry = xmlStrcmp(value, reinterpret_cast<const xmlChar*>("true")) == 0;
     } else if (xmlStrcmp(name, reinterpret_cast<const xmlChar*>("preferredLocale")) == 0) {
         this->preferredLocale = reinterpret_cast<char*>(value);
         /**
@@ -982,6 +988,8 @@ void Settings::save() {
 
     SAVE_BOOL_PROP(snapRecognizedShapesEnabled);
     SAVE_BOOL_PROP(restoreLineWidthEnabled);
+    saveProperty("strokeStorage", static_cast<int>(strokeStorage), root);
+    SAVE_BOOL_PROP(saveStrokeGeometry);
 
     SAVE_INT_PROP(numIgnoredStylusEvents);
 
@@ -1991,6 +1999,27 @@ void Settings::setRestoreLineWidthEnabled(bool enabled) { this->restoreLineWidth
 
 auto Settings::getRestoreLineWidthEnabled() const -> bool { return this->restoreLineWidthEnabled; }
 
+void Settings::setStrokeStorage(StrokeStorage storage) {
+    switch (storage) {
+        case StrokeStorage::POINTS:
+        case StrokeStorage::COMPACT:
+        case StrokeStorage::COMPACT_FLOAT:
+        case StrokeStorage::QUANTIZED:
+            this->strokeStorage = storage;
+            break;
+        default:
+            g_warning("Settings::Unknown stroke storage: %d", static_cast<int>(storage));
+            this->strokeStorage = StrokeStorage::POINTS;
+            break;
+    }
+}
+
+auto Settings::getStrokeStorage() const -> StrokeStorage { return this->strokeStorage; }
+
+void Settings::setSaveStrokeGeometry(bool save) { this->saveStrokeGeometry = save; }
+
+auto Settings::getSaveStrokeGeometry() const -> bool { return this->saveStrokeGeometry; }
+
 auto Settings::setPreferredLocale(std::string const& locale) -> void { this->preferredLocale = locale; }
 
 auto Settings::getPreferredLocale() const -> std::string { return this->preferredLocale; }
@@ -22,6 +22,7 @@
 #include "control/tools/StrokeStabilizerEnum.h"
 #include "gui/toolbarMenubar/model/ColorPalette.h"
 #include "model/Font.h"
+#include "model/StrokeGeometry.h"
 
 #include "LatexSettings.h"
 #include "SettingsEnums.h"
@@ -490,6 +491,22 @@ public:
      */
     bool getRestoreLineWidthEnabled() const;
 
+    /**
+     * Set how the points of finished strokes are stored in memory
+     */
+    void setStrokeStorage(StrokeStorage storage);
+
+    /**
+     * Get how the points of finished strokes are stored in memory
+     */
+    StrokeStorage getStrokeStorage() const;
+
+    /**
+     * Set whether a binary copy of the stroke points is saved along with the document, for faster loading
+     */
+    void setSaveStrokeGeometry(bool save);
+    bool getSaveStrokeGeometry() const;
+
     /**
      * Set the preferred locale
      */
@@ -988,6 +1005,16 @@ private:
      */
     bool restoreLineWidthEnabled{};
 
+    /**
+     * How the points of finished strokes are stored in memory
+     */
+    StrokeStorage strokeStorage{};
+
+    /**
+     * Whether a binary copy of the stroke points is cached when the document is saved (see StrokeGeometryChunk)
+     */
+    bool saveStrokeGeometry{};
+
     /**
      * How many stylus events since hitting the screen should be ignored before actually starting the action. If set to
      * 0, no event will be ignored. Should not be negative.
@@ -22,6 +22,11 @@ private:
 public:
     static Stroke* recognize(Stroke* s);
 
+    /**
+     * @param inertia The moments of the whole stroke
+     */
+    static Stroke* recognize(Stroke* s, Inertia inertia);
+
 private:
     static Stroke* makeCircleShape(Stroke* originalStroke, Inertia& inertia);
     static double scoreCircle(Stroke* s, Inertia& inertia);
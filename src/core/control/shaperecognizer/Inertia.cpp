@@ -82,3 +82,23 @@ void Inertia::calc(const Point* pt, int start, int end) {
     this->mass = this->sx = this->sy = this->sxx = this->sxy = this->syy = 0.;
     for (int i = start; i < end - 1; i++) { this->increase(pt[i], pt[i + 1], 1); }
 }
+
+auto Inertia::operator-(const Inertia& other) const -> Inertia {
+    Inertia result;
+    result.mass = this->mass - other.mass;
+    result.sx = this->sx - other.sx;
+    result.sy = this->sy - other.sy;
+    result.sxx = this->sxx - other.sxx;
+    result.sxy = this->sxy - other.sxy;
+    result.syy = this->syy - other.syy;
+    return result;
+}
+
+void Inertia::translate(double dx, double dy) {
+    // The second order moments depend on the first order ones before the move
+    this->sxx += 2 * dx * this->sx + this->mass * dx * dx;
+    this->syy += 2 * dy * this->sy + this->mass * dy * dy;
+    this->sxy += dx * this->sy + dy * this->sx + this->mass * dx * dy;
+    this->sx += this->mass * dx;
+    this->sy += this->mass * dy;
+}
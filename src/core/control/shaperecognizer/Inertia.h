@@ -40,6 +40,16 @@ public:
     void increase(Point p1, Point p2, int coef);
     void calc(const Point* pt, int start, int end);
 
+    /**
+     * @return The moments of the segments of this Inertia that are not in other, which must be a part of them
+     */
+    Inertia operator-(const Inertia& other) const;
+
+    /**
+     * Move the segments by (dx, dy)
+     */
+    void translate(double dx, double dy);
+
 private:
     double mass{};
     double sx{};
@@ -0,0 +1,38 @@
+#include "InertiaPrefixSums.h"
+
+InertiaPrefixSums::InertiaPrefixSums(const std::vector<Point>& points) { update(points); }
+
+void InertiaPrefixSums::addPoint(const Point& p) {
+    if (this->sums.empty()) {
+        this->origin = p;
+        this->sums.emplace_back();
+    } else {
+        Inertia s = this->sums.back();
+        s.increase(Point(this->last.x - this->origin.x, this->last.y - this->origin.y),
+                   Point(p.x - this->origin.x, p.y - this->origin.y), 1);
+        this->sums.push_back(s);
+    }
+    this->last = p;
+}
+
+void InertiaPrefixSums::update(const std::vector<Point>& points) {
+    if (points.size() < this->sums.size()) {
+        clear();
+    }
+    this->sums.reserve(points.size());
+    for (size_t i = this->sums.size(); i < points.size(); i++) { addPoint(points[i]); }
+}
+
+void InertiaPrefixSums::clear() { this->sums.clear(); }
+
+auto InertiaPrefixSums::size() const -> size_t { return this->sums.size(); }
+
+auto InertiaPrefixSums::calc(int start, int end) const -> Inertia {
+    // Inertia::calc sums the segments from the point start to the point end - 1
+    if (end - 1 <= start) {
+        return Inertia();
+    }
+    Inertia s = this->sums[static_cast<size_t>(end - 1)] - this->sums[static_cast<size_t>(start)];
+    s.translate(this->origin.x, this->origin.y);
+    return s;
+}
@@ -0,0 +1,60 @@
+/*
+ * Xournal++
+ *
+ * Part of the Xournal shape recognizer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "model/Point.h"
+
+#include "Inertia.h"
+
+/**
+ * @brief Cumulated inertia moments of the segments of a stroke, so that the moments of any range of points are
+ * obtained in constant time.
+ *
+ * The points are appended as the stroke grows. The moments are summed relative to the first point, which keeps the
+ * sums small and their differences accurate.
+ */
+class InertiaPrefixSums {
+public:
+    InertiaPrefixSums() = default;
+    explicit InertiaPrefixSums(const std::vector<Point>& points);
+
+public:
+    void addPoint(const Point& p);
+
+    /**
+     * Append the points that are not covered yet. If there are fewer points than covered, the sums are rebuilt.
+     */
+    void update(const std::vector<Point>& points);
+
+    void clear();
+
+    /**
+     * @return The number of points covered
+     */
+    size_t size() const;
+
+    /**
+     * @return The same moments as Inertia::calc(pt, start, end) on the covered points
+     */
+    Inertia calc(int start, int end) const;
+
+private:
+    /**
+     * sums[i] holds the moments of the segments before the point i, relative to origin
+     */
+    std::vector<Inertia> sums;
+    Point origin;
+    Point last;
+};
@@ -94,7 +94,8 @@ auto ShapeRecognizer::tryRectangle() -> Stroke* {
 /*
  * check if something is a polygonal line with at most nsides sides
  */
-auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsides, int* breaks, Inertia* ss) -> int {
+auto ShapeRecognizer::findPolygonal(const Point* pt, const InertiaPrefixSums& moments, int start, int end, int nsides,
+                                    int* breaks, Inertia* ss) -> int {
     Inertia s;
     int i1 = 0, i2 = 0, n1 = 0, n2 = 0;
 
@@ -115,7 +116,7 @@ auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsi
     for (; k < nsides; k++) {
         i1 = start + (k * (end - start)) / nsides;
         i2 = start + ((k + 1) * (end - start)) / nsides;
-        s.calc(pt, i1, i2);
+        s = moments.calc(i1, i2);
         if (s.det() < LINE_MAX_DET) {
             break;
         }
@@ -159,7 +160,7 @@ auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsi
     }
 
     if (i1 > start) {
-        n1 = findPolygonal(pt, start, i1, (i2 == end) ? (nsides - 1) : (nsides - 2), breaks, ss);
+        n1 = findPolygonal(pt, moments, start, i1, (i2 == end) ? (nsides - 1) : (nsides - 2), breaks, ss);
         if (n1 == 0) {
             return 0;  // it doesn't work
         }
@@ -172,7 +173,7 @@ auto ShapeRecognizer::findPolygonal(const Point* pt, int start, int end, int nsi
     ss[n1] = s;
 
     if (i2 < end) {
-        n2 = findPolygonal(pt, i2, end, nsides - n1 - 1, breaks + n1 + 1, ss + n1 + 1);
+        n2 = findPolygonal(pt, moments, i2, end, nsides - n1 - 1, breaks + n1 + 1, ss + n1 + 1);
         if (n2 == 0) {
             return 0;
         }
@@ -238,6 +239,13 @@ void ShapeRecognizer::optimizePolygonal(const Point* pt, int nsides, int* breaks
  * The main pattern recognition function
  */
 auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> Stroke* {
+    if (stroke->getPointCount() < 3) {
+        return nullptr;
+    }
+    return recognizePatterns(stroke, InertiaPrefixSums(stroke->getPointVector()));
+}
+
+auto ShapeRecognizer::recognizePatterns(Stroke* stroke, const InertiaPrefixSums& moments) -> Stroke* {
     this->stroke = stroke;
 
     if (stroke->getPointCount() < 3) {
@@ -248,7 +256,7 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> Stroke* {
     int brk[5] = {0};
 
     // first see if it's a polygon
-    int n = findPolygonal(stroke->getPoints(), 0, stroke->getPointCount() - 1, MAX_POLYGON_SIDES, brk, ss);
+    int n = findPolygonal(stroke->getPoints(), moments, 0, stroke->getPointCount() - 1, MAX_POLYGON_SIDES, brk, ss);
     if (n > 0) {
         optimizePolygonal(stroke->getPoints(), n, brk, ss);
 #ifdef DEBUG_RECOGNIZER
@@ -318,7 +326,7 @@ auto ShapeRecognizer::recognizePatterns(Stroke* stroke) -> Stroke* {
     }
 
     // not a polygon: maybe a circle ?
-    Stroke* s = CircleRecognizer::recognize(stroke);
+    Stroke* s = CircleRecognizer::recognize(stroke, moments.calc(0, stroke->getPointCount()));
     if (s) {
         RDEBUG("return circle");
         return s;
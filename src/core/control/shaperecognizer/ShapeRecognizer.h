@@ -14,6 +14,7 @@
 #include <array>
 
 #include "CircleRecognizer.h"
+#include "InertiaPrefixSums.h"
 #include "RecoSegment.h"
 #include "ShapeRecognizerConfig.h"
 
@@ -26,6 +27,13 @@ public:
     virtual ~ShapeRecognizer();
 
     Stroke* recognizePatterns(Stroke* stroke);
+
+    /**
+     * Same as recognizePatterns(Stroke*), with the inertia moments of the stroke already summed up
+     *
+     * @param moments Covers the points of the stroke
+     */
+    Stroke* recognizePatterns(Stroke* stroke, const InertiaPrefixSums& moments);
     void resetRecognizer();
 
 private:
@@ -34,7 +42,8 @@ private:
 
     static void optimizePolygonal(const Point* pt, int nsides, int* breaks, Inertia* ss);
 
-    int findPolygonal(const Point* pt, int start, int end, int nsides, int* breaks, Inertia* ss);
+    int findPolygonal(const Point* pt, const InertiaPrefixSums& moments, int start, int end, int nsides, int* breaks,
+                      Inertia* ss);
 
 private:
     std::array<RecoSegment, MAX_POLYGON_SIDES + 1> queue{};
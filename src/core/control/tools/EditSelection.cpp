@@ -1057,6 +1057,13 @@ void EditSelection::drawDeleteRect(cairo_t* cr, double x, double y, double zoom)
 auto EditSelection::getView() -> XojPageView* { return this->view; }
 
 void EditSelection::serialize(ObjectOutputStream& out) const {
+    serializeBounds(out);
+
+    out.writeInt(static_cast<int>(this->getElements().size()));
+    for (Element* e: this->getElements()) { e->serialize(out); }
+}
+
+void EditSelection::serializeBounds(ObjectOutputStream& out) const {
     out.writeObject("EditSelection");
 
     out.writeDouble(this->x);
@@ -1071,9 +1078,6 @@ void EditSelection::serialize(ObjectOutputStream& out) const {
 
     this->contents->serialize(out);
     out.endObject();
-
-    out.writeInt(static_cast<int>(this->getElements().size()));
-    for (Element* e: this->getElements()) { e->serialize(out); }
 }
 
 void EditSelection::readSerialized(ObjectInputStream& in) {
@@ -243,6 +243,11 @@ public:
     void serialize(ObjectOutputStream& out) const override;
     void readSerialized(ObjectInputStream& in) override;
 
+    /**
+     * Serialize the selection without the elements, which serialize() writes after it
+     */
+    void serializeBounds(ObjectOutputStream& out) const;
+
 private:
     /**
      * Draws an indicator where you can scale the selection
@@ -8,6 +8,7 @@
 #include "gui/XournalView.h"
 #include "model/Document.h"
 #include "model/Element.h"
+#include "model/ElementTransform.h"
 #include "model/Layer.h"
 #include "model/Stroke.h"
 #include "model/Text.h"
@@ -359,18 +360,23 @@ void EditSelectionContents::finalizeSelection(Rectangle<double> bounds, Rectangl
 
     bool move = mx != 0 || my != 0;
 
+    // Compose all the transformations, so every stroke is transformed in a single pass over its points
+    ElementTransform transform;
+    if (move) {
+        transform = transform.then(ElementTransform::translation(mx, my));
+    }
+    if (scale) {
+        transform = transform.then(ElementTransform::scaling(bounds.x, bounds.y, fx, fy, 0, this->restoreLineWidth));
+    }
+    if (rotate) {
+        transform = transform.then(ElementTransform::rotation(snappedBounds.x + this->lastSnappedBounds.width / 2,
+                                                              snappedBounds.y + this->lastSnappedBounds.height / 2,
+                                                              this->rotation));
+    }
+    transform.applyTo(this->selected);
+
     g_assert(this->selected.size() == this->insertOrder.size());
     for (auto&& [e, index]: this->insertOrder) {
-        if (move) {
-            e->move(mx, my);
-        }
-        if (scale) {
-            e->scale(bounds.x, bounds.y, fx, fy, 0, this->restoreLineWidth);
-        }
-        if (rotate) {
-            e->rotate(snappedBounds.x + this->lastSnappedBounds.width / 2,
-                      snappedBounds.y + this->lastSnappedBounds.height / 2, this->rotation);
-        }
         if (index == Element::InvalidIndex) {
             // if the element didn't have a source layer (e.g, clipboard)
             layer->addElement(e);
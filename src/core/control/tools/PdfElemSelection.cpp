@@ -7,6 +7,7 @@
 #include "control/Control.h"
 #include "gui/XournalView.h"
 #include "pdf/base/XojPdfPage.h"
+#include "pdf/base/XojPdfTextLayout.h"
 
 PdfElemSelection::PdfElemSelection(double x, double y, XojPageView* view):
         view(view), pdf(nullptr), bounds({x, y, x, y}), finalized(false) {
@@ -19,6 +20,9 @@ PdfElemSelection::PdfElemSelection(double x, double y, XojPageView* view):
         doc->unlock();
 
         this->selectionPageNr = pNr;
+
+        // Start extracting the layout now, so that it is ready for the next motion events
+        this->textLayout = xournal->getControl()->getPdfTextLayoutCache()->get(pNr);
     }
 
     this->toolType = xournal->getControl()->getToolHandler()->getToolType();
@@ -49,6 +53,14 @@ bool PdfElemSelection::finalizeSelection(XojPdfPageSelectionStyle style) {
         cairo_region_destroy(this->selectedTextRegion);
     }
 
+    if (const XojPdfTextLayout* layout = getTextLayout(style)) {
+        XojPdfPage::TextSelection selection = layout->selectTextLines(this->bounds, style);
+        this->selectedTextRegion = selection.region;
+        this->selectedTextRects = std::move(selection.rects);
+        this->selectedText = layout->selectText(this->bounds, style);
+        return !this->selectedTextRects.empty();
+    }
+
     XojPdfPage::TextSelection selection = this->pdf->selectTextLines(this->bounds, style);
     this->selectedTextRegion = selection.region;
     this->selectedTextRects = std::move(selection.rects);
@@ -56,6 +68,17 @@ bool PdfElemSelection::finalizeSelection(XojPdfPageSelectionStyle style) {
     return !this->selectedTextRects.empty();
 }
 
+auto PdfElemSelection::getTextLayout(XojPdfPageSelectionStyle style) -> const XojPdfTextLayout* {
+    if (style == XojPdfPageSelectionStyle::Area) {
+        // Not supported by the layout. Area selections only query the PDF when they are finalized.
+        return nullptr;
+    }
+    if (!this->textLayout && this->selectionPageNr != npos) {
+        this->textLayout = this->view->getXournal()->getControl()->getPdfTextLayoutCache()->get(this->selectionPageNr);
+    }
+    return this->textLayout.get();
+}
+
 void PdfElemSelection::paint(cairo_t* cr, XojPdfPageSelectionStyle style) {
     if (!this->pdf)
         return;
@@ -157,7 +180,11 @@ auto PdfElemSelection::selectTextRegion(XojPdfPageSelectionStyle style) -> bool
         cairo_region_destroy(this->selectedTextRegion);
     }
 
-    this->selectedTextRegion = this->pdf->selectTextRegion(this->bounds, style);
+    if (const XojPdfTextLayout* layout = getTextLayout(style)) {
+        this->selectedTextRegion = layout->selectTextRegion(this->bounds, style);
+    } else {
+        this->selectedTextRegion = this->pdf->selectTextRegion(this->bounds, style);
+    }
     g_assert_nonnull(this->selectedTextRegion);
 
     return !cairo_region_is_empty(this->selectedTextRegion);
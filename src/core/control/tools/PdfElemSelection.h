@@ -11,6 +11,7 @@
 #pragma once
 
 #include <string>
+#include <memory>
 #include <vector>
 
 #include "control/ToolEnums.h"
@@ -75,9 +76,16 @@ private:
     /// Assigns the selected text region to the current selection bounds.
     bool selectTextRegion(XojPdfPageSelectionStyle style);
 
+    /// Returns the cached text layout of the page if it can answer the
+    /// queries for the given style, nullptr to ask the PDF backend.
+    const XojPdfTextLayout* getTextLayout(XojPdfPageSelectionStyle style);
+
     XojPageView* view;
     XojPdfPageSPtr pdf;
 
+    /// The layout of the PDF page, once extracted in the background.
+    std::shared_ptr<const XojPdfTextLayout> textLayout;
+
     /// The rectangles corresponding to the lines of selected text.
     std::vector<XojPdfRectangle> selectedTextRects;
 
@@ -1,5 +1,6 @@
 #include "Selection.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "model/Layer.h"
@@ -66,6 +67,10 @@ auto RectSelection::contains(double x, double y) -> bool {
     return true;
 }
 
+auto RectSelection::containsRectangle(const xoj::util::Rectangle<double>& rect) -> bool {
+    return contains(rect.x, rect.y) && contains(rect.x + rect.width, rect.y + rect.height);
+}
+
 void RectSelection::currentPos(double x, double y) {
     double aX = std::min(x, this->ex);
     aX = std::min(aX, this->sx) - 10;
@@ -249,6 +254,24 @@ auto RegionSelect::contains(double x, double y) -> bool {
     return (hits & 1) != 0;
 }
 
+auto RegionSelect::containsRectangle(const xoj::util::Rectangle<double>& rect) -> bool {
+    if (!contains(rect.x, rect.y)) {
+        return false;
+    }
+
+    // A corner is inside: so is the whole rectangle, unless an edge of the polygon enters it. To keep it cheap, any
+    // edge whose bounding box meets the rectangle is assumed to.
+    const RegionPoint* last = &points.back();
+    for (const RegionPoint& p: points) {
+        if (std::max(last->x, p.x) >= rect.x && std::min(last->x, p.x) <= rect.x + rect.width &&
+            std::max(last->y, p.y) >= rect.y && std::min(last->y, p.y) <= rect.y + rect.height) {
+            return false;
+        }
+        last = &p;
+    }
+    return true;
+}
+
 auto RegionSelect::finalize(PageRef page) -> bool {
     this->page = page;
 
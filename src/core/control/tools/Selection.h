@@ -55,6 +55,7 @@ public:
     void paint(cairo_t* cr, double zoom) override;
     void currentPos(double x, double y) override;
     bool contains(double x, double y) override;
+    bool containsRectangle(const xoj::util::Rectangle<double>& rect) override;
     bool userTapped(double zoom) override;
 
 private:
@@ -84,6 +85,7 @@ public:
     void paint(cairo_t* cr, double zoom) override;
     void currentPos(double x, double y) override;
     bool contains(double x, double y) override;
+    bool containsRectangle(const xoj::util::Rectangle<double>& rect) override;
     bool userTapped(double zoom) override;
 
 private:
@@ -1,5 +1,6 @@
 #include "StrokeHandler.h"
 
+#include <algorithm>
 #include <cmath>
 #include <memory>
 
@@ -27,6 +28,8 @@ StrokeHandler::StrokeHandler(XournalView* xournal, XojPageView* redrawable, cons
         snappingHandler(xournal->getControl()->getSettings()),
         stabilizer(StrokeStabilizer::get(xournal->getControl()->getSettings())) {}
 
+StrokeHandler::~StrokeHandler() { resetSpeculativeRecognition(); }
+
 void StrokeHandler::draw(cairo_t* cr) {
     assert(stroke && stroke->getPointCount() > 0);
 
@@ -145,6 +148,17 @@ void StrokeHandler::drawSegmentTo(const Point& point) {
 
     stroke->addPoint(this->hasPressure ? point : Point(point.x, point.y));
 
+    if (this->recognizerEnabled) {
+        this->moments.addPoint(point);
+
+        // Restart the delay: the recognition is done when the pen rests
+        if (this->speculationTimeout != 0) {
+            g_source_remove(this->speculationTimeout);
+        }
+        this->speculationTimeout =
+                g_timeout_add(SPECULATION_DELAY, reinterpret_cast<GSourceFunc>(speculativeRecognition), this);
+    }
+
     double width = stroke->getWidth();
 
     assert(stroke->getPointCount() >= 2);
@@ -179,7 +193,35 @@ void StrokeHandler::drawSegmentTo(const Point& point) {
                                   rg.getHeight() + width);
 }
 
+auto StrokeHandler::speculativeRecognition(StrokeHandler* handler) -> gboolean {
+    handler->speculationTimeout = 0;
+
+    if (handler->stroke) {
+        ShapeRecognizer reco;
+        handler->speculativeShape.reset(reco.recognizePatterns(handler->stroke, handler->moments));
+        handler->speculativePoints = handler->stroke->getPointVector();
+    }
+    return G_SOURCE_REMOVE;
+}
+
+auto StrokeHandler::isSpeculationValid() const -> bool {
+    const auto& points = stroke->getPointVector();
+    return std::equal(points.begin(), points.end(), this->speculativePoints.begin(), this->speculativePoints.end(),
+                      [](const Point& a, const Point& b) { return a.equalsPos(b) && a.z == b.z; });
+}
+
+void StrokeHandler::resetSpeculativeRecognition() {
+    if (this->speculationTimeout != 0) {
+        g_source_remove(this->speculationTimeout);
+        this->speculationTimeout = 0;
+    }
+    this->speculativeShape.reset();
+    this->speculativePoints.clear();
+}
+
 void StrokeHandler::onMotionCancelEvent() {
+    resetSpeculativeRecognition();
+    this->moments.clear();
     delete stroke;
     stroke = nullptr;
 }
@@ -222,6 +264,7 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos) {
                 this->redrawable->rerenderRect(stroke->getX(), stroke->getY(), stroke->getElementWidth(),
                                                stroke->getElementHeight());  // clear onMotionNotifyEvent drawing //!
 
+                resetSpeculativeRecognition();
                 delete stroke;
                 stroke = nullptr;
                 this->userTapped = true;
@@ -256,12 +299,17 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos) {
 
     undo->addUndoAction(std::make_unique<InsertUndoAction>(page, layer, stroke));
 
-    ToolHandler* h = control->getToolHandler();
-
-    if (h->getDrawingType() == DRAWING_TYPE_STROKE_RECOGNIZER) {
-        ShapeRecognizer reco;
-
-        Stroke* recognized = reco.recognizePatterns(stroke);
+    if (this->recognizerEnabled) {
+        Stroke* recognized = nullptr;
+        if (this->speculativeShape && isSpeculationValid()) {
+            // Nothing was drawn since the pen rested: the shape is known already
+            recognized = this->speculativeShape.release();
+        } else {
+            this->moments.update(stroke->getPointVector());
+            ShapeRecognizer reco;
+            recognized = reco.recognizePatterns(stroke, this->moments);
+        }
+        resetSpeculativeRecognition();
 
         if (recognized) {
             strokeRecognizerDetected(recognized, layer);
@@ -274,6 +322,7 @@ void StrokeHandler::onButtonReleaseEvent(const PositionInputData& pos) {
         }
     }
 
+    stroke->compact(settings->getStrokeStorage());
     layer->addElement(stroke);
     page->fireElementChanged(stroke);
 
@@ -336,6 +385,14 @@ void StrokeHandler::onButtonPressEvent(const PositionInputData& pos) {
 
         this->hasPressure = this->stroke->getToolType() == STROKE_TOOL_PEN && pos.pressure != Point::NO_PRESSURE;
 
+        this->recognizerEnabled =
+                xournal->getControl()->getToolHandler()->getDrawingType() == DRAWING_TYPE_STROKE_RECOGNIZER;
+        resetSpeculativeRecognition();
+        this->moments.clear();
+        if (this->recognizerEnabled) {
+            this->moments.addPoint(this->stroke->getPoint(0));
+        }
+
         stabilizer->initialize(this, zoom, pos);
     }
 
@@ -11,6 +11,10 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
+#include "control/shaperecognizer/InertiaPrefixSums.h"
 #include "view/View.h"
 
 #include "InputHandler.h"
@@ -33,7 +37,7 @@ class Active;
 class StrokeHandler: public InputHandler {
 public:
     StrokeHandler(XournalView* xournal, XojPageView* redrawable, const PageRef& page);
-    ~StrokeHandler() override = default;
+    ~StrokeHandler() override;
 
     void draw(cairo_t* cr) override;
 
@@ -66,6 +70,21 @@ protected:
 
     void strokeRecognizerDetected(Stroke* recognized, Layer* layer);
 
+    /**
+     * @brief Run the shape recognizer on the stroke as it is now, and keep the result for the button release
+     */
+    static gboolean speculativeRecognition(StrokeHandler* handler);
+
+    /**
+     * @brief Whether the points of the stroke are those the speculative recognition was run on
+     */
+    bool isSpeculationValid() const;
+
+    /**
+     * @brief Forget the speculative recognition and stop the timeout
+     */
+    void resetSpeculativeRecognition();
+
 protected:
     Point buttonDownPoint;  // used for tapSelect and filtering - never snapped to grid.
     SnapToGridInputHandler snappingHandler;
@@ -121,6 +140,27 @@ private:
     bool hasPressure;
     bool firstPointPressureChange = false;
 
+    /**
+     * Whether the stroke is passed to the shape recognizer on release
+     */
+    bool recognizerEnabled = false;
+
+    /**
+     * Inertia moments of the stroke, updated with every new point so that the recognizer does not sum them again
+     */
+    InertiaPrefixSums moments;
+
+    /**
+     * @brief Shape recognition done while the pen rests, to be reused on release if the points of the stroke did not
+     * change since: none was added, and none was edited in place (e.g. the pressures set by the stabilizer).
+     * The recognizer is run once the pen has not moved for SPECULATION_DELAY ms.
+     */
+    std::unique_ptr<Stroke> speculativeShape;
+    std::vector<Point> speculativePoints;  ///< Points of the stroke at the speculation
+    guint speculationTimeout = 0;          ///< Pending timeout of the speculation, 0 if none
+
+    static constexpr guint SPECULATION_DELAY = 150;
+
     friend class StrokeStabilizer::Active;
 
     static constexpr double MAX_WIDTH_VARIATION = 0.3;
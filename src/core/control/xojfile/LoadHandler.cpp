@@ -80,6 +80,11 @@ void LoadHandler::initAttributes() {
     this->text = nullptr;
     this->pages.clear();
 
+    this->strokeGeometry.reset();
+    this->strokeGeometryIndex = 0;
+    this->contentCrc = crc32(0L, Z_NULL, 0);
+    this->contentLength = 0;
+
     if (this->audioFiles) {
         g_hash_table_unref(this->audioFiles);
     }
@@ -99,6 +104,8 @@ void LoadHandler::setPdfReplacement(fs::path filepath, bool attachToDocument) {
     this->pdfReplacementAttach = attachToDocument;
 }
 
+void LoadHandler::setStrokeStorage(StrokeStorage storage) { this->strokeStorage = storage; }
+
 auto LoadHandler::openFile(fs::path const& filepath) -> bool {
     this->filepath = filepath;
     int zipError = 0;
@@ -166,6 +173,10 @@ auto LoadHandler::openFile(fs::path const& filepath) -> bool {
         this->lastError = FS(_F("Could not open file: \"{1}\"") % filepath.u8string());
         return false;
     }
+
+    if (!this->ignoreStrokeGeometry && this->isGzFile) {
+        this->strokeGeometry = StrokeGeometryChunk::readFromCache(filepath);
+    }
     return true;
 }
 
@@ -185,18 +196,33 @@ auto LoadHandler::readContentFile(char* buffer, zip_uint64_t len) -> zip_int64_t
         if (gzeof(this->gzFp)) {
             return -1;
         }
-        return gzread(this->gzFp, buffer, static_cast<unsigned int>(len));
+        int lengthRead = gzread(this->gzFp, buffer, static_cast<unsigned int>(len));
+        updateContentChecksum(buffer, lengthRead);
+        return lengthRead;
     }
 
     g_assert(this->zipContentFile != nullptr);
     zip_int64_t lengthRead = zip_fread(this->zipContentFile, buffer, len);
     if (lengthRead > 0) {
+        updateContentChecksum(buffer, lengthRead);
         return lengthRead;
     }
 
     return -1;
 }
 
+void LoadHandler::updateContentChecksum(const char* buffer, zip_int64_t len) {
+    if (this->strokeGeometry && len > 0) {
+        this->contentCrc = crc32(this->contentCrc, reinterpret_cast<const Bytef*>(buffer), static_cast<uInt>(len));
+        this->contentLength += static_cast<uint64_t>(len);
+    }
+}
+
+auto LoadHandler::isStrokeGeometryConsistent() const -> bool {
+    return this->strokeGeometry->matches(static_cast<uint32_t>(this->contentCrc), this->contentLength) &&
+           this->strokeGeometryIndex == this->strokeGeometry->getStrokeCount();
+}
+
 auto LoadHandler::parseXml() -> bool {
     const GMarkupParser parser = {LoadHandler::parserStartElement, LoadHandler::parserEndElement,
                                   LoadHandler::parserText, nullptr, nullptr};
@@ -438,12 +464,12 @@ void LoadHandler::parseBgPdf() {
                 if (this->isGzFile) {
                     pdfFilename = (fs::path{xournalFilepath} += ".") += pdfFilename;
                 } else {
-                    auto readResult = readZipAttachment(pdfFilename);
-                    if (!readResult) {
+                    GBytes* pdfBytes = readZipAttachmentBytes(pdfFilename);
+                    if (!pdfBytes) {
                         return;
                     }
-                    std::string& pdfBytes = readResult.value();
-                    doc.readPdf(pdfFilename, false, attachToDocument, pdfBytes.data(), pdfBytes.size());
+                    doc.readPdf(pdfFilename, false, attachToDocument, pdfBytes);
+                    g_bytes_unref(pdfBytes);
 
                     if (!doc.getLastErrorMsg().empty()) {
                         error("%s", FC(_F("Error reading PDF: {1}") % doc.getLastErrorMsg()));
@@ -525,6 +551,16 @@ void LoadHandler::parseStroke() {
         return;
     }
 
+    if (this->strokeGeometry) {
+        // The points and pressures are copied from the binary chunk, their text is not parsed
+        std::vector<Point> points;
+        if (!this->strokeGeometry->readStroke(this->strokeGeometryIndex++, points) || points.size() < 2) {
+            error("%s", _("The stroke geometry does not match the content"));
+            return;
+        }
+        stroke->setPointVector(std::move(points));
+    }
+
     // MrWriter writes pressures as separate field
     const char* pressure = LoadHandlerHelper::getAttrib("pressures", true, this);
     if (pressure == nullptr) {
@@ -532,7 +568,7 @@ void LoadHandler::parseStroke() {
         pressure = endPtr;
     }
 
-    while (*pressure != 0) {
+    while (!this->strokeGeometry && *pressure != 0) {
         char* tmpptr = nullptr;
         double val = g_ascii_strtod(pressure, &tmpptr);
         if (tmpptr == pressure) {
@@ -879,6 +915,7 @@ void LoadHandler::parserEndElement(GMarkupParseContext* context, const gchar* el
         handler->stroke = nullptr;
     } else if (handler->pos == PARSER_POS_IN_STROKE && strcmp(elementName, "stroke") == 0) {
         handler->pos = PARSER_POS_IN_LAYER;
+        handler->stroke->compact(handler->strokeStorage);
         handler->stroke = nullptr;
     } else if (handler->pos == PARSER_POS_IN_TEXT && strcmp(elementName, "text") == 0) {
         handler->pos = PARSER_POS_IN_LAYER;
@@ -901,7 +938,7 @@ void LoadHandler::parserText(GMarkupParseContext* context, const gchar* text, gs
     }
 
     auto* handler = static_cast<LoadHandler*>(userdata);
-    if (handler->pos == PARSER_POS_IN_STROKE) {
+    if (handler->pos == PARSER_POS_IN_STROKE && !handler->strokeGeometry) {
         const char* ptr = text;
         int n = 0;
 
@@ -1001,7 +1038,19 @@ auto LoadHandler::loadDocument(fs::path const& filepath) -> Document* {
 
     this->pdfFilenameParsed = false;
 
-    if (!parseXml()) {
+    bool parsed = parseXml();
+    if (this->strokeGeometry && (!parsed || !isStrokeGeometryConsistent())) {
+        g_warning("LoadHandler: the stroke geometry of \"%s\" does not match its content, reading the XML instead",
+                  filepath.u8string().c_str());
+        closeFile();
+        this->lastError.clear();
+        this->ignoreStrokeGeometry = true;
+        Document* result = loadDocument(filepath);
+        this->ignoreStrokeGeometry = false;
+        return result;
+    }
+
+    if (!parsed) {
         closeFile();
         return nullptr;
     }
@@ -1065,6 +1114,16 @@ auto LoadHandler::readZipAttachment(fs::path const& filename) -> std::optional<s
     return {std::move(data)};
 }
 
+auto LoadHandler::readZipAttachmentBytes(fs::path const& filename) -> GBytes* {
+    auto readResult = readZipAttachment(filename);
+    if (!readResult) {
+        return nullptr;
+    }
+    auto* data = new std::string(std::move(*readResult));
+    return g_bytes_new_with_free_func(
+            data->data(), data->size(), [](gpointer d) { delete static_cast<std::string*>(d); }, data);
+}
+
 auto LoadHandler::getTempFileForPath(fs::path const& filename) -> fs::path {
     gpointer tmpFilename = g_hash_table_lookup(this->audioFiles, filename.u8string().c_str());
     if (tmpFilename) {
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <optional>
 #include <regex>
 #include <string>
 #include <vector>
@@ -25,6 +26,7 @@
 #include "model/Text.h"
 
 #include "LoadHandlerHelper.h"
+#include "StrokeGeometryChunk.h"
 
 
 enum ParserPosition {
@@ -55,6 +57,11 @@ public:
     void removePdfBackground();
     void setPdfReplacement(fs::path filepath, bool attachToDocument);
 
+    /**
+     * Set how the points of the loaded strokes are stored in memory (default: StrokeStorage::POINTS)
+     */
+    void setStrokeStorage(StrokeStorage storage);
+
     /** @return The version of the loaded file */
     int getFileVersion() const;
 
@@ -75,6 +82,8 @@ private:
 
     std::string readLine();
     zip_int64_t readContentFile(char* buffer, zip_uint64_t len);
+    void updateContentChecksum(const char* buffer, zip_int64_t len);
+    bool isStrokeGeometryConsistent() const;
     bool closeFile();
     bool openFile(fs::path const& filepath);
     bool parseXml();
@@ -107,6 +116,11 @@ private:
      */
     std::optional<std::string> readZipAttachment(fs::path const& filename);
 
+    /**
+     * Same as readZipAttachment, handing the data over without copying it. The caller owns the reference.
+     */
+    GBytes* readZipAttachmentBytes(fs::path const& filename);
+
     fs::path getTempFileForPath(fs::path const& filename);
 
 private:
@@ -135,6 +149,21 @@ private:
 
     std::vector<double> pressureBuffer;
 
+    StrokeStorage strokeStorage = StrokeStorage::POINTS;
+
+    /**
+     * Binary copy of the stroke points, if the file has one. Used instead of the coordinates in the XML.
+     */
+    std::optional<StrokeGeometryChunk> strokeGeometry;
+    size_t strokeGeometryIndex = 0;
+    bool ignoreStrokeGeometry = false;
+
+    /**
+     * CRC-32 and length of the XML content read so far, to check the stroke geometry
+     */
+    uLong contentCrc = 0;
+    uint64_t contentLength = 0;
+
     std::vector<PageRef> pages;
     PageRef page;
     Layer* layer;
@@ -27,6 +27,8 @@ SaveHandler::SaveHandler() {
     this->attachBgId = 1;
 }
 
+void SaveHandler::setWriteStrokeGeometry(bool write) { this->writeStrokeGeometry = write; }
+
 void SaveHandler::prepareSave(Document* doc) {
     if (this->root) {
         // cleanup old data
@@ -112,6 +114,10 @@ void SaveHandler::visitStroke(XmlPointNode* stroke, Stroke* s) {
     }
 
     visitStrokeExtended(stroke, s);
+
+    if (this->writeStrokeGeometry) {
+        this->strokeGeometry.addStroke(*s);
+    }
 }
 
 /**
@@ -301,13 +307,20 @@ void SaveHandler::saveTo(const fs::path& filepath, ProgressListener* listener) {
         return;
     }
 
-    saveTo(&out, filepath, listener);
+    ChecksumOutputStream checkedOut(&out);
+    saveTo(&checkedOut, filepath, listener);
 
     out.close();
 
     if (this->errorMessage.empty()) {
         this->errorMessage = out.getLastError();
     }
+
+    // The chunk is only a cache: the document is saved even if it cannot be written
+    if (this->writeStrokeGeometry && this->errorMessage.empty() &&
+        !this->strokeGeometry.writeToCache(checkedOut.getCrc(), checkedOut.getLength())) {
+        g_warning("Could not write the stroke geometry of \"%s\" to the cache", filepath.u8string().c_str());
+    }
 }
 
 void SaveHandler::saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener) {
@@ -21,6 +21,8 @@
 #include "model/Stroke.h"
 #include "util/OutputStream.h"
 
+#include "StrokeGeometryChunk.h"
+
 
 class XmlNode;
 class XmlPointNode;
@@ -31,6 +33,12 @@ public:
     SaveHandler();
 
 public:
+    /**
+     * Also write the points of the strokes in binary form (see StrokeGeometryChunk), when saving to a file.
+     * Must be called before prepareSave()
+     */
+    void setWriteStrokeGeometry(bool write);
+
     void prepareSave(Document* doc);
     void saveTo(const fs::path& filepath, ProgressListener* listener = nullptr);
     void saveTo(OutputStream* out, const fs::path& filepath, ProgressListener* listener = nullptr);
@@ -61,4 +69,7 @@ protected:
     std::string errorMessage;
 
     std::vector<BackgroundImage> backgroundImages{};
+
+    bool writeStrokeGeometry = false;
+    StrokeGeometryChunk strokeGeometry;
 };
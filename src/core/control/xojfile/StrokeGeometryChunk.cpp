@@ -0,0 +1,256 @@
+#include "StrokeGeometryChunk.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <utility>
+
+#include <glib.h>
+
+#include "model/Stroke.h"
+#include "model/StrokeGeometry.h"
+#include "util/PathUtil.h"
+
+constexpr char MAGIC[] = "XOPPGEOM";
+constexpr size_t MAGIC_LENGTH = sizeof(MAGIC) - 1;
+constexpr uint32_t VERSION = 1;
+constexpr size_t HEADER_SIZE = MAGIC_LENGTH + 4 + 4 + 8 + 8;
+constexpr size_t RECORD_HEADER_SIZE = 4 + 4;
+constexpr uint32_t FLAG_PRESSURE = 1;
+
+static_assert(sizeof(Point) == 3 * sizeof(double) && std::is_trivially_copyable_v<Point>,
+              "Points are copied from and to the chunk as 3 doubles");
+
+static void putU32(std::string& out, uint32_t v) {
+    v = GUINT32_TO_LE(v);
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void putU64(std::string& out, uint64_t v) {
+    v = GUINT64_TO_LE(v);
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+static void putDouble(std::string& out, double d) {
+    uint64_t v = 0;
+    std::memcpy(&v, &d, sizeof(v));
+    putU64(out, v);
+}
+
+static auto getU32(const char* in) -> uint32_t {
+    uint32_t v = 0;
+    std::memcpy(&v, in, sizeof(v));
+    return GUINT32_FROM_LE(v);
+}
+
+static auto getU64(const char* in) -> uint64_t {
+    uint64_t v = 0;
+    std::memcpy(&v, in, sizeof(v));
+    return GUINT64_FROM_LE(v);
+}
+
+/**
+ * The value written to the XML (with Util::PRECISION_FORMAT_STRING), as read back
+ */
+static auto roundToFilePrecision(double v) -> double {
+    return std::round(v * StrokeGeometry::STEPS_PER_UNIT) / StrokeGeometry::STEPS_PER_UNIT;
+}
+
+void StrokeGeometryChunk::addStroke(const Stroke& s) {
+    const auto& points = s.getPointVector();
+    const bool pressure = s.hasPressure();
+
+    putU32(this->data, static_cast<uint32_t>(points.size()));
+    putU32(this->data, pressure ? FLAG_PRESSURE : 0);
+    for (size_t i = 0; i < points.size(); ++i) {
+        putDouble(this->data, roundToFilePrecision(points[i].x));
+        putDouble(this->data, roundToFilePrecision(points[i].y));
+        if (pressure) {
+            // As in the XML, the pressure of the last point is not saved
+            putDouble(this->data, i + 1 < points.size() ? roundToFilePrecision(points[i].z) : Point::NO_PRESSURE);
+        }
+    }
+    this->strokeCount++;
+}
+
+auto StrokeGeometryChunk::encode(uint32_t contentCrc, uint64_t contentLength) const -> std::string {
+    std::string out;
+    out.reserve(HEADER_SIZE + this->data.size());
+    out.append(MAGIC, MAGIC_LENGTH);
+    putU32(out, VERSION);
+    putU32(out, contentCrc);
+    putU64(out, contentLength);
+    putU64(out, this->strokeCount);
+    out += this->data;
+    return out;
+}
+
+auto StrokeGeometryChunk::getCacheDir() -> fs::path { return Util::getCacheSubfolder("stroke-geometry"); }
+
+auto StrokeGeometryChunk::getCacheName(uint32_t contentCrc, uint64_t contentLength) -> std::string {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%08x-%08x.geometry", contentCrc, static_cast<uint32_t>(contentLength));
+    return name;
+}
+
+auto StrokeGeometryChunk::writeToCache(uint32_t contentCrc, uint64_t contentLength, const fs::path& dir) const
+        -> bool {
+    std::string chunk = encode(contentCrc, contentLength);
+
+    // Write, then rename, so that other instances never read a partial file
+    fs::path path = dir / getCacheName(contentCrc, contentLength);
+    fs::path tmpPath = path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios_base::binary | std::ios_base::trunc);
+        out.write(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        if (!out.good()) {
+            return false;
+        }
+    }
+    std::error_code ec;
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        fs::remove(tmpPath, ec);
+        return false;
+    }
+
+    evict(dir);
+    return true;
+}
+
+void StrokeGeometryChunk::evict(const fs::path& dir) {
+    std::vector<std::pair<fs::file_time_type, fs::path>> chunks;
+    std::error_code ec;
+    for (auto it = fs::directory_iterator(dir, ec); !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        if (it->path().extension() == ".geometry") {
+            std::error_code entryEc;
+            chunks.emplace_back(fs::last_write_time(it->path(), entryEc), it->path());
+        }
+    }
+    if (chunks.size() <= MAX_CACHED_CHUNKS) {
+        return;
+    }
+
+    std::sort(chunks.begin(), chunks.end());
+    for (size_t i = 0; i < chunks.size() - MAX_CACHED_CHUNKS; ++i) { fs::remove(chunks[i].second, ec); }
+}
+
+auto StrokeGeometryChunk::getCachePath(const fs::path& document, const fs::path& dir) -> fs::path {
+    // The gzip trailer: CRC-32 and length (modulo 2^32) of the content
+    std::ifstream doc(document, std::ios_base::binary | std::ios_base::ate);
+    char trailer[8];
+    if (!doc || doc.tellg() < static_cast<std::streamoff>(sizeof(trailer)) ||
+        !doc.seekg(-static_cast<std::streamoff>(sizeof(trailer)), std::ios_base::end) ||
+        !doc.read(trailer, sizeof(trailer))) {
+        return {};
+    }
+    return dir / getCacheName(getU32(trailer), getU32(trailer + 4));
+}
+
+auto StrokeGeometryChunk::readFromCache(const fs::path& document, const fs::path& dir)
+        -> std::optional<StrokeGeometryChunk> {
+    fs::path path = getCachePath(document, dir);
+    if (path.empty()) {
+        return std::nullopt;
+    }
+    std::ifstream in(path, std::ios_base::binary | std::ios_base::ate);
+    if (!in) {
+        return std::nullopt;
+    }
+    const auto fileSize = static_cast<uint64_t>(in.tellg());
+    if (fileSize < HEADER_SIZE) {
+        return std::nullopt;
+    }
+
+    std::string chunk(fileSize, '\0');
+    in.seekg(0);
+    if (!in.read(chunk.data(), static_cast<std::streamsize>(fileSize))) {
+        return std::nullopt;
+    }
+
+    // The modification time orders the chunks for eviction
+    std::error_code ec;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+    return decode(std::move(chunk));
+}
+
+auto StrokeGeometryChunk::decode(std::string data) -> std::optional<StrokeGeometryChunk> {
+    if (data.size() < HEADER_SIZE || data.compare(0, MAGIC_LENGTH, MAGIC) != 0) {
+        return std::nullopt;
+    }
+    const char* header = data.data() + MAGIC_LENGTH;
+    if (getU32(header) != VERSION) {
+        return std::nullopt;
+    }
+
+    StrokeGeometryChunk chunk;
+    chunk.contentCrc = getU32(header + 4);
+    chunk.contentLength = getU64(header + 8);
+    const uint64_t strokeCount = getU64(header + 16);
+
+    // Index the records, checking that they all fit in the data
+    size_t offset = HEADER_SIZE;
+    for (uint64_t i = 0; i < strokeCount; ++i) {
+        if (data.size() - offset < RECORD_HEADER_SIZE) {
+            return std::nullopt;
+        }
+        const uint64_t pointCount = getU32(data.data() + offset);
+        const uint32_t flags = getU32(data.data() + offset + 4);
+        const uint64_t recordSize = pointCount * ((flags & FLAG_PRESSURE) ? 3 : 2) * sizeof(double);
+        if (data.size() - offset - RECORD_HEADER_SIZE < recordSize) {
+            return std::nullopt;
+        }
+        chunk.strokeOffsets.push_back(offset);
+        offset += RECORD_HEADER_SIZE + recordSize;
+    }
+    if (offset != data.size()) {
+        return std::nullopt;
+    }
+
+    chunk.strokeCount = static_cast<size_t>(strokeCount);
+    chunk.data = std::move(data);
+    return chunk;
+}
+
+auto StrokeGeometryChunk::matches(uint32_t contentCrc, uint64_t contentLength) const -> bool {
+    return this->contentCrc == contentCrc && this->contentLength == contentLength;
+}
+
+auto StrokeGeometryChunk::getStrokeCount() const -> size_t { return this->strokeCount; }
+
+auto StrokeGeometryChunk::readStroke(size_t index, std::vector<Point>& points) const -> bool {
+    if (index >= this->strokeOffsets.size()) {
+        return false;
+    }
+    const char* record = this->data.data() + this->strokeOffsets[index];
+    const size_t pointCount = getU32(record);
+    const bool pressure = getU32(record + 4) & FLAG_PRESSURE;
+    const char* values = record + RECORD_HEADER_SIZE;
+
+    points.resize(pointCount);
+#if G_BYTE_ORDER == G_LITTLE_ENDIAN
+    if (pressure) {
+        // Same layout as std::vector<Point>
+        std::memcpy(points.data(), values, pointCount * sizeof(Point));
+        return true;
+    }
+#endif
+    const size_t stride = (pressure ? 3 : 2) * sizeof(double);
+    for (size_t i = 0; i < pointCount; ++i, values += stride) {
+        uint64_t v[3] = {getU64(values), getU64(values + 8), 0};
+        Point& p = points[i];
+        std::memcpy(&p.x, &v[0], sizeof(double));
+        std::memcpy(&p.y, &v[1], sizeof(double));
+        if (pressure) {
+            v[2] = getU64(values + 16);
+            std::memcpy(&p.z, &v[2], sizeof(double));
+        } else {
+            p.z = Point::NO_PRESSURE;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,128 @@
+/*
+ * Xournal++
+ *
+ * Binary copy of the points of all the strokes of a document, cached along with the XML content
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "model/Point.h"
+
+#include "filesystem.h"
+
+class Stroke;
+
+/**
+ * @brief The points of the strokes of a document, as little-endian arrays of doubles.
+ *
+ * Parsing the coordinates from the XML text is the most expensive part of loading a document. This chunk lets the
+ * LoadHandler copy them instead. It is only used if the CRC-32 and the length of the XML content it was written with
+ * match those of the content actually read, so a file edited by another program falls back to the XML.
+ *
+ * The chunk of a gzipped .xopp file is stored in the cache directory, so that the .xopp file stays a plain gzip
+ * stream, readable by any tool. It is named after the CRC-32 and length of the content, which the gzip trailer of the
+ * document holds: it follows the document when it is renamed or copied, and is simply not found once the document is
+ * changed. The least recently used chunks are removed.
+ *
+ * Format (all integers and doubles little-endian):
+ *  - "XOPPGEOM", u32 version, u32 content CRC-32, u64 content length, u64 stroke count
+ *  - for each stroke, in document order: u32 point count, u32 flags (1: pressure), then x y (z) for each point.
+ *    The coordinates are rounded to the precision of the XML, so both give the same document.
+ */
+class StrokeGeometryChunk {
+public:
+    /**
+     * Append the points of s (writing)
+     */
+    void addStroke(const Stroke& s);
+
+    /**
+     * Number of chunks kept in the cache directory
+     */
+    static constexpr size_t MAX_CACHED_CHUNKS = 16;
+
+    /**
+     * @return The directory of the cached chunks
+     */
+    static fs::path getCacheDir();
+
+    /**
+     * @return The path of the cached chunk of a gzipped document, empty if its gzip trailer cannot be read
+     */
+    static fs::path getCachePath(const fs::path& document, const fs::path& dir = getCacheDir());
+
+    /**
+     * Write the chunk of a gzipped document to the cache (writing)
+     * @param contentCrc, contentLength The CRC-32 and length of the content the chunk was written with
+     * @return false if the file could not be written
+     */
+    bool writeToCache(uint32_t contentCrc, uint64_t contentLength, const fs::path& dir = getCacheDir()) const;
+
+    /**
+     * @return The encoded chunk, without trailer
+     */
+    std::string encode(uint32_t contentCrc, uint64_t contentLength) const;
+
+    /**
+     * Read the chunk of a gzipped document from the cache
+     * @return nullopt if there is none, or if it is invalid
+     */
+    static std::optional<StrokeGeometryChunk> readFromCache(const fs::path& document,
+                                                            const fs::path& dir = getCacheDir());
+
+    /**
+     * @return nullopt if the data is not a valid chunk
+     */
+    static std::optional<StrokeGeometryChunk> decode(std::string data);
+
+    /**
+     * @return Whether the chunk was written along with a content of this CRC-32 and length (reading)
+     */
+    bool matches(uint32_t contentCrc, uint64_t contentLength) const;
+
+    size_t getStrokeCount() const;
+
+    /**
+     * Replace points with those of the stroke of the given index (reading)
+     * @return false if there is no such stroke
+     */
+    bool readStroke(size_t index, std::vector<Point>& points) const;
+
+private:
+    /**
+     * @return The name of the cached chunk of a content of this CRC-32 and length. Only the low 32 bits of the length
+     * are used, as in the gzip trailer.
+     */
+    static std::string getCacheName(uint32_t contentCrc, uint64_t contentLength);
+
+    /**
+     * Remove the least recently used chunks, so that at most MAX_CACHED_CHUNKS remain
+     */
+    static void evict(const fs::path& dir);
+
+private:
+    /**
+     * Stroke records (writing), or whole chunk (reading)
+     */
+    std::string data;
+
+    /**
+     * Offset of each stroke record in data (reading)
+     */
+    std::vector<size_t> strokeOffsets;
+
+    size_t strokeCount = 0;
+    uint32_t contentCrc = 0;
+    uint64_t contentLength = 0;
+};
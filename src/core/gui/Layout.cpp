@@ -58,56 +58,85 @@ void Layout::checkScroll(GtkAdjustment* adjustment, double& lastScroll) {
 void Layout::updateVisibility() {
     Rectangle visRect = getVisibleRect();
 
-    // step through every possible page position and update using p->setIsVisible()
-    // Using initial grid aprox speeds things up by a factor of 5.  See previous git check-in for specifics.
-    int x1 = 0;
-    int y1 = 0;
+    // Only the grid cells intersecting the visible rectangle are checked. Their range is found by binary search, so
+    // that scrolling does not depend on the number of pages.
+    auto const [firstRow, endRow] = visibleRange(this->rowYStart, visRect.y, visRect.y + visRect.height);
+    auto const [firstCol, endCol] = visibleRange(this->colXStart, visRect.x, visRect.x + visRect.width);
 
     // Data to select page based on visibility
     std::optional<size_t> mostPageNr;
     double mostPagePercent = 0;
 
-    for (size_t row = 0; row < this->rowYStart.size(); ++row) {
-        auto y2 = as_signed_strict(this->rowYStart[row]);
-        for (size_t col = 0; col < this->colXStart.size(); ++col) {
-            auto x2 = as_signed_strict(this->colXStart[col]);
+    // Position of the viewport in pages, for the prefetching: the page indices weighted by their visible fraction
+    double weightedPages = 0;
+    double weights = 0;
+
+    std::vector<size_t> nowVisible;
+    for (size_t row = firstRow; row < endRow; ++row) {
+        for (size_t col = firstCol; col < endCol; ++col) {
             auto optionalPage = this->mapper.at({col, row});
-            if (optionalPage)  // a page exists at this grid location
-            {
-                XojPageView* pageView = this->view->viewPages[*optionalPage];
-
-
-                // check if grid location is visible as an aprox for page visiblity:
-                if (!(visRect.x > x2 || visRect.x + visRect.width < x1)  // visrect not outside current row/col
-                    && !(visRect.y > y2 || visRect.y + visRect.height < y1)) {
-                    // now use exact check of page itself:
-                    // visrect not outside current page dimensions:
-                    auto const& pageRect = pageView->getRect();
-                    if (auto intersection = pageRect.intersects(visRect); intersection) {
-                        pageView->setIsVisible(true);
-                        // Set the selected page
-                        double percent = intersection->area() / pageRect.area();
-
-                        if (percent > mostPagePercent) {
-                            mostPageNr = *optionalPage;
-                            mostPagePercent = percent;
-                        }
-                    }
-                } else {
-                    pageView->setIsVisible(false);
+            if (!optionalPage) {
+                continue;
+            }
+            XojPageView* pageView = this->view->viewPages[*optionalPage];
+
+            // now use exact check of page itself:
+            auto const& pageRect = pageView->getRect();
+            if (auto intersection = pageRect.intersects(visRect); intersection) {
+                pageView->setIsVisible(true);
+                nowVisible.push_back(*optionalPage);
+                // Set the selected page
+                double percent = intersection->area() / pageRect.area();
+                weightedPages += percent * static_cast<double>(*optionalPage);
+                weights += percent;
+
+                if (percent > mostPagePercent) {
+                    mostPageNr = *optionalPage;
+                    mostPagePercent = percent;
                 }
             }
-            x1 = x2;
         }
-        y1 = y2;
-        x1 = 0;
     }
 
+    auto const isNowVisible = [&nowVisible](size_t page) {
+        return std::find(nowVisible.begin(), nowVisible.end(), page) != nowVisible.end();
+    };
+    auto const pageCount = this->view->viewPages.size();
+    if (this->visiblePagesStale) {
+        // The grid changed: the page indices of the last call are meaningless
+        for (size_t page = 0; page < pageCount; ++page) {
+            if (!isNowVisible(page)) {
+                this->view->viewPages[page]->setIsVisible(false);
+            }
+        }
+        this->visiblePagesStale = false;
+    } else {
+        for (size_t page: this->visiblePages) {
+            if (page < pageCount && !isNowVisible(page)) {
+                this->view->viewPages[page]->setIsVisible(false);
+            }
+        }
+    }
+    if (!nowVisible.empty() && weights > 0) {
+        auto const [firstVisible, lastVisible] = std::minmax_element(nowVisible.begin(), nowVisible.end());
+        this->view->prefetchPages(*firstVisible, *lastVisible, weightedPages / weights);
+    }
+    this->visiblePages = std::move(nowVisible);
+
     if (mostPageNr) {
         this->view->getControl()->firePageSelected(*mostPageNr);
     }
 }
 
+auto Layout::visibleRange(const std::vector<unsigned>& ends, double from, double to) -> std::pair<size_t, size_t> {
+    // The cell i spans [ends[i - 1], ends[i]] (the first one starts at 0)
+    auto first = std::lower_bound(ends.begin(), ends.end(), from);
+    auto last = std::upper_bound(first, ends.end(), to);
+    auto const firstIndex = size_t(std::distance(ends.begin(), first));
+    auto const endIndex = std::min(size_t(std::distance(ends.begin(), last)) + 1, ends.size());
+    return {firstIndex, std::max(firstIndex, endIndex)};
+}
+
 auto Layout::getVisibleRect() -> Rectangle<double> {
     return Rectangle(gtk_adjustment_get_value(scrollHandling->getHorizontal()),
                      gtk_adjustment_get_value(scrollHandling->getVertical()),
@@ -174,6 +203,7 @@ void Layout::recalculate() {
 
 void Layout::layoutPages(int width, int height) {
     std::lock_guard g{pc.m};
+    this->visiblePagesStale = true;
     if (!pc.valid) {
         recalculate_int();
     }
@@ -13,6 +13,7 @@
 
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include <gtk/gtk.h>
@@ -108,6 +109,14 @@ public:
      */
     void updateVisibility();
 
+    /**
+     * @brief Find the grid rows (or columns) intersecting the interval [from, to], in O(log n)
+     *
+     * @param ends The end coordinates of the rows (or columns), i.e. rowYStart (or colXStart)
+     * @return The half-open range of indices of the intersecting rows (or columns)
+     */
+    static std::pair<size_t, size_t> visibleRange(const std::vector<unsigned>& ends, double from, double to);
+
     /**
      * Return the pageview containing co-ordinates.
      */
@@ -175,4 +184,14 @@ private:
     mutable PreCalculated pc{};
     mutable std::vector<unsigned> colXStart;
     mutable std::vector<unsigned> rowYStart;
+
+    /**
+     * The pages set visible by the last call to updateVisibility()
+     */
+    std::vector<size_t> visiblePages;
+
+    /**
+     * Whether the pages were laid out again since the last call to updateVisibility()
+     */
+    bool visiblePagesStale = true;
 };
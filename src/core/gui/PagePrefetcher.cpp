@@ -0,0 +1,85 @@
+#include "PagePrefetcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+auto PagePrefetcher::update(double position, int64_t time) -> bool {
+    if (this->lastTime < 0) {
+        this->lastPosition = position;
+        this->lastTime = time;
+        return false;
+    }
+
+    int64_t dt = time - this->lastTime;
+    if (dt <= 0) {
+        // Keep the previous sample: the next one will measure the whole displacement
+        return false;
+    }
+
+    if (dt > IDLE_TIME) {
+        // A new gesture: the previous velocity says nothing about this one
+        this->velocity = 0;
+    }
+
+    double current = (position - this->lastPosition) * 1e6 / static_cast<double>(dt);
+    double alpha = 1 - std::exp(-static_cast<double>(dt) / VELOCITY_TIME_CONSTANT);
+    this->velocity += alpha * (current - this->velocity);
+
+    this->lastPosition = position;
+    this->lastTime = time;
+
+    if (this->velocity >= MIN_VELOCITY) {
+        this->direction = Direction::FORWARD;
+    } else if (this->velocity <= -MIN_VELOCITY) {
+        this->direction = Direction::BACKWARD;
+    } else {
+        this->direction = Direction::NONE;
+        return false;
+    }
+
+    bool reversed = this->lastDirection != Direction::NONE && this->lastDirection != this->direction;
+    this->lastDirection = this->direction;
+    return reversed;
+}
+
+void PagePrefetcher::reset() {
+    this->lastTime = -1;
+    this->velocity = 0;
+    this->direction = Direction::NONE;
+    this->lastDirection = Direction::NONE;
+}
+
+auto PagePrefetcher::getVelocity() const -> double { return this->velocity; }
+
+auto PagePrefetcher::getDirection() const -> Direction { return this->direction; }
+
+auto PagePrefetcher::getPagesAhead(size_t pageBytes) const -> size_t {
+    if (this->direction == Direction::NONE) {
+        return 0;
+    }
+
+    auto pages = static_cast<size_t>(std::ceil(std::abs(this->velocity) * LOOKAHEAD_TIME));
+    pages = std::clamp<size_t>(pages, 1, MAX_PAGES_AHEAD);
+
+    if (pageBytes > 0) {
+        pages = std::min(pages, this->memoryBudget / pageBytes);
+    }
+    return pages;
+}
+
+auto PagePrefetcher::getRange(size_t firstVisible, size_t lastVisible, size_t pageCount, size_t pageBytes) const
+        -> std::pair<size_t, size_t> {
+    size_t pages = getPagesAhead(pageBytes);
+
+    if (this->direction == Direction::FORWARD) {
+        size_t first = std::min(lastVisible + 1, pageCount);
+        return {first, std::min(first + pages, pageCount)};
+    }
+    if (this->direction == Direction::BACKWARD) {
+        size_t end = std::min(firstVisible, pageCount);
+        return {end - std::min(pages, end), end};
+    }
+    return {0, 0};
+}
+
+void PagePrefetcher::setMemoryBudget(size_t bytes) { this->memoryBudget = bytes; }
@@ -0,0 +1,103 @@
+/*
+ * Xournal++
+ *
+ * Chooses the pages to render ahead of the viewport while scrolling
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+/**
+ * @brief Estimates the scroll velocity from the successive viewport positions and derives the range of pages which
+ * should be rendered before they become visible.
+ *
+ * Positions are measured in pages along the page order (e.g. 3.5 is halfway between the pages 3 and 4), so that the
+ * estimation does not depend on the zoom, the page sizes nor the layout of the pages.
+ */
+class PagePrefetcher {
+public:
+    enum class Direction { NONE, FORWARD, BACKWARD };
+
+    /**
+     * Time constant of the exponential smoothing of the velocity, in microseconds
+     */
+    static constexpr double VELOCITY_TIME_CONSTANT = 100000;
+
+    /**
+     * Samples further apart than this (in microseconds) belong to different scroll gestures
+     */
+    static constexpr int64_t IDLE_TIME = 250000;
+
+    /**
+     * Below this velocity (in pages per second) the view is considered to be standing still
+     */
+    static constexpr double MIN_VELOCITY = 0.5;
+
+    /**
+     * The pages which will become visible within this time (in seconds) are prefetched
+     */
+    static constexpr double LOOKAHEAD_TIME = 1.0;
+
+    static constexpr size_t MAX_PAGES_AHEAD = 8;
+
+    /**
+     * Default upper bound of the memory used by the buffers of prefetched pages, in bytes
+     */
+    static constexpr size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
+public:
+    /**
+     * Records the viewport position at the given (monotonic) time in microseconds.
+     *
+     * @return true if the scroll direction was reversed: pages prefetched before are no longer ahead of the viewport
+     */
+    bool update(double position, int64_t time);
+
+    /**
+     * Forgets the scroll history, e.g. after a jump to another page
+     */
+    void reset();
+
+    /**
+     * @return The smoothed velocity in pages per second, positive towards the end of the document
+     */
+    double getVelocity() const;
+
+    Direction getDirection() const;
+
+    /**
+     * @return The number of pages to prefetch, given the memory a rendered page buffer takes
+     */
+    size_t getPagesAhead(size_t pageBytes) const;
+
+    /**
+     * @return The range [first, end) of pages to prefetch, next to the visible pages [firstVisible, lastVisible] in the
+     * scroll direction. It is empty when the view is standing still.
+     */
+    std::pair<size_t, size_t> getRange(size_t firstVisible, size_t lastVisible, size_t pageCount,
+                                       size_t pageBytes) const;
+
+    void setMemoryBudget(size_t bytes);
+
+private:
+    double lastPosition = 0;
+    int64_t lastTime = -1;
+
+    double velocity = 0;
+    Direction direction = Direction::NONE;
+
+    /**
+     * The last direction which was not NONE, to detect reversals across short stops
+     */
+    Direction lastDirection = Direction::NONE;
+
+    size_t memoryBudget = DEFAULT_MEMORY_BUDGET;
+};
@@ -175,6 +175,8 @@ void XojPageView::endText() {
             // after endText() so we need to instead copy the information between an
             // old and new element that we can push and pop to recover.
             undo->addUndoAction(std::make_unique<TextBoxUndoAction>(page, layer, txt, this->oldtext));
+            // The text was edited on the layer
+            layer->updateElementIndex(txt);
         }
     }
 
@@ -685,6 +687,11 @@ void XojPageView::rerenderPage() {
     this->xournal->getControl()->getScheduler()->addRerenderPage(this);
 }
 
+void XojPageView::prefetchPage() {
+    this->rerenderComplete = true;
+    this->xournal->getControl()->getScheduler()->addPrefetchPage(this);
+}
+
 void XojPageView::repaintPage() { xournal->getRepaintHandler()->repaintPage(this); }
 
 void XojPageView::repaintArea(double x1, double y1, double x2, double y2) {
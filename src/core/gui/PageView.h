@@ -47,6 +47,11 @@ public:
     void updatePageSize(double width, double height);
 
     void rerenderPage() override;
+
+    /**
+     * Renders the page in the background before it becomes visible
+     */
+    void prefetchPage();
     void rerenderRect(double x, double y, double width, double height) override;
 
     void repaintPage() override;
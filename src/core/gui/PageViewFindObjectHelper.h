@@ -13,10 +13,13 @@
 
 // No include needed, this is included after PageView.h
 
+#include <cmath>
 #include <limits>
 #include <optional>
+#include <vector>
 
 #include "audio/AudioPlayer.h"
+#include "model/ElementIndex.h"
 #include "util/PathUtil.h"
 
 #include "XournalView.h"
@@ -36,32 +39,29 @@ public:
         // clear old selection anyway
         view->xournal->getControl()->clearSelection();
 
-        Layer* layer = this->view->getPage()->getSelectedLayer();
-        return checkLayer(layer);
+        return checkElements();
     }
 
 protected:
-    bool checkLayer(Layer* l) {
-        /* Search for Element whose bounding box center is closest to the place (x,y) where the object is searched for.
-         * Only those strokes are taken into account that pass the appropriate checkElement test.
+    /**
+     * Only the elements whose bounding box intersects the square of side 2 * MATCH_SIZE centered on the searched place
+     * are taken into account
+     */
+    static constexpr int MATCH_SIZE = 10;
+
+    bool checkElements() { return findNearest(this->view->getPage()->getSelectedLayer()->getElementIndex()); }
+
+    bool findNearest(const ElementIndex& index) {
+        /* Search for the Element closest to the place (x,y) where the object is searched for, see
+         * ElementIndex::findNearest(). Only those elements are taken into account that pass the appropriate
+         * checkElement test.
          */
-        bool found = false;
-        double minDistSq = std::numeric_limits<double>::max();
-        for (Element* e: l->getElements()) {
-            const double eX = e->getX() + e->getElementWidth() / 2.0;
-            const double eY = e->getY() + e->getElementHeight() / 2.0;
-            const double dx = eX - this->x;
-            const double dy = eY - this->y;
-            const double distSq = dx * dx + dy * dy;
-            const GdkRectangle matchRect = {gint(x - 10), gint(y - 10), 20, 20};
-            if (e->intersectsArea(&matchRect) && distSq < minDistSq) {
-                if (this->checkElement(e)) {
-                    minDistSq = distSq;
-                    found = true;
-                }
-            }
-        }
-        return found;
+        const GdkRectangle matchRect = {gint(x - MATCH_SIZE), gint(y - MATCH_SIZE), 2 * MATCH_SIZE, 2 * MATCH_SIZE};
+        // Farther than the corners of the square, even with the rounding to integers, no box can intersect it
+        const double maxDistance = std::sqrt(2.0) * (MATCH_SIZE + 2);
+        return index.findNearest(x, y, maxDistance, [this, &matchRect](Element* e) {
+                   return e->intersectsArea(&matchRect) && this->checkElement(e);
+               }) != nullptr;
     }
 
     virtual bool checkElement(Element* e) = 0;
@@ -74,16 +74,16 @@ protected:
 
 class SelectObject: public BaseSelectObject {
 public:
-    SelectObject(XojPageView* view):
-            BaseSelectObject(view), strokeMatch(nullptr), elementMatch(nullptr), gap(1000000000) {}
+    SelectObject(XojPageView* view): BaseSelectObject(view) {}
 
     ~SelectObject() override = default;
 
     bool at(double x, double y) override {
-        BaseSelectObject::at(x, y);
-
-        if (strokeMatch) {
-            elementMatch = strokeMatch;
+        // Strokes are preferred over the other elements
+        this->strokesOnly = true;
+        if (!BaseSelectObject::at(x, y)) {
+            this->strokesOnly = false;
+            checkElements();
         }
 
         if (elementMatch) {
@@ -102,13 +102,12 @@ protected:
     bool checkElement(Element* e) override {
         if (e->getType() == ELEMENT_STROKE) {
             Stroke* s = (Stroke*)e;
-            double tmpGap = 0;
-            if ((s->intersects(x, y, 5, &tmpGap)) && (gap > tmpGap)) {
-                gap = tmpGap;
-                strokeMatch = s;
+            double gap = 0;
+            if (strokesOnly && s->intersects(x, y, 5, &gap)) {
+                elementMatch = s;
                 return true;
             }
-        } else {
+        } else if (!strokesOnly) {
             elementMatch = e;
             return true;
         }
@@ -117,9 +116,8 @@ protected:
     }
 
 private:
-    Stroke* strokeMatch;
-    Element* elementMatch;
-    double gap;
+    bool strokesOnly = true;
+    Element* elementMatch = nullptr;
 };
 
 class PlayObject: public BaseSelectObject {
@@ -136,7 +134,24 @@ public:
     std::optional<Status> playbackStatus;
 
 public:
-    bool at(double x, double y) override { return BaseSelectObject::at(x, y); }
+    bool at(double x, double y) override {
+        this->x = x;
+        this->y = y;
+
+        // clear old selection anyway
+        view->xournal->getControl()->clearSelection();
+
+        // Only look at the audio enabled elements of the layer, from the audio index
+        auto* ac = view->xournal->getControl()->getAudioController();
+        Layer* layer = view->getPage()->getSelectedLayer();
+        std::vector<Element*> elements;
+        for (auto&& entry: ac->getAudioEntries(view->getPage())) {
+            if (entry.layer == layer) {
+                elements.push_back(entry.element);
+            }
+        }
+        return findNearest(ElementIndex(elements));
+    }
 
 protected:
     bool checkElement(Element* e) override {
@@ -146,7 +161,7 @@ protected:
 
         AudioElement* s = (AudioElement*)e;
         double tmpGap = 0;
-        if ((s->intersects(x, y, 15, &tmpGap))) {
+        if (!s->getAudioFilename().empty() && s->intersects(x, y, 15, &tmpGap)) {
             size_t ts = s->getTimestamp();
 
             if (auto fn = s->getAudioFilename(); !fn.empty()) {
@@ -50,6 +50,11 @@ auto SearchBar::searchTextonCurrentPage(const char* text, int* occures, double*
     return control->searchTextOnPage(text, p, occures, top);
 }
 
+auto SearchBar::mayContainText(size_t page, const std::string& text) -> bool {
+    auto count = control->getSearchIndex()->countMatches(page, text);
+    return !count || *count > 0;
+}
+
 void SearchBar::search(const char* text) {
     MainWindow* win = control->getWindow();
     GtkWidget* lbSearchState = win->get("lbSearchState");
@@ -59,17 +64,28 @@ void SearchBar::search(const char* text) {
 
     if (*text != 0) {
         found = searchTextonCurrentPage(text, &occures, nullptr);
+        std::string msg;
         if (found) {
             if (occures == 1) {
-                gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text found on this page"));
+                msg = _("Text found on this page");
             } else {
-                char* msg = g_strdup_printf(_("Text %i times found on this page"), occures);
-                gtk_label_set_text(GTK_LABEL(lbSearchState), msg);
-                g_free(msg);
+                char* pageMsg = g_strdup_printf(_("Text %i times found on this page"), occures);
+                msg = pageMsg;
+                g_free(pageMsg);
             }
         } else {
-            gtk_label_set_text(GTK_LABEL(lbSearchState), _("Text not found"));
+            msg = _("Text not found on this page");
+        }
+
+        if (auto total = control->getSearchIndex()->countInDocument(text); total && *total > 0) {
+            msg += "; ";
+            msg += FS(PlaceholderString(ngettext("{1} match in the document", "{1} matches in the document", *total)) %
+                      *total);
+            found = true;
+        } else if (!found) {
+            msg = _("Text not found");
         }
+        gtk_label_set_text(GTK_LABEL(lbSearchState), msg.c_str());
     } else {
         searchTextonCurrentPage("", nullptr, nullptr);
         gtk_label_set_text(GTK_LABEL(lbSearchState), "");
@@ -115,7 +131,8 @@ void SearchBar::searchNext() {
 
     while (x != page) {
 
-        bool found = control->searchTextOnPage(text, x, &occures, &top);
+        // The index tells which pages can be skipped without searching them
+        bool found = mayContainText(x, text) && control->searchTextOnPage(text, x, &occures, &top);
         if (found) {
             control->getScrollHandler()->scrollToPage(x, top);
             gtk_label_set_text(GTK_LABEL(lbSearchState),
@@ -159,7 +176,8 @@ void SearchBar::searchPrevious() {
 
     while (x != page) {
 
-        bool found = control->searchTextOnPage(text, x, &occures, &top);
+        // The index tells which pages can be skipped without searching them
+        bool found = mayContainText(x, text) && control->searchTextOnPage(text, x, &occures, &top);
         if (found) {
             control->getScrollHandler()->scrollToPage(x, top);
             gtk_label_set_text(GTK_LABEL(lbSearchState),
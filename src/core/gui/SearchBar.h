@@ -39,6 +39,11 @@ private:
     void search(const char* text);
     bool searchTextonCurrentPage(const char* text, int* occures, double* top);
 
+    /**
+     * @return Whether the page may contain the text: false only if the search index knows it does not
+     */
+    bool mayContainText(size_t page, const std::string& text);
+
 private:
     Control* control;
     GtkCssProvider* cssTextFild;
@@ -18,8 +18,10 @@
 #include "undo/DeleteUndoAction.h"
 #include "util/Rectangle.h"
 #include "util/Util.h"
+#include "view/TexImageCache.h"
 
 #include "Layout.h"
+#include "PagePrefetcher.h"
 #include "PageView.h"
 #include "RepaintHandler.h"
 #include "Shadow.h"
@@ -36,8 +38,34 @@ std::pair<size_t, size_t> XournalView::preloadPageBounds(size_t page, size_t max
     return {lower, upper};
 }
 
+void XournalView::prefetchPages(size_t firstVisible, size_t lastVisible, double position) {
+    XournalScheduler* scheduler = this->control->getScheduler();
+    if (this->prefetcher->update(position, g_get_monotonic_time())) {
+        // The pages queued while scrolling the other way are behind the viewport now
+        scheduler->removePrefetchJobs();
+    }
+
+    const XojPageView* reference = this->viewPages[lastVisible];
+    const auto scale = static_cast<size_t>(getDpiScaleFactor());
+    const size_t pageBytes = 4 * static_cast<size_t>(reference->getDisplayWidth()) *
+                             static_cast<size_t>(reference->getDisplayHeight()) * scale * scale;
+    this->prefetchRange = this->prefetcher->getRange(firstVisible, lastVisible, this->viewPages.size(), pageBytes);
+
+    for (size_t i = this->prefetchRange.first; i < this->prefetchRange.second; i++) {
+        XojPageView* page = this->viewPages[i];
+        if (page->getBufferPixels() == 0) {
+            // Lets cleanupBufferCache() reclaim the buffer if the page is not reached after all
+            page->setIsVisible(false);
+            page->prefetchPage();
+        }
+    }
+}
+
 XournalView::XournalView(GtkWidget* parent, Control* control, ScrollHandling* scrollHandling):
-        scrollHandling(scrollHandling), control(control) {
+        scrollHandling(scrollHandling),
+        control(control),
+        texImageCache(std::make_unique<xoj::view::TexImageCache>()),
+        prefetcher(std::make_unique<PagePrefetcher>()) {
     Document* doc = control->getDocument();
     doc->lock();
     if (doc->getPdfPageCount() != 0) {
@@ -108,7 +136,8 @@ auto XournalView::cleanupBufferCache() -> void {
         auto&& page = this->viewPages[i];
         const size_t pageNum = i + 1;
         const bool isPreload = pagesLower <= pageNum && pageNum <= pagesUpper;
-        if (!isPreload && page->getLastVisibleTime() > 0 && page->getBufferPixels() > 0) {
+        const bool isPrefetched = this->prefetchRange.first <= i && i < this->prefetchRange.second;
+        if (!isPreload && !isPrefetched && page->getLastVisibleTime() > 0 && page->getBufferPixels() > 0) {
             page->deleteViewBuffer();
         }
     }
@@ -385,6 +414,9 @@ void XournalView::scrollTo(size_t pageNo, double yDocument) {
 
     XojPageView* v = this->viewPages[pageNo];
 
+    // A jump is no scroll gesture to extrapolate
+    this->prefetcher->reset();
+
     // Make sure it is visible
     Layout* layout = gtk_xournal_get_layout(this->widget);
 
@@ -554,6 +586,8 @@ auto XournalView::getTextEditor() -> TextEditor* {
 
 auto XournalView::getCache() -> PdfCache* { return this->cache.get(); }
 
+auto XournalView::getTexImageCache() -> xoj::view::TexImageCache* { return this->texImageCache.get(); }
+
 void XournalView::pageInserted(size_t page) {
     Document* doc = control->getDocument();
     doc->lock();
@@ -727,6 +761,7 @@ void XournalView::documentChanged(DocumentChangeType type) {
     viewPages.clear();
 
     this->cache.reset();
+    this->texImageCache = std::make_unique<xoj::view::TexImageCache>();
 
     Document* doc = control->getDocument();
     doc->lock();
@@ -30,6 +30,10 @@ class RepaintHandler;
 class ScrollHandling;
 class TextEditor;
 class HandRecognition;
+class PagePrefetcher;
+namespace xoj::view {
+class TexImageCache;
+};
 
 class XournalView: public DocumentListener, public ZoomListener {
 public:
@@ -98,6 +102,7 @@ public:
     int getDpiScaleFactor();
     Document* getDocument();
     PdfCache* getCache();
+    xoj::view::TexImageCache* getTexImageCache();
     RepaintHandler* getRepaintHandler();
     GtkWidget* getWidget();
     XournalppCursor* getCursor();
@@ -147,6 +152,13 @@ private:
 
     std::pair<size_t, size_t> preloadPageBounds(size_t page, size_t maxPage);
 
+    /**
+     * Queues the rendering of the pages ahead of the visible pages [firstVisible, lastVisible] in the scroll direction.
+     *
+     * @param position The position of the viewport in pages, see PagePrefetcher
+     */
+    void prefetchPages(size_t firstVisible, size_t lastVisible, double position);
+
     xoj::util::Rectangle<double>* getVisibleRect(size_t page);
 
     static gboolean clearMemoryTimer(XournalView* widget);
@@ -173,6 +185,18 @@ private:
 
     std::unique_ptr<PdfCache> cache;
 
+    /**
+     * Rasters of the LaTeX elements of the document
+     */
+    std::unique_ptr<xoj::view::TexImageCache> texImageCache;
+
+    std::unique_ptr<PagePrefetcher> prefetcher;
+
+    /**
+     * The pages [first, end) last queued by prefetchPages(). Their buffers are kept by the memory cleanup.
+     */
+    std::pair<size_t, size_t> prefetchRange{0, 0};
+
     /**
      * Handler for rerendering pages / repainting pages
      */
@@ -2,6 +2,7 @@
 
 #include "control/Control.h"
 #include "control/PdfCache.h"
+#include "control/ThumbnailCache.h"
 
 #include "SidebarLayout.h"
 #include "SidebarPreviewBaseEntry.h"
@@ -74,6 +75,8 @@ auto SidebarPreviewBase::getZoom() const -> double { return this->zoom; }
 
 auto SidebarPreviewBase::getCache() -> PdfCache* { return this->cache.get(); }
 
+auto SidebarPreviewBase::getThumbnailCache() -> ThumbnailCache* { return this->thumbnailCache.get(); }
+
 void SidebarPreviewBase::layout() { SidebarLayout::layout(this); }
 
 auto SidebarPreviewBase::hasData() -> bool { return true; }
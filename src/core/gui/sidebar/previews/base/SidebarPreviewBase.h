@@ -25,6 +25,7 @@ class PdfCache;
 class SidebarLayout;
 class SidebarPreviewBaseEntry;
 class SidebarToolbar;
+class ThumbnailCache;
 
 class SidebarPreviewBase: public AbstractSidebarPage {
 public:
@@ -65,6 +66,11 @@ public:
      */
     PdfCache* getCache();
 
+    /**
+     * Gets the on-disk cache of the page previews, nullptr if the previews are not cached
+     */
+    ThumbnailCache* getThumbnailCache();
+
 public:
     // DocumentListener interface (only the part handled by SidebarPreviewBase)
     void documentChanged(DocumentChangeType type) override;
@@ -112,6 +118,11 @@ private:
 
     // Members also used by subclasses
 protected:
+    /**
+     * For the previews of whole pages, set by the subclass showing them
+     */
+    std::unique_ptr<ThumbnailCache> thumbnailCache;
+
     /**
      * The currently selected entry in the sidebar, starting from 0
      * -1 means no valid selection
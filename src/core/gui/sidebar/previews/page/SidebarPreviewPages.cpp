@@ -4,9 +4,11 @@
 
 #include "control/Control.h"
 #include "control/PdfCache.h"
+#include "control/ThumbnailCache.h"
 #include "gui/sidebar/previews/base/SidebarToolbar.h"
 #include "undo/CopyUndoAction.h"
 #include "undo/SwapUndoAction.h"
+#include "util/PathUtil.h"
 #include "util/i18n.h"
 
 #include "SidebarPreviewPageEntry.h"
@@ -48,6 +50,8 @@ SidebarPreviewPages::SidebarPreviewPages(Control* control, GladeGui* gui, Sideba
     }
     g_assert(this->contextMenuMoveDown != nullptr);
     g_assert(this->contextMenuMoveUp != nullptr);
+
+    this->thumbnailCache = std::make_unique<ThumbnailCache>(Util::getCacheSubfolder("thumbnails"));
 }
 
 SidebarPreviewPages::~SidebarPreviewPages() {
@@ -0,0 +1,31 @@
+#include "AudioIndex.h"
+
+#include "AudioElement.h"
+#include "Layer.h"
+#include "XojPage.h"
+
+auto AudioIndex::getPageEntries(const PageRef& page) -> const std::vector<Entry>& {
+    auto& indexed = this->pages[page.get()];
+    if (indexed.page.lock() == page) {
+        return indexed.entries;
+    }
+
+    indexed.page = page;
+    indexed.entries.clear();
+    for (Layer* layer: *page->getLayers()) {
+        for (Element* e: layer->getElements()) {
+            if (e->getType() != ELEMENT_STROKE && e->getType() != ELEMENT_TEXT) {
+                continue;
+            }
+            auto* audioElement = static_cast<AudioElement*>(e);
+            if (!audioElement->getAudioFilename().empty()) {
+                indexed.entries.push_back({audioElement, layer});
+            }
+        }
+    }
+    return indexed.entries;
+}
+
+void AudioIndex::invalidatePage(const PageRef& page) { this->pages.erase(page.get()); }
+
+void AudioIndex::clear() { this->pages.clear(); }
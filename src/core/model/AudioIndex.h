@@ -0,0 +1,59 @@
+/*
+ * Xournal++
+ *
+ * Index of the audio enabled elements of the pages of a document
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "PageRef.h"
+
+class AudioElement;
+class Layer;
+
+/**
+ * @brief Maps the pages to their audio enabled elements.
+ *
+ * A page is indexed the first time it is looked up. The index holds pointers to the elements of the page: it must be
+ * told about every change of the page with invalidatePage().
+ */
+class AudioIndex {
+public:
+    struct Entry {
+        AudioElement* element;
+        Layer* layer;
+    };
+
+    /**
+     * @return The strokes and texts of the page which have an audio recording, indexed if the page was not yet
+     * The document must be locked
+     */
+    const std::vector<Entry>& getPageEntries(const PageRef& page);
+
+    /**
+     * Drop the entries of the page, it will be indexed again on the next lookup
+     */
+    void invalidatePage(const PageRef& page);
+
+    void clear();
+
+private:
+    struct PageEntries {
+        /**
+         * To tell a new page allocated at the address of a deleted one
+         */
+        std::weak_ptr<XojPage> page;
+        std::vector<Entry> entries;
+    };
+
+    std::unordered_map<const XojPage*, PageEntries> pages;
+};
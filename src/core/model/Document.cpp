@@ -73,6 +73,10 @@ void Document::unlock() {
 */
 auto Document::tryLock() -> bool { return this->documentLock.try_lock(); }
 
+void Document::lockShared() { this->documentLock.lock_shared(); }
+
+void Document::unlockShared() { this->documentLock.unlock_shared(); }
+
 void Document::clearDocument(bool destroy) {
     if (this->preview) {
         cairo_surface_destroy(this->preview);
@@ -280,14 +284,13 @@ void Document::updateIndexPageNumbers() {
     }
 }
 
-auto Document::readPdf(const fs::path& filename, bool initPages, bool attachToDocument, gpointer data, gsize length)
-        -> bool {
+auto Document::readPdf(const fs::path& filename, bool initPages, bool attachToDocument, GBytes* data) -> bool {
     GError* popplerError = nullptr;
 
     lock();
 
     if (data != nullptr) {
-        if (!pdfDocument.load(data, length, password, &popplerError)) {
+        if (!pdfDocument.load(data, password, &popplerError)) {
             lastError = FS(_F("Document not loaded! ({1}), {2}") % filename.u8string() % popplerError->message);
             g_error_free(popplerError);
             unlock();
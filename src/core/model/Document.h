@@ -15,6 +15,7 @@
 
 #include <memory>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -36,8 +37,10 @@ public:
 public:
     enum DocumentType { XOPP, XOJ, PDF };
 
-    bool readPdf(const fs::path& filename, bool initPages, bool attachToDocument, gpointer data = nullptr,
-                 gsize length = 0);
+    /**
+     * @param data The PDF, if it is not read from the file. It is referenced as long as the PDF is loaded.
+     */
+    bool readPdf(const fs::path& filename, bool initPages, bool attachToDocument, GBytes* data = nullptr);
 
     size_t getPageCount() const;
     size_t getPdfPageCount() const;
@@ -90,6 +93,13 @@ public:
     void unlock();
     bool tryLock();
 
+    /**
+     * Locks the document for reading only: any number of readers (e.g. the rendering and the plugins reading the
+     * content) may hold the lock at the same time, but no writer.
+     */
+    void lockShared();
+    void unlockShared();
+
 private:
     void buildContentsModel();
     void freeTreeContentModel();
@@ -155,7 +165,7 @@ private:
     /**
      * The lock of the document
      */
-    std::mutex documentLock;
+    std::shared_mutex documentLock;
 };
 
 template <class InputIter>
@@ -1,6 +1,9 @@
 #include "Element.h"
 
+#include <array>
 #include <cmath>
+#include <functional>
+#include <mutex>
 
 #include "util/serializing/ObjectInputStream.h"
 #include "util/serializing/ObjectOutputStream.h"
@@ -9,8 +12,47 @@ using xoj::util::Rectangle;
 
 Element::Element(ElementType type): type(type) {}
 
+Element::Element(const Element& other):
+        Serializable(other),
+        sizeCalculated(other.sizeCalculated.load()),
+        width(other.width),
+        height(other.height),
+        x(other.x),
+        y(other.y),
+        snappedBounds(other.snappedBounds),
+        type(other.type),
+        color(other.color) {}
+
+auto Element::operator=(const Element& other) -> Element& {
+    Serializable::operator=(other);
+    this->sizeCalculated = other.sizeCalculated.load();
+    this->width = other.width;
+    this->height = other.height;
+    this->x = other.x;
+    this->y = other.y;
+    this->snappedBounds = other.snappedBounds;
+    this->type = other.type;
+    this->color = other.color;
+    return *this;
+}
+
 Element::~Element() = default;
 
+void Element::ensureSizeCalculated() const {
+    if (this->sizeCalculated.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    // Readers holding the shared document lock may get here concurrently. The elements are spread over a few mutexes
+    // rather than each having its own.
+    static std::array<std::mutex, 64> sizeMutexes;
+    std::lock_guard<std::mutex> lock(sizeMutexes[std::hash<const Element*>()(this) % sizeMutexes.size()]);
+    if (!this->sizeCalculated.load(std::memory_order_relaxed)) {
+        calcSize();
+        this->sizeCalculated.store(true, std::memory_order_release);
+    }
+}
+
 auto Element::getType() const -> ElementType { return this->type; }
 
 void Element::setX(double x) {
@@ -24,25 +66,16 @@ void Element::setY(double y) {
 }
 
 auto Element::getX() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return x;
 }
 
 auto Element::getY() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return y;
 }
 auto Element::getSnappedBounds() const -> Rectangle<double> {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return this->snappedBounds;
 }
 
@@ -53,18 +86,12 @@ void Element::move(double dx, double dy) {
 }
 
 auto Element::getElementWidth() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return this->width;
 }
 
 auto Element::getElementHeight() const -> double {
-    if (!this->sizeCalculated) {
-        this->sizeCalculated = true;
-        calcSize();
-    }
+    ensureSizeCalculated();
     return this->height;
 }
 
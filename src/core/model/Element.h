@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 #include <vector>
 
@@ -26,12 +27,19 @@ class ShapeContainer {
 public:
     virtual bool contains(double x, double y) = 0;
 
+    /**
+     * @return Whether the whole (closed) rectangle is inside the shape. May return false if this is not cheap to tell.
+     */
+    virtual bool containsRectangle(const xoj::util::Rectangle<double>& rect) { return false; }
+
     virtual ~ShapeContainer() = default;
 };
 
 class Element: public Serializable {
 protected:
     Element(ElementType type);
+    Element(const Element& other);
+    Element& operator=(const Element& other);
 
 public:
     ~Element() override;
@@ -78,12 +86,17 @@ public:
     void readSerialized(ObjectInputStream& in) override;
 
 private:
+    /**
+     * Calls calcSize() once after every change, also when several threads read the element at the same time
+     */
+    void ensureSizeCalculated() const;
+
 protected:
     virtual void calcSize() const = 0;
 
 protected:
     // If the size has been calculated
-    mutable bool sizeCalculated = false;
+    mutable std::atomic<bool> sizeCalculated{false};
 
     mutable double width = 0;
     mutable double height = 0;
@@ -0,0 +1,159 @@
+#include "ElementIndex.h"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+
+#include "Element.h"
+
+using xoj::util::Rectangle;
+
+static auto boundingBox(Element* e) -> Rectangle<double> {
+    return Rectangle<double>(e->getX(), e->getY(), e->getElementWidth(), e->getElementHeight());
+}
+
+ElementIndex::ElementIndex(const std::vector<Element*>& elements) {
+    if (elements.empty()) {
+        return;
+    }
+
+    this->entries.reserve(elements.size());
+    for (Element* e: elements) { this->entries.push_back({e, boundingBox(e)}); }
+
+    auto centerX = [](const Entry& e) { return e.box.x + e.box.width / 2; };
+    auto centerY = [](const Entry& e) { return e.box.y + e.box.height / 2; };
+
+    // Sort-tile-recursive: vertical slices of about sqrt(leafCount) leaves each, sorted by y inside
+    const size_t leafCount = (this->entries.size() + NODE_SIZE - 1) / NODE_SIZE;
+    const auto sliceCount = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(leafCount))));
+    const size_t sliceSize = ((leafCount + sliceCount - 1) / sliceCount) * NODE_SIZE;
+    std::sort(this->entries.begin(), this->entries.end(),
+              [&](const Entry& a, const Entry& b) { return centerX(a) < centerX(b); });
+    for (size_t first = 0; first < this->entries.size(); first += sliceSize) {
+        auto begin = this->entries.begin() + static_cast<std::ptrdiff_t>(first);
+        auto end = this->entries.begin() +
+                   static_cast<std::ptrdiff_t>(std::min(first + sliceSize, this->entries.size()));
+        std::sort(begin, end, [&](const Entry& a, const Entry& b) { return centerY(a) < centerY(b); });
+    }
+
+    std::vector<Rectangle<double>> leaves;
+    leaves.reserve(leafCount);
+    for (size_t first = 0; first < this->entries.size(); first += NODE_SIZE) {
+        Rectangle<double> box = this->entries[first].box;
+        for (size_t i = first + 1; i < std::min(first + NODE_SIZE, this->entries.size()); i++) {
+            box.unite(this->entries[i].box);
+        }
+        leaves.push_back(box);
+    }
+    this->levels.push_back(std::move(leaves));
+
+    // The nodes of a level are spatially sorted already: consecutive ones are grouped
+    while (this->levels.back().size() > 1) {
+        const auto& children = this->levels.back();
+        std::vector<Rectangle<double>> parents;
+        parents.reserve((children.size() + NODE_SIZE - 1) / NODE_SIZE);
+        for (size_t first = 0; first < children.size(); first += NODE_SIZE) {
+            Rectangle<double> box = children[first];
+            for (size_t i = first + 1; i < std::min(first + NODE_SIZE, children.size()); i++) {
+                box.unite(children[i]);
+            }
+            parents.push_back(box);
+        }
+        this->levels.push_back(std::move(parents));
+    }
+
+    this->positions.reserve(this->entries.size());
+    for (size_t i = 0; i < this->entries.size(); i++) { this->positions.emplace(this->entries[i].element, i); }
+}
+
+void ElementIndex::insert(Element* e) { this->inserted.push_back({e, boundingBox(e)}); }
+
+void ElementIndex::remove(Element* e) {
+    if (auto it = this->positions.find(e); it != this->positions.end()) {
+        // The boxes of the nodes are not shrunk: they still contain all the remaining entries
+        this->entries[it->second].element = nullptr;
+        this->positions.erase(it);
+        this->removedCount++;
+        return;
+    }
+    auto it = std::find_if(this->inserted.begin(), this->inserted.end(),
+                           [e](const Entry& entry) { return entry.element == e; });
+    if (it != this->inserted.end()) {
+        this->inserted.erase(it);
+    }
+}
+
+auto ElementIndex::needsRebuild() const -> bool {
+    // The inserted elements are all tested by every query
+    return this->inserted.size() > std::max(NODE_SIZE, this->entries.size() / 4) ||
+           this->removedCount > this->entries.size() / 2;
+}
+
+auto ElementIndex::distance(const Rectangle<double>& rect, double x, double y) -> double {
+    double dx = std::max({rect.x - x, 0.0, x - (rect.x + rect.width)});
+    double dy = std::max({rect.y - y, 0.0, y - (rect.y + rect.height)});
+    return std::hypot(dx, dy);
+}
+
+auto ElementIndex::findNearest(double x, double y, double maxDistance,
+                               const std::function<bool(Element*)>& accept) const -> Element* {
+    struct Candidate {
+        double distance;
+        /**
+         * Distance to the center of the box, to break ties. -1 for nodes, so that they are expanded before the
+         * elements at the same distance, which they may contain.
+         */
+        double centerDistance;
+        size_t level;  ///< Level of the node, or levels.size() for an element
+        size_t index;  ///< In entries, or entries.size() + the index in inserted for an element not in the tree
+
+        bool operator>(const Candidate& other) const {
+            return distance != other.distance ? distance > other.distance : centerDistance > other.centerDistance;
+        }
+    };
+
+    // Best first search: candidates are popped by increasing distance
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<>> queue;
+    const size_t elementLevel = this->levels.size();
+    auto pushEntry = [&](const Entry& entry, size_t index) {
+        const auto& box = entry.box;
+        double centerDistance = std::hypot(box.x + box.width / 2 - x, box.y + box.height / 2 - y);
+        queue.push({distance(box, x, y), centerDistance, elementLevel, index});
+    };
+    if (!this->levels.empty()) {
+        queue.push({distance(this->levels.back()[0], x, y), -1, elementLevel - 1, 0});
+    }
+    for (size_t i = 0; i < this->inserted.size(); i++) { pushEntry(this->inserted[i], this->entries.size() + i); }
+
+    while (!queue.empty()) {
+        Candidate c = queue.top();
+        queue.pop();
+        if (c.distance > maxDistance) {
+            break;
+        }
+
+        if (c.level == elementLevel) {
+            Element* e = c.index < this->entries.size() ? this->entries[c.index].element :
+                                                          this->inserted[c.index - this->entries.size()].element;
+            if (accept(e)) {
+                return e;
+            }
+            continue;
+        }
+
+        const size_t first = c.index * NODE_SIZE;
+        if (c.level == 0) {
+            for (size_t i = first; i < std::min(first + NODE_SIZE, this->entries.size()); i++) {
+                if (this->entries[i].element) {
+                    pushEntry(this->entries[i], i);
+                }
+            }
+        } else {
+            const auto& children = this->levels[c.level - 1];
+            for (size_t i = first; i < std::min(first + NODE_SIZE, children.size()); i++) {
+                queue.push({distance(children[i], x, y), -1, c.level - 1, i});
+            }
+        }
+    }
+    return nullptr;
+}
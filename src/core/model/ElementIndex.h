@@ -0,0 +1,100 @@
+/*
+ * Xournal++
+ *
+ * Spatial index of the elements of a layer
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+#include "util/Rectangle.h"
+
+class Element;
+
+/**
+ * @brief R-tree of the bounding boxes of elements, bulk loaded by sort-tile-recursive, for nearest element queries.
+ *
+ * Elements are inserted and removed one at a time without rebuilding the tree: insertions are kept apart and scanned,
+ * removals leave an empty slot in their leaf. Once these are too many for the tree to stay efficient, needsRebuild()
+ * tells the owner to build a new one (see Layer::getElementIndex()).
+ *
+ * The index holds the bounding boxes the elements had when they were inserted: an element changed in place must be
+ * removed and inserted again.
+ */
+class ElementIndex {
+public:
+    /**
+     * Maximal number of children of a node (elements for the leaves)
+     */
+    static constexpr size_t NODE_SIZE = 16;
+
+    explicit ElementIndex(const std::vector<Element*>& elements);
+
+    /**
+     * Add an element, with its current bounding box
+     */
+    void insert(Element* e);
+
+    /**
+     * Remove an element, nothing happens if it is not in the index
+     */
+    void remove(Element* e);
+
+    /**
+     * @return If so many elements were inserted or removed since the tree was built that a new one should be
+     */
+    bool needsRebuild() const;
+
+    /**
+     * The distance of an element is the distance from the point to its bounding box, so 0 for all elements whose box
+     * contains the point. Ties go to the element whose box center is the closest.
+     *
+     * @param accept Precise test of the candidates, called in increasing distance order
+     * @return The closest accepted element within maxDistance of (x, y), nullptr if there is none
+     */
+    Element* findNearest(double x, double y, double maxDistance, const std::function<bool(Element*)>& accept) const;
+
+    /**
+     * @return The distance from (x, y) to the (closed) rectangle
+     */
+    static double distance(const xoj::util::Rectangle<double>& rect, double x, double y);
+
+private:
+    struct Entry {
+        Element* element;
+        xoj::util::Rectangle<double> box;
+    };
+
+    /**
+     * The elements, in the order of the leaves: the leaf j holds the entries [j * NODE_SIZE, (j + 1) * NODE_SIZE).
+     * Removed elements leave an entry whose element is nullptr.
+     */
+    std::vector<Entry> entries;
+
+    /**
+     * Position of the elements in entries
+     */
+    std::unordered_map<Element*, size_t> positions;
+
+    size_t removedCount = 0;  ///< Number of removed entries
+
+    /**
+     * Elements inserted after the tree was built, not in any leaf
+     */
+    std::vector<Entry> inserted;
+
+    /**
+     * levels[0] holds the boxes of the leaves, levels.back() the root. The node j of a level has the children
+     * [j * NODE_SIZE, (j + 1) * NODE_SIZE) in the level below.
+     */
+    std::vector<std::vector<xoj::util::Rectangle<double>>> levels;
+};
@@ -0,0 +1,126 @@
+#include "ElementTransform.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#include <glib.h>
+
+#include "util/Range.h"
+
+#include "Element.h"
+#include "Stroke.h"
+
+ElementTransform::ElementTransform() { cairo_matrix_init_identity(&this->matrix); }
+
+auto ElementTransform::translation(double dx, double dy) -> ElementTransform {
+    ElementTransform t;
+    cairo_matrix_init_translate(&t.matrix, dx, dy);
+    t.steps.push_back({Step::MOVE, dx, dy, 1.0, 1.0, 0.0, false});
+    return t;
+}
+
+auto ElementTransform::scaling(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth)
+        -> ElementTransform {
+    ElementTransform t;
+    cairo_matrix_translate(&t.matrix, x0, y0);
+    cairo_matrix_rotate(&t.matrix, rotation);
+    cairo_matrix_scale(&t.matrix, fx, fy);
+    cairo_matrix_rotate(&t.matrix, -rotation);
+    cairo_matrix_translate(&t.matrix, -x0, -y0);
+    t.lineWidthFactor = restoreLineWidth ? 1.0 : std::sqrt(std::abs(fx * fy));
+    t.steps.push_back({Step::SCALE, x0, y0, fx, fy, rotation, restoreLineWidth});
+    return t;
+}
+
+auto ElementTransform::rotation(double x0, double y0, double th) -> ElementTransform {
+    ElementTransform t;
+    cairo_matrix_translate(&t.matrix, x0, y0);
+    cairo_matrix_rotate(&t.matrix, th);
+    cairo_matrix_translate(&t.matrix, -x0, -y0);
+    t.steps.push_back({Step::ROTATE, x0, y0, 1.0, 1.0, th, false});
+    return t;
+}
+
+auto ElementTransform::then(const ElementTransform& next) const -> ElementTransform {
+    ElementTransform t;
+    // cairo_matrix_multiply(result, a, b) applies a first, then b
+    cairo_matrix_multiply(&t.matrix, &this->matrix, &next.matrix);
+    t.lineWidthFactor = this->lineWidthFactor * next.lineWidthFactor;
+    t.steps = this->steps;
+    std::copy(next.steps.begin(), next.steps.end(), std::back_inserter(t.steps));
+    return t;
+}
+
+auto ElementTransform::inverse() const -> ElementTransform {
+    ElementTransform t;
+    t.matrix = this->matrix;
+    if (cairo_matrix_invert(&t.matrix) != CAIRO_STATUS_SUCCESS) {
+        g_warning("ElementTransform::inverse(): the transformation is not invertible");
+        cairo_matrix_init_identity(&t.matrix);
+    }
+    t.lineWidthFactor = 1.0 / this->lineWidthFactor;
+
+    t.steps.reserve(this->steps.size());
+    for (auto it = this->steps.rbegin(); it != this->steps.rend(); ++it) {
+        Step s = *it;
+        switch (s.type) {
+            case Step::MOVE:
+                s.x0 = -s.x0;
+                s.y0 = -s.y0;
+                break;
+            case Step::SCALE:
+                s.fx = 1.0 / s.fx;
+                s.fy = 1.0 / s.fy;
+                break;
+            case Step::ROTATE:
+                s.rotation = -s.rotation;
+                break;
+        }
+        t.steps.push_back(s);
+    }
+    return t;
+}
+
+auto ElementTransform::isIdentity() const -> bool { return this->steps.empty(); }
+
+auto ElementTransform::getMatrix() const -> const cairo_matrix_t& { return this->matrix; }
+
+void ElementTransform::applyTo(Element* e) const {
+    if (e->getType() == ELEMENT_STROKE) {
+        static_cast<Stroke*>(e)->transform(this->matrix, this->lineWidthFactor);
+        return;
+    }
+
+    for (auto&& s: this->steps) {
+        switch (s.type) {
+            case Step::MOVE:
+                e->move(s.x0, s.y0);
+                break;
+            case Step::SCALE:
+                e->scale(s.x0, s.y0, s.fx, s.fy, s.rotation, s.restoreLineWidth);
+                break;
+            case Step::ROTATE:
+                e->rotate(s.x0, s.y0, s.rotation);
+                break;
+        }
+    }
+}
+
+void ElementTransform::applyTo(const std::vector<Element*>& elements, Range* range) const {
+    if (isIdentity()) {
+        return;
+    }
+
+    for (Element* e: elements) {
+        if (range) {
+            range->addPoint(e->getX(), e->getY());
+            range->addPoint(e->getX() + e->getElementWidth(), e->getY() + e->getElementHeight());
+        }
+        applyTo(e);
+        if (range) {
+            range->addPoint(e->getX(), e->getY());
+            range->addPoint(e->getX() + e->getElementWidth(), e->getY() + e->getElementHeight());
+        }
+    }
+}
@@ -0,0 +1,84 @@
+/*
+ * Xournal++
+ *
+ * An affine transformation applied to many elements at once
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <cairo.h>
+
+class Element;
+class Range;
+
+/**
+ * @brief Composition of moves, scalings and rotations, as performed by an EditSelection.
+ *
+ * Strokes are transformed by a single matrix, in one pass over their points (see Stroke::transform).
+ * Other elements (Text, Image, TexImage) do not support arbitrary affine transformations: for those, the elementary
+ * steps are replayed through Element::move, Element::scale and Element::rotate.
+ */
+class ElementTransform {
+public:
+    ElementTransform();
+
+    static ElementTransform translation(double dx, double dy);
+    static ElementTransform scaling(double x0, double y0, double fx, double fy, double rotation,
+                                    bool restoreLineWidth);
+    static ElementTransform rotation(double x0, double y0, double th);
+
+    /**
+     * @return The transformation applying this first and then next
+     */
+    ElementTransform then(const ElementTransform& next) const;
+
+    /**
+     * @return The inverse transformation
+     */
+    ElementTransform inverse() const;
+
+    bool isIdentity() const;
+
+    const cairo_matrix_t& getMatrix() const;
+
+    /**
+     * @brief Transform all the given elements
+     * @param elements The elements
+     * @param range If not nullptr, will be extended to contain the bounding boxes of the elements, before and after
+     * the transformation
+     */
+    void applyTo(const std::vector<Element*>& elements, Range* range = nullptr) const;
+
+private:
+    struct Step {
+        enum Type { MOVE, SCALE, ROTATE } type;
+        double x0;
+        double y0;
+        double fx;
+        double fy;
+        double rotation;
+        bool restoreLineWidth;
+    };
+
+    void applyTo(Element* e) const;
+
+private:
+    cairo_matrix_t matrix;
+
+    /**
+     * The factor applied to the width and pressure of strokes
+     */
+    double lineWidthFactor = 1.0;
+
+    /**
+     * The elementary steps, used for elements other than strokes
+     */
+    std::vector<Step> steps;
+};
@@ -36,7 +36,7 @@ auto Image::clone() const -> Element* {
 
     img->image = cairo_surface_reference(this->image);
     img->snappedBounds = this->snappedBounds;
-    img->sizeCalculated = this->sizeCalculated;
+    img->sizeCalculated = this->sizeCalculated.load();
 
     return img;
 }
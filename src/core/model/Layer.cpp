@@ -1,5 +1,7 @@
 #include "Layer.h"
 
+#include <unordered_set>
+
 #include "util/Stacktrace.h"
 
 Layer::Layer() = default;
@@ -36,6 +38,28 @@ void Layer::addElement(Element* e) {
     }
 
     this->elements.push_back(e);
+    if (this->elementIndex) {
+        this->elementIndex->insert(e);
+    }
+}
+
+void Layer::addElements(const std::vector<Element*>& elements) {
+    std::unordered_set<Element*> contained(this->elements.begin(), this->elements.end());
+    this->elements.reserve(this->elements.size() + elements.size());
+    for (Element* e: elements) {
+        if (e == nullptr) {
+            g_warning("addElements(nullptr)!");
+            continue;
+        }
+        if (!contained.insert(e).second) {
+            g_warning("Layer::addElements: Element is already on this layer!");
+            continue;
+        }
+        this->elements.push_back(e);
+        if (this->elementIndex) {
+            this->elementIndex->insert(e);
+        }
+    }
 }
 
 void Layer::insertElement(Element* e, Element::Index pos) {
@@ -65,6 +89,9 @@ void Layer::insertElement(Element* e, Element::Index pos) {
     } else {
         this->elements.insert(this->elements.begin() + pos, e);
     }
+    if (this->elementIndex) {
+        this->elementIndex->insert(e);
+    }
 }
 
 auto Layer::indexOf(Element* e) const -> Element::Index {
@@ -81,6 +108,9 @@ auto Layer::removeElement(Element* e, bool free) -> Element::Index {
     for (unsigned int i = 0; i < this->elements.size(); i++) {
         if (e == this->elements[i]) {
             this->elements.erase(this->elements.begin() + i);
+            if (this->elementIndex) {
+                this->elementIndex->remove(e);
+            }
 
             if (free) {
                 delete e;
@@ -94,7 +124,28 @@ auto Layer::removeElement(Element* e, bool free) -> Element::Index {
     return Element::InvalidIndex;
 }
 
-void Layer::clearNoFree() { this->elements.clear(); }
+void Layer::removeElements(const std::vector<Element*>& elements) {
+    std::unordered_set<Element*> removed(elements.begin(), elements.end());
+    size_t kept = 0;
+    for (Element* e: this->elements) {
+        if (removed.erase(e) == 0) {
+            this->elements[kept++] = e;
+        } else if (this->elementIndex) {
+            this->elementIndex->remove(e);
+        }
+    }
+    this->elements.resize(kept);
+
+    if (!removed.empty()) {
+        g_warning("Could not remove element from layer, it's not on the layer!");
+        Stacktrace::printStracktrace();
+    }
+}
+
+void Layer::clearNoFree() {
+    this->elements.clear();
+    this->elementIndex.reset();
+}
 
 auto Layer::isAnnotated() const -> bool { return !this->elements.empty(); }
 
@@ -110,6 +161,22 @@ void Layer::setVisible(bool visible) { this->visible = visible; }
 
 auto Layer::getElements() const -> const std::vector<Element*>& { return this->elements; }
 
+auto Layer::getElementIndex() const -> const ElementIndex& {
+    if (!this->elementIndex || this->elementIndex->needsRebuild()) {
+        this->elementIndex = std::make_unique<ElementIndex>(this->elements);
+    }
+    return *this->elementIndex;
+}
+
+void Layer::updateElementIndex(Element* e) {
+    if (this->elementIndex) {
+        this->elementIndex->remove(e);
+        this->elementIndex->insert(e);
+    }
+}
+
+void Layer::invalidateElementIndex() { this->elementIndex.reset(); }
+
 auto Layer::hasName() const -> bool { return name.has_value(); }
 
 auto Layer::getName() const -> std::string { return name.value_or(""); }
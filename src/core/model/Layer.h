@@ -11,10 +11,12 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
 #include "Element.h"
+#include "ElementIndex.h"
 
 template <class T>
 using optional = std::optional<T>;
@@ -34,6 +36,13 @@ public:
      */
     void addElement(Element* e);
 
+    /**
+     * Appends several Element%s to this Layer, in order
+     *
+     * @note Performs the same check as addElement(), in linear time overall
+     */
+    void addElements(const std::vector<Element*>& elements);
+
     /**
      * Inserts an Element in the specified position of the Layer%s internal list
      *
@@ -51,6 +60,13 @@ public:
      */
     Element::Index removeElement(Element* e, bool free);
 
+    /**
+     * Removes several Element%s from the Layer, without freeing them
+     *
+     * @note Performs the same check as removeElement(), in linear time overall
+     */
+    void removeElements(const std::vector<Element*>& elements);
+
     /**
      * Removes all Elements from the Layer *without freeing them*
      */
@@ -61,6 +77,21 @@ public:
      */
     const std::vector<Element*>& getElements() const;
 
+    /**
+     * Returns the spatial index of the Element%s, built on first use.
+     *
+     * @note The index follows the Element%s added and removed. Changes of the Element%s themselves must be reported
+     * with updateElementIndex(), or invalidateElementIndex() if many of them changed.
+     */
+    const ElementIndex& getElementIndex() const;
+
+    /**
+     * Index the Element again, after its bounding box changed
+     */
+    void updateElementIndex(Element* e);
+
+    void invalidateElementIndex();
+
     /**
      * Returns whether or not the Layer is empty
      */
@@ -99,6 +130,8 @@ public:
 private:
     std::vector<Element*> elements;
 
+    mutable std::unique_ptr<ElementIndex> elementIndex;
+
     bool visible = true;
 
     optional<std::string> name;
@@ -1,6 +1,10 @@
 #include "Stroke.h"
 
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <limits>
+#include <mutex>
 #include <numeric>
 
 #include "eraser/PaddedBox.h"
@@ -14,6 +18,8 @@
 #include "util/serializing/ObjectOutputStream.h"
 
 #include "PathParameter.h"
+#include "StrokeDecodeCache.h"
+#include "StrokeSegmentTree.h"
 #include "config-debug.h"
 
 using xoj::util::Rectangle;
@@ -56,7 +62,34 @@ constexpr void updateBounds(Float& x, Float& y, Float& width, Float& height, Rec
 }
 
 
-Stroke::Stroke(): AudioElement(ELEMENT_STROKE) {}
+/**
+ * Guard the decoded copy of the points of a compact stroke, which may be requested from several threads (rendering,
+ * saving). The strokes are spread over a few mutexes rather than each having its own.
+ */
+static auto decodeMutex(const Stroke* s) -> std::mutex& {
+    static std::array<std::mutex, 64> decodeMutexes;
+    return decodeMutexes[std::hash<const Stroke*>()(s) % decodeMutexes.size()];
+}
+
+/**
+ * Incremented at each access to decoded points, to find the least recently used ones
+ */
+static std::atomic<uint64_t> decodeClock{0};
+
+/**
+ * Guards the lazy construction of the segment trees, which may be requested from several threads
+ */
+static std::mutex segmentTreeMutex;
+
+/**
+ * Shared by all the strokes without points, so that creating a stroke does not allocate
+ */
+static auto emptyPoints() -> const std::shared_ptr<std::vector<Point>>& {
+    static const auto empty = std::make_shared<std::vector<Point>>();
+    return empty;
+}
+
+Stroke::Stroke(): AudioElement(ELEMENT_STROKE), points(emptyPoints()) {}
 
 Stroke::~Stroke() = default;
 
@@ -77,13 +110,18 @@ void Stroke::applyStyleFrom(const Stroke* other) {
 auto Stroke::cloneStroke() const -> Stroke* {
     auto* s = new Stroke();
     s->applyStyleFrom(this);
-    s->points = this->points;
+    // The points are shared until one of the strokes is edited. A compact stroke shares its immutable geometry: the
+    // decoded copy of the points is not needed.
+    if (!this->geometry) {
+        s->points = this->points;
+    }
+    s->geometry = this->geometry;
     s->x = this->x;
     s->y = this->y;
     s->Element::width = this->Element::width;
     s->Element::height = this->Element::height;
     s->snappedBounds = this->snappedBounds;
-    s->sizeCalculated = this->sizeCalculated;
+    s->sizeCalculated = this->sizeCalculated.load();
     return s;
 }
 
@@ -92,23 +130,27 @@ auto Stroke::clone() const -> Element* { return this->cloneStroke(); }
 std::unique_ptr<Stroke> Stroke::cloneSection(const PathParameter& lowerBound, const PathParameter& upperBound) const {
     assert(lowerBound.isValid() && upperBound.isValid());
     assert(lowerBound <= upperBound);
-    assert(upperBound.index < this->points.size() - 1);
+    // Kept alive even if the decoded copy is released meanwhile
+    const auto decoded = decodedPoints();
+    const auto& points = *decoded;
+    assert(upperBound.index < points.size() - 1);
 
     auto s = std::make_unique<Stroke>();
     s->applyStyleFrom(this);
 
-    s->points.reserve(upperBound.index - lowerBound.index + 2);
+    auto& sectionPoints = s->editablePoints();
+    sectionPoints.reserve(upperBound.index - lowerBound.index + 2);
 
-    s->points.emplace_back(this->getPoint(lowerBound));
+    sectionPoints.emplace_back(this->getPoint(lowerBound));
 
-    auto beginIt = std::next(this->points.cbegin(), (std::ptrdiff_t)lowerBound.index + 1);
-    auto endIt = std::next(this->points.cbegin(), (std::ptrdiff_t)upperBound.index + 1);
-    std::copy(beginIt, endIt, std::back_inserter(s->points));
+    auto beginIt = std::next(points.cbegin(), (std::ptrdiff_t)lowerBound.index + 1);
+    auto endIt = std::next(points.cbegin(), (std::ptrdiff_t)upperBound.index + 1);
+    std::copy(beginIt, endIt, std::back_inserter(sectionPoints));
 
-    s->points.emplace_back(this->getPoint(upperBound));
+    sectionPoints.emplace_back(this->getPoint(upperBound));
 
     // Remove unused pressure value
-    s->points.back().z = Point::NO_PRESSURE;
+    sectionPoints.back().z = Point::NO_PRESSURE;
 
     return s;
 }
@@ -117,27 +159,30 @@ std::unique_ptr<Stroke> Stroke::cloneCircularSectionOfClosedStroke(const PathPar
                                                                    const PathParameter& endParam) const {
     assert(startParam.isValid() && endParam.isValid());
     assert(endParam < startParam);
-    assert(startParam.index < this->points.size() - 1);
+    const auto decoded = decodedPoints();
+    const auto& points = *decoded;
+    assert(startParam.index < points.size() - 1);
 
     auto s = std::make_unique<Stroke>();
     s->applyStyleFrom(this);
 
-    s->points.reserve(this->points.size() - startParam.index + endParam.index + 1);
+    auto& sectionPoints = s->editablePoints();
+    sectionPoints.reserve(points.size() - startParam.index + endParam.index + 1);
 
-    s->points.emplace_back(this->getPoint(startParam));
+    sectionPoints.emplace_back(this->getPoint(startParam));
 
-    auto startIt = std::next(this->points.cbegin(), (std::ptrdiff_t)startParam.index + 1);
+    auto startIt = std::next(points.cbegin(), (std::ptrdiff_t)startParam.index + 1);
     // Skip the last point: points.back().equalPos(points.front()) == true and we want this point only once
-    assert(startIt != this->points.cend());
-    std::copy(startIt, std::prev(this->points.cend()), std::back_inserter(s->points));
+    assert(startIt != points.cend());
+    std::copy(startIt, std::prev(points.cend()), std::back_inserter(sectionPoints));
 
-    auto endIt = std::next(this->points.cbegin(), (std::ptrdiff_t)endParam.index + 1);
-    std::copy(this->points.cbegin(), endIt, std::back_inserter(s->points));
+    auto endIt = std::next(points.cbegin(), (std::ptrdiff_t)endParam.index + 1);
+    std::copy(points.cbegin(), endIt, std::back_inserter(sectionPoints));
 
-    s->points.emplace_back(this->getPoint(endParam));
+    sectionPoints.emplace_back(this->getPoint(endParam));
 
     // Remove unused pressure value
-    s->points.back().z = Point::NO_PRESSURE;
+    sectionPoints.back().z = Point::NO_PRESSURE;
 
     return s;
 }
@@ -155,7 +200,9 @@ void Stroke::serialize(ObjectOutputStream& out) const {
 
     out.writeInt(this->capStyle);
 
-    out.writeData(this->points.data(), this->points.size(), sizeof(Point));
+    const auto decoded = decodedPoints();
+    const auto& points = *decoded;
+    out.writeData(points.data(), points.size(), sizeof(Point));
 
     this->lineStyle.serialize(out);
 
@@ -175,11 +222,9 @@ void Stroke::readSerialized(ObjectInputStream& in) {
 
     this->capStyle = static_cast<StrokeCapStyle>(in.readInt());
 
-    Point* p{};
-    int count{};
-    in.readData(reinterpret_cast<void**>(&p), &count);
-    this->points = std::vector<Point>{p, p + count};
-    g_free(p);
+    this->points = std::make_shared<std::vector<Point>>(in.readData<Point>());
+    this->geometry.reset();
+    this->segmentTree.reset();
     this->lineStyle.readSerialized(in);
 
     in.endObject();
@@ -210,7 +255,28 @@ auto Stroke::getWidth() const -> double { return this->width; }
 auto Stroke::rescaleWithMirror() -> bool { return true; }
 
 auto Stroke::isInSelection(ShapeContainer* container) const -> bool {
-    for (auto&& p: this->points) {
+    if (const StrokeSegmentTree* tree = getIndexedSegmentTree()) {
+        // Only the points of the nodes which are not entirely inside the selection need to be checked
+        return tree->traverse(
+                [container](const Rectangle<double>& box, size_t, size_t) {
+                    return !container->containsRectangle(box);
+                },
+                [this, container](size_t first, size_t last) {
+                    for (size_t i = first; i <= last + 1; i++) {
+                        Point p = getIndexedPoint(i);
+                        if (!container->contains(p.x, p.y)) {
+                            return false;
+                        }
+                    }
+                    return true;
+                });
+    }
+
+    if (this->geometry) {
+        return !this->geometry->findPosition([container](double x, double y) { return !container->contains(x, y); });
+    }
+
+    for (auto&& p: *this->points) {
         double px = p.x;
         double py = p.y;
 
@@ -223,8 +289,9 @@ auto Stroke::isInSelection(ShapeContainer* container) const -> bool {
 }
 
 void Stroke::setFirstPoint(double x, double y) {
-    if (!this->points.empty()) {
-        Point& p = this->points.front();
+    auto& points = editablePoints();
+    if (!points.empty()) {
+        Point& p = points.front();
         p.x = x;
         p.y = y;
         this->sizeCalculated = false;
@@ -234,57 +301,159 @@ void Stroke::setFirstPoint(double x, double y) {
 void Stroke::setLastPoint(double x, double y) { setLastPoint({x, y}); }
 
 void Stroke::setLastPoint(const Point& p) {
-    if (!this->points.empty()) {
-        this->points.back() = p;
+    auto& points = editablePoints();
+    if (!points.empty()) {
+        points.back() = p;
         this->sizeCalculated = false;
     }
 }
 
 void Stroke::addPoint(const Point& p) {
-    this->points.emplace_back(p);
+    editablePoints().emplace_back(p);
     updateBounds(Element::x, Element::y, Element::width, Element::height, Element::snappedBounds, p,
                  hasPressure() ? p.z / 2.0 : this->width / 2.0);
 }
 
-auto Stroke::getPointCount() const -> int { return this->points.size(); }
+auto Stroke::getPointCount() const -> int {
+    return static_cast<int>(this->geometry ? this->geometry->size() : this->points->size());
+}
+
+auto Stroke::getPointVector() const -> std::vector<Point> const& { return *decodedPoints(); }
 
-auto Stroke::getPointVector() const -> std::vector<Point> const& { return points; }
+void Stroke::setPointVector(std::vector<Point> points) {
+    this->geometry.reset();
+    this->segmentTree.reset();
+    this->points = std::make_shared<std::vector<Point>>(std::move(points));
+    this->sizeCalculated = false;
+}
 
 void Stroke::deletePointsFrom(int index) {
+    auto& points = editablePoints();
     points.resize(std::min(size_t(index), points.size()));
     this->sizeCalculated = false;
 }
 
 void Stroke::deletePoint(int index) {
-    this->points.erase(std::next(begin(this->points), index));
+    auto& points = editablePoints();
+    points.erase(std::next(begin(points), index));
     this->sizeCalculated = false;
 }
 
 auto Stroke::getPoint(int index) const -> Point {
-    if (index < 0 || index >= this->points.size()) {
+    if (index < 0 || index >= getPointCount()) {
         g_warning("Stroke::getPoint(%i) out of bounds!", index);
         return Point(0, 0, Point::NO_PRESSURE);
     }
-    return points.at(index);
+    if (this->geometry && this->geometry->hasRandomAccess()) {
+        return this->geometry->getPoint(static_cast<size_t>(index));
+    }
+    return decodedPoints()->at(static_cast<size_t>(index));
 }
 
 Point Stroke::getPoint(PathParameter parameter) const {
-    assert(parameter.isValid() && parameter.index < this->points.size() - 1);
+    const auto decoded = decodedPoints();
+    const auto& points = *decoded;
+    assert(parameter.isValid() && parameter.index < points.size() - 1);
 
-    const Point& p = this->points[parameter.index];
-    if (parameter.index == this->points.size() - 2) {
+    const Point& p = points[parameter.index];
+    if (parameter.index == points.size() - 2) {
         // Need to handle the pressure value separately, since the last pressure value of a stroke is not set.
-        Point q = this->points[parameter.index + 1];
+        Point q = points[parameter.index + 1];
         q.z = p.z;
         return p.relativeLineTo(q, parameter.t);
     }
-    const Point& q = this->points[parameter.index + 1];
+    const Point& q = points[parameter.index + 1];
     return p.relativeLineTo(q, parameter.t);
 }
 
-auto Stroke::getPoints() const -> const Point* { return this->points.data(); }
+auto Stroke::getPoints() const -> const Point* { return decodedPoints()->data(); }
+
+void Stroke::freeUnusedPointItems() {
+    if (!this->geometry && this->points->capacity() > this->points->size()) {
+        this->points = std::make_shared<std::vector<Point>>(this->points->begin(), this->points->end());
+    }
+}
+
+void Stroke::compact(StrokeStorage storage) {
+    if (storage == StrokeStorage::POINTS || this->geometry || this->points->empty()) {
+        return;
+    }
+    this->geometry = std::make_shared<const StrokeGeometry>(*this->points, storage);
+    this->points = emptyPoints();
+    // The quantized storages round the coordinates
+    this->segmentTree.reset();
+    if (this->geometry->getStorage() != StrokeStorage::COMPACT) {
+        // The rounded coordinates may slightly change the bounding box
+        this->sizeCalculated = false;
+    }
+}
+
+auto Stroke::isCompact() const -> bool { return this->geometry != nullptr; }
+
+auto Stroke::getCompactGeometry() const -> const StrokeGeometry* { return this->geometry.get(); }
+
+auto Stroke::getDecodedMemoryUsage() const -> size_t {
+    return this->geometry ? this->points->capacity() * sizeof(Point) : 0;
+}
+
+auto Stroke::getLastDecodedUse() const -> uint64_t { return this->lastDecodedUse; }
+
+void Stroke::releaseDecodedPoints() {
+    if (this->geometry) {
+        std::lock_guard<std::mutex> lock(decodeMutex(this));
+        this->points = emptyPoints();
+    }
+}
+
+auto Stroke::decodedPoints() const -> std::shared_ptr<const std::vector<Point>> {
+    if (!this->geometry) {
+        return this->points;
+    }
+
+    std::lock_guard<std::mutex> lock(decodeMutex(this));
+    if (this->points->empty()) {
+        this->points = std::make_shared<std::vector<Point>>(this->geometry->toPoints());
+        StrokeDecodeCache::addDecoded(this->points->capacity() * sizeof(Point));
+    }
+    this->lastDecodedUse = ++decodeClock;
+    return this->points;
+}
+
+auto Stroke::editablePoints() -> std::vector<Point>& {
+    decodedPoints();
+    this->geometry.reset();
+    this->segmentTree.reset();
+    // Copy on write: the points may be shared with copies of the stroke
+    if (this->points.use_count() > 1) {
+        this->points = std::make_shared<std::vector<Point>>(*this->points);
+    }
+    return *this->points;
+}
+
+auto Stroke::getSegmentTree() const -> const StrokeSegmentTree* {
+    if (static_cast<size_t>(getPointCount()) < StrokeSegmentTree::MIN_POINTS) {
+        return nullptr;
+    }
 
-void Stroke::freeUnusedPointItems() { this->points = {begin(this->points), end(this->points)}; }
+    std::lock_guard<std::mutex> lock(segmentTreeMutex);
+    if (!this->segmentTree) {
+        // Built from the compact geometry if any, which is not decoded
+        this->segmentTree = this->geometry ? std::make_shared<const StrokeSegmentTree>(*this->geometry) :
+                                             std::make_shared<const StrokeSegmentTree>(*this->points);
+    }
+    return this->segmentTree.get();
+}
+
+auto Stroke::getIndexedSegmentTree() const -> const StrokeSegmentTree* {
+    if (this->geometry && !this->geometry->hasRandomAccess()) {
+        return nullptr;
+    }
+    return getSegmentTree();
+}
+
+auto Stroke::getIndexedPoint(size_t index) const -> Point {
+    return this->geometry ? this->geometry->getPoint(index) : (*this->points)[index];
+}
 
 void Stroke::setToolType(StrokeTool type) { this->toolType = type; }
 
@@ -295,7 +464,7 @@ void Stroke::setLineStyle(const LineStyle& style) { this->lineStyle = style; }
 auto Stroke::getLineStyle() const -> const LineStyle& { return this->lineStyle; }
 
 void Stroke::move(double dx, double dy) {
-    for (auto&& point: points) {
+    for (auto&& point: editablePoints()) {
         point.x += dx;
         point.y += dy;
     }
@@ -311,9 +480,7 @@ void Stroke::rotate(double x0, double y0, double th) {
     cairo_matrix_rotate(&rotMatrix, th);
     cairo_matrix_translate(&rotMatrix, -x0, -y0);
 
-    for (auto&& p: points) { cairo_matrix_transform_point(&rotMatrix, &p.x, &p.y); }
-    this->sizeCalculated = false;
-    // Width and Height will likely be changed after this operation
+    transform(rotMatrix, 1.0);
 }
 
 void Stroke::scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) {
@@ -326,64 +493,104 @@ void Stroke::scale(double x0, double y0, double fx, double fy, double rotation,
     cairo_matrix_rotate(&scaleMatrix, -rotation);
     cairo_matrix_translate(&scaleMatrix, -x0, -y0);
 
-    for (auto&& p: points) {
-        cairo_matrix_transform_point(&scaleMatrix, &p.x, &p.y);
+    transform(scaleMatrix, fz);
+}
 
-        if (p.z != Point::NO_PRESSURE) {
-            p.z *= fz;
-        }
+void Stroke::transform(const cairo_matrix_t& matrix, double lineWidthFactor) {
+    auto& points = editablePoints();
+    if (points.empty()) {
+        this->width *= lineWidthFactor;
+        this->sizeCalculated = false;
+        return;
     }
-    this->width *= fz;
 
-    this->sizeCalculated = false;
+    // Copy the coefficients to locals, so the compiler knows they do not alias the points
+    const double xx = matrix.xx;
+    const double xy = matrix.xy;
+    const double yx = matrix.yx;
+    const double yy = matrix.yy;
+    const double tx = matrix.x0;
+    const double ty = matrix.y0;
+    // Point::NO_PRESSURE must not be scaled
+    const double fz = hasPressure() ? lineWidthFactor : 1.0;
+
+    double minSnapX = std::numeric_limits<double>::max();
+    double maxSnapX = std::numeric_limits<double>::lowest();
+    double minSnapY = std::numeric_limits<double>::max();
+    double maxSnapY = std::numeric_limits<double>::lowest();
+    double maxPressure = 0.0;
+
+    // Branch-free loop, so it can be vectorized
+    for (auto&& p: points) {
+        const double px = xx * p.x + xy * p.y + tx;
+        const double py = yx * p.x + yy * p.y + ty;
+        p.x = px;
+        p.y = py;
+        p.z *= fz;
+
+        minSnapX = std::min(minSnapX, px);
+        minSnapY = std::min(minSnapY, py);
+        maxSnapX = std::max(maxSnapX, px);
+        maxSnapY = std::max(maxSnapY, py);
+        maxPressure = std::max(maxPressure, p.z);
+    }
+    this->width *= lineWidthFactor;
+
+    setBounds(minSnapX, minSnapY, maxSnapX, maxSnapY, maxPressure);
 }
 
 auto Stroke::hasPressure() const -> bool {
-    if (!this->points.empty()) {
-        return this->points[0].z != Point::NO_PRESSURE;
+    if (this->geometry) {
+        return this->geometry->hasPressure();
+    }
+    if (!this->points->empty()) {
+        return this->points->front().z != Point::NO_PRESSURE;
     }
     return false;
 }
 
 auto Stroke::getAvgPressure() const -> double {
-    return std::accumulate(begin(this->points), end(this->points), 0.0,
-                           [](double l, Point const& p) { return l + p.z; }) /
-           this->points.size();
+    const auto decoded = decodedPoints();
+    const auto& points = *decoded;
+    return std::accumulate(begin(points), end(points), 0.0, [](double l, Point const& p) { return l + p.z; }) /
+           points.size();
 }
 
 void Stroke::scalePressure(double factor) {
     if (!hasPressure()) {
         return;
     }
-    for (auto&& p: this->points) { p.z *= factor; }
+    for (auto&& p: editablePoints()) { p.z *= factor; }
 }
 
 void Stroke::clearPressure() {
-    for (auto&& p: points) { p.z = Point::NO_PRESSURE; }
+    for (auto&& p: editablePoints()) { p.z = Point::NO_PRESSURE; }
 }
 
 void Stroke::setLastPressure(double pressure) {
-    if (!this->points.empty()) {
-        this->points.back().z = pressure;
+    auto& points = editablePoints();
+    if (!points.empty()) {
+        points.back().z = pressure;
     }
 }
 
 void Stroke::setSecondToLastPressure(double pressure) {
     auto const pointCount = this->getPointCount();
     if (pointCount >= 2) {
-        this->points[pointCount - 2].z = pressure;
+        editablePoints()[pointCount - 2].z = pressure;
     }
 }
 
 void Stroke::setPressure(const std::vector<double>& pressure) {
+    auto& points = editablePoints();
     // The last pressure is not used - as there is no line drawn from this point
-    if (this->points.size() - 1 != pressure.size()) {
+    if (points.size() - 1 != pressure.size()) {
         g_warning("invalid pressure point count: %s, expected %s", std::to_string(pressure.size()).data(),
-                  std::to_string(this->points.size() - 1).data());
+                  std::to_string(points.size() - 1).data());
     }
 
-    auto max_size = std::min(pressure.size(), this->points.size() - 1);
-    for (size_t i = 0U; i != max_size; ++i) { this->points[i].z = pressure[i]; }
+    auto max_size = std::min(pressure.size(), points.size() - 1);
+    for (size_t i = 0U; i != max_size; ++i) { points[i].z = pressure[i]; }
 }
 
 /**
@@ -397,7 +604,7 @@ auto Stroke::intersects(double x, double y, double halfEraserSize) const -> bool
  * checks if the stroke is intersected by the eraser rectangle
  */
 auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap) const -> bool {
-    if (this->points.empty()) {
+    if (getPointCount() == 0) {
         return false;
     }
 
@@ -406,12 +613,22 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
     double y1 = y - halfEraserSize;
     double y2 = y + halfEraserSize;
 
-    double lastX = points[0].x;
-    double lastY = points[0].y;
-    for (auto&& point: points) {
-        double px = point.x;
-        double py = point.y;
+    constexpr double PADDING = 0.1;
 
+    // The first point is read without decoding the geometry, which getPoint(0) would do for quantized strokes
+    double lastX = 0;
+    double lastY = 0;
+    if (this->geometry) {
+        this->geometry->findPosition([&](double px, double py) {
+            lastX = px;
+            lastY = py;
+            return true;
+        });
+    } else {
+        lastX = this->points->front().x;
+        lastY = this->points->front().y;
+    }
+    auto hit = [&](double px, double py) -> bool {
         if (px >= x1 && py >= y1 && px <= x2 && py <= y2) {
             if (gap) {
                 *gap = 0;
@@ -441,8 +658,6 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
 
                 distance -= halfEraserSize * std::sqrt(2);
 
-                constexpr double PADDING = 0.1;
-
                 if (distance <= len / 2 + PADDING) {
                     if (gap) {
                         *gap = distance;
@@ -454,9 +669,36 @@ auto Stroke::intersects(double x, double y, double halfEraserSize, double* gap)
 
         lastX = px;
         lastY = py;
+        return false;
+    };
+
+    if (const StrokeSegmentTree* tree = getIndexedSegmentTree()) {
+        // A hit is within halfEraserSize of the line of the segment, and (along the line) within
+        // halfEraserSize * sqrt(2) + PADDING of the segment: so within the sum of both of its bounding box
+        const double padding = halfEraserSize * (1 + std::sqrt(2)) + PADDING;
+        const Rectangle<double> rect(x - padding, y - padding, 2 * padding, 2 * padding);
+        for (auto&& segments: tree->findSegments(rect)) {
+            // Same walk as below, restricted to the points [segments.min, segments.max + 1]
+            Point first = getIndexedPoint(segments.min);
+            lastX = first.x;
+            lastY = first.y;
+            if (segments.min == 0 && hit(lastX, lastY)) {
+                return true;
+            }
+            for (size_t i = segments.min + 1; i <= segments.max + 1; i++) {
+                Point p = getIndexedPoint(i);
+                if (hit(p.x, p.y)) {
+                    return true;
+                }
+            }
+        }
+        return false;
     }
 
-    return false;
+    if (this->geometry) {
+        return this->geometry->findPosition(hit);
+    }
+    return std::any_of(this->points->begin(), this->points->end(), [&hit](const Point& p) { return hit(p.x, p.y); });
 }
 
 
@@ -529,9 +771,9 @@ static TinyVector<double, 2> intersectLineSegmentWithRectangle(const Point& p, c
 }
 
 auto Stroke::intersectWithPaddedBox(const PaddedBox& box) const -> IntersectionParametersContainer {
-    auto pointCount = this->points.size();
+    auto pointCount = static_cast<size_t>(getPointCount());
     if (pointCount < 2) {
-        if (pointCount == 1 && this->points.back().isInside(box.getInnerRectangle())) {
+        if (pointCount == 1 && getPoint(0).isInside(box.getInnerRectangle())) {
             IntersectionParametersContainer result;
             result.emplace_back(0U, 0.0);
             result.emplace_back(0U, 0.0);
@@ -544,7 +786,33 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box) const -> IntersectionP
 
 auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, size_t lastIndex) const
         -> IntersectionParametersContainer {
-    assert(firstIndex <= lastIndex && lastIndex < this->points.size() - 1);
+    const StrokeSegmentTree* tree = getSegmentTree();
+    if (!tree) {
+        return intersectSegmentsWithPaddedBox(box, firstIndex, lastIndex);
+    }
+
+    /*
+     * Only the runs of segments close to the outer box can cross it. A segment before or after a run lies outside of
+     * the outer box, so each run starts and ends outside of it (unless it is at an end of the interval), just as if
+     * the whole interval was walked. The margin keeps the points lying on the border of the box in the runs.
+     */
+    constexpr double MARGIN = 1e-6;
+    const auto outerBox = box.getOuterRectangle();
+    const Rectangle<double> rect(outerBox.x - MARGIN, outerBox.y - MARGIN, outerBox.width + 2 * MARGIN,
+                                 outerBox.height + 2 * MARGIN);
+
+    IntersectionParametersContainer result;
+    for (auto&& segments: tree->findSegments(rect, firstIndex, lastIndex)) {
+        for (auto&& param: intersectSegmentsWithPaddedBox(box, segments.min, segments.max)) { result.push_back(param); }
+    }
+    return result;
+}
+
+auto Stroke::intersectSegmentsWithPaddedBox(const PaddedBox& box, size_t firstIndex, size_t lastIndex) const
+        -> IntersectionParametersContainer {
+    const auto decoded = decodedPoints();
+    const auto& points = *decoded;
+    assert(firstIndex <= lastIndex && lastIndex < points.size() - 1);
 
     const auto innerBox = box.getInnerRectangle();
     const auto outerBox = box.getOuterRectangle();
@@ -570,7 +838,7 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, siz
 
     size_t index = firstIndex;
 
-    const PairView segments(this->points);
+    const PairView segments(points);
     auto segmentIt = std::next(segments.begin(), (std::ptrdiff_t)index);
 
     Flags flags = initializeFlagsFromHalfTangentAtFirstKnot(segmentIt.first(), segmentIt.second());
@@ -762,7 +1030,7 @@ auto Stroke::intersectWithPaddedBox(const PaddedBox& box, size_t firstIndex, siz
  * Also used for Selected Bounding box.
  */
 void Stroke::calcSize() const {
-    if (this->points.empty()) {
+    if (getPointCount() == 0) {
         Element::x = 0;
         Element::y = 0;
 
@@ -772,6 +1040,7 @@ void Stroke::calcSize() const {
 
         // used for snapping
         Element::snappedBounds = Rectangle<double>{};
+        return;
     }
 
     double minSnapX = DBL_MAX;
@@ -781,16 +1050,24 @@ void Stroke::calcSize() const {
 
     auto halfThick = 0.0;
 
-    //#pragma omp parralel
-    for (auto&& p: points) {
-        halfThick = std::max(halfThick, p.z);
-        minSnapX = std::min(minSnapX, p.x);
-        minSnapY = std::min(minSnapY, p.y);
-        maxSnapX = std::max(maxSnapX, p.x);
-        maxSnapY = std::max(maxSnapY, p.y);
+    if (this->geometry) {
+        this->geometry->getBounds(minSnapX, minSnapY, maxSnapX, maxSnapY, halfThick);
+    } else {
+        //#pragma omp parralel
+        for (auto&& p: *points) {
+            halfThick = std::max(halfThick, p.z);
+            minSnapX = std::min(minSnapX, p.x);
+            minSnapY = std::min(minSnapY, p.y);
+            maxSnapX = std::max(maxSnapX, p.x);
+            maxSnapY = std::max(maxSnapY, p.y);
+        }
     }
 
-    halfThick = points[0].z != Point::NO_PRESSURE ? halfThick / 2.0 : this->width / 2.0;
+    setBounds(minSnapX, minSnapY, maxSnapX, maxSnapY, halfThick);
+}
+
+void Stroke::setBounds(double minSnapX, double minSnapY, double maxSnapX, double maxSnapY, double maxPressure) const {
+    auto halfThick = hasPressure() ? maxPressure / 2.0 : this->width / 2.0;
 
     auto minX = minSnapX - halfThick;
     auto minY = minSnapY - halfThick;
@@ -802,6 +1079,7 @@ void Stroke::calcSize() const {
     Element::width = maxX - minX;
     Element::height = maxY - minY;
     Element::snappedBounds = Rectangle<double>(minSnapX, minSnapY, maxSnapX - minSnapX, maxSnapY - minSnapY);
+    Element::sizeCalculated = true;
 }
 
 auto Stroke::getErasable() const -> ErasableStroke* { return this->erasable; }
@@ -815,7 +1093,8 @@ void Stroke::setStrokeCapStyle(const StrokeCapStyle capStyle) { this->capStyle =
 void Stroke::debugPrint() const {
     g_message("%s", FC(FORMAT_STR("Stroke {1} / hasPressure() = {2}") % (uint64_t)this % this->hasPressure()));
 
-    for (auto&& p: points) { g_message("%lf / %lf / %lf", p.x, p.y, p.z); }
+    const auto decoded = decodedPoints();
+    for (auto&& p: *decoded) { g_message("%lf / %lf / %lf", p.x, p.y, p.z); }
 
     g_message("\n");
 }
@@ -11,12 +11,14 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 #include "AudioElement.h"
 #include "Element.h"
 #include "LineStyle.h"
 #include "Point.h"
+#include "StrokeGeometry.h"
 
 enum StrokeTool { STROKE_TOOL_PEN, STROKE_TOOL_ERASER, STROKE_TOOL_HIGHLIGHTER };
 enum StrokeCapStyle {
@@ -27,6 +29,7 @@ enum StrokeCapStyle {
     // and in EraserHandler::PADDING_COEFFICIENT_CAP
 
 class ErasableStroke;
+class StrokeSegmentTree;
 struct PaddedBox;
 struct PathParameter;
 
@@ -100,7 +103,48 @@ public:
     void setLastPoint(const Point& p);
     int getPointCount() const;
     void freeUnusedPointItems();
+
+    /**
+     * @brief Store the points in a compact, read-only format (see StrokeGeometry).
+     * Meant for finished strokes: the points are converted back to a std::vector<Point> as soon as they are edited.
+     * Does nothing if storage == StrokeStorage::POINTS.
+     */
+    void compact(StrokeStorage storage);
+    bool isCompact() const;
+
+    /**
+     * @return The compact geometry, or nullptr if the stroke is not compact
+     */
+    const StrokeGeometry* getCompactGeometry() const;
+
+    /**
+     * @return The memory used by the decoded copy of the points of a compact stroke (0 if there is none), in bytes
+     */
+    size_t getDecodedMemoryUsage() const;
+
+    /**
+     * @return A counter value, larger for strokes whose decoded points were used more recently
+     */
+    uint64_t getLastDecodedUse() const;
+
+    /**
+     * @brief Free the decoded copy of the points of a compact stroke. They will be decoded again when needed.
+     * The points stay alive for the holders of a decodedPoints() handle. No reference from getPointVector() or
+     * getPoints() may be in use, see StrokeDecodeCache::trim()
+     */
+    void releaseDecodedPoints();
+
+    /**
+     * Warning: on a compact stroke, this decodes the points. Prefer getPoint(int) or getCompactGeometry() in hot loops.
+     * The reference is valid until the stroke is edited or its decoded points are released, which happens with the
+     * document locked.
+     */
     std::vector<Point> const& getPointVector() const;
+
+    /**
+     * Replace all the points of the stroke
+     */
+    void setPointVector(std::vector<Point> points);
     Point getPoint(int index) const;
     Point getPoint(PathParameter parameter) const;
     const Point* getPoints() const;
@@ -147,6 +191,14 @@ public:
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
 
+    /**
+     * @brief Apply an affine transformation to all the points of the stroke.
+     * The bounding box is recomputed in the same pass over the points.
+     * @param matrix The transformation
+     * @param lineWidthFactor The factor applied to the stroke width and the pressure values
+     */
+    void transform(const cairo_matrix_t& matrix, double lineWidthFactor);
+
     bool isInSelection(ShapeContainer* container) const override;
 
     ErasableStroke* getErasable() const;
@@ -167,13 +219,70 @@ public:
 protected:
     void calcSize() const override;
 
+private:
+    /**
+     * Sets the bounding box and the snapping bounds from the extremal coordinates of the points
+     * Assumes the stroke is not empty
+     */
+    void setBounds(double minSnapX, double minSnapY, double maxSnapX, double maxSnapY, double maxPressure) const;
+
+    /**
+     * @return The points, decoding the compact geometry if need be. The handle keeps them alive even if the decoded
+     * copy is released meanwhile.
+     */
+    std::shared_ptr<const std::vector<Point>> decodedPoints() const;
+
+    /**
+     * @return The points, for edition, copied first if they are shared. The compact geometry (if any) and the segment
+     * tree are dropped.
+     */
+    std::vector<Point>& editablePoints();
+
+    /**
+     * @return The segment tree of the stroke, built on first use. nullptr if the stroke is too short to need one.
+     */
+    const StrokeSegmentTree* getSegmentTree() const;
+
+    /**
+     * @return The segment tree, if the points of its segments can be read by index with getIndexedPoint(): nullptr for
+     * quantized strokes, which are walked linearly rather than decoded
+     */
+    const StrokeSegmentTree* getIndexedSegmentTree() const;
+
+    /**
+     * @return The point of the index, read from the compact geometry if any. Constant time unless quantized.
+     */
+    Point getIndexedPoint(size_t index) const;
+
+    /**
+     * Linear version of intersectWithPaddedBox(box, firstIndex, lastIndex)
+     */
+    IntersectionParametersContainer intersectSegmentsWithPaddedBox(const PaddedBox& box, size_t firstIndex,
+                                                                   size_t lastIndex) const;
+
 private:
     // The stroke width cannot be inherited from Element
     double width = 0;
     StrokeTool toolType = STROKE_TOOL_PEN;
 
-    // The array with the points
-    std::vector<Point> points{};
+    // The array with the points, never null. Shared between copies of the stroke until one of them is edited, see
+    // editablePoints(). If the stroke is compact, this is a decoded copy of the geometry (or empty).
+    mutable std::shared_ptr<std::vector<Point>> points;
+
+    /**
+     * The points of a compact stroke. Immutable, hence shared between copies of the stroke.
+     */
+    std::shared_ptr<const StrokeGeometry> geometry;
+
+    /**
+     * Cache of getSegmentTree(). Immutable, hence shared between copies of the stroke.
+     */
+    mutable std::shared_ptr<const StrokeSegmentTree> segmentTree;
+
+    /**
+     * See getLastDecodedUse()
+     */
+    mutable uint64_t lastDecodedUse = 0;
 
     /**
      * Dashed line
@@ -0,0 +1,67 @@
+#include "StrokeDecodeCache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "Document.h"
+#include "Element.h"
+#include "Layer.h"
+#include "Stroke.h"
+#include "XojPage.h"
+
+/**
+ * Bytes decoded since the last scan of the strokes
+ */
+static std::atomic<size_t> decodedSinceScan{0};
+
+/**
+ * Bytes used by the decoded copies at the last scan. Copies are only released or freed with their stroke between two
+ * scans, so usedAtScan + decodedSinceScan bounds the current usage.
+ */
+static size_t usedAtScan = 0;
+
+void StrokeDecodeCache::addDecoded(size_t bytes) { decodedSinceScan += bytes; }
+
+auto StrokeDecodeCache::trim(Document* doc, size_t budget) -> size_t {
+    if (usedAtScan + decodedSinceScan.load() <= budget) {
+        return 0;
+    }
+    decodedSinceScan = 0;
+
+    std::vector<Stroke*> decoded;
+    size_t used = 0;
+    for (size_t i = 0; i < doc->getPageCount(); ++i) {
+        for (Layer* layer: *doc->getPage(i)->getLayers()) {
+            for (Element* e: layer->getElements()) {
+                if (e->getType() != ELEMENT_STROKE) {
+                    continue;
+                }
+                auto* s = static_cast<Stroke*>(e);
+                if (size_t bytes = s->getDecodedMemoryUsage(); bytes > 0) {
+                    used += bytes;
+                    decoded.push_back(s);
+                }
+            }
+        }
+    }
+
+    if (used <= budget) {
+        usedAtScan = used;
+        return 0;
+    }
+
+    std::sort(decoded.begin(), decoded.end(),
+              [](Stroke* a, Stroke* b) { return a->getLastDecodedUse() < b->getLastDecodedUse(); });
+
+    size_t released = 0;
+    for (Stroke* s: decoded) {
+        if (used - released <= budget) {
+            break;
+        }
+        released += s->getDecodedMemoryUsage();
+        s->releaseDecodedPoints();
+    }
+    usedAtScan = used - released;
+    return released;
+}
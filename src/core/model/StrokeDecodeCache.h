@@ -0,0 +1,45 @@
+/*
+ * Xournal++
+ *
+ * Bounds the memory used by decoded copies of compact strokes
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+#pragma once
+
+#include <cstddef>
+
+class Document;
+
+/**
+ * Compact strokes (see Stroke::compact()) keep a decoded copy of their points once something needed them as a
+ * std::vector<Point> (edition, eraser, saving...). The copies of the strokes used recently are kept, as they are
+ * likely to be needed again; the others are released here.
+ */
+namespace StrokeDecodeCache {
+
+constexpr size_t DEFAULT_BUDGET = 64 * 1024 * 1024;
+
+/**
+ * @brief Release the decoded copies of the least recently used compact strokes of the document, until the remaining
+ * copies use at most budget bytes.
+ *
+ * Must be called from the main thread, with the document locked: the other threads only read strokes with the
+ * document locked, so no reference to the released points can be in use.
+ *
+ * The strokes are only scanned if points were decoded since the last scan and may exceed the budget: it costs
+ * nothing when no stroke is compact, or when the decoded copies stay well below the budget.
+ *
+ * @return The number of bytes released
+ */
+size_t trim(Document* doc, size_t budget = DEFAULT_BUDGET);
+
+/**
+ * @brief Account for the points of a compact stroke just decoded, see trim(). Thread safe.
+ */
+void addDecoded(size_t bytes);
+
+}  // namespace StrokeDecodeCache
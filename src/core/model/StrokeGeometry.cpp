@@ -0,0 +1,202 @@
+#include "StrokeGeometry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+/**
+ * Larger values are not quantized, so that the deltas cannot overflow
+ */
+constexpr double MAX_QUANTIZED_VALUE = 1e9;
+
+template <typename Float>
+static void fillCoordinates(const std::vector<Point>& points, std::vector<Float>& xs, std::vector<Float>& ys) {
+    xs.reserve(points.size());
+    ys.reserve(points.size());
+    for (auto&& p: points) {
+        xs.push_back(static_cast<Float>(p.x));
+        ys.push_back(static_cast<Float>(p.y));
+    }
+}
+
+template <typename Float>
+static void getCoordinateBounds(const std::vector<Float>& xs, const std::vector<Float>& ys, double& minX,
+                                double& minY, double& maxX, double& maxY) {
+    auto [minXIt, maxXIt] = std::minmax_element(xs.begin(), xs.end());
+    auto [minYIt, maxYIt] = std::minmax_element(ys.begin(), ys.end());
+    minX = *minXIt;
+    maxX = *maxXIt;
+    minY = *minYIt;
+    maxY = *maxYIt;
+}
+
+static auto isQuantizable(double v) -> bool { return std::abs(v) <= MAX_QUANTIZED_VALUE; }
+
+static auto quantize(double v) -> int64_t { return std::llround(v * StrokeGeometry::STEPS_PER_UNIT); }
+
+static void writeDelta(std::vector<uint8_t>& out, int64_t delta) {
+    auto v = (static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63);
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+StrokeGeometry::StrokeGeometry(const std::vector<Point>& points, StrokeStorage storage): storage(storage) {
+    const bool withPressure = !points.empty() && points.front().z != Point::NO_PRESSURE;
+
+    if (storage == StrokeStorage::QUANTIZED) {
+        bool quantizable = std::all_of(points.begin(), points.end(), [withPressure](const Point& p) {
+            return isQuantizable(p.x) && isQuantizable(p.y) && (!withPressure || isQuantizable(p.z));
+        });
+        if (!quantizable) {
+            this->storage = StrokeStorage::COMPACT;
+        }
+    }
+
+    switch (this->storage) {
+        case StrokeStorage::COMPACT_FLOAT:
+            fillCoordinates(points, xf, yf);
+            break;
+        case StrokeStorage::QUANTIZED: {
+            count = points.size();
+            // Typical deltas of hand drawn strokes take 4 bytes
+            encodedPositions.reserve(8 * count);
+            int64_t qx = 0;
+            int64_t qy = 0;
+            for (auto&& p: points) {
+                int64_t x = quantize(p.x);
+                int64_t y = quantize(p.y);
+                writeDelta(encodedPositions, x - qx);
+                writeDelta(encodedPositions, y - qy);
+                qx = x;
+                qy = y;
+            }
+            encodedPositions.shrink_to_fit();
+
+            if (withPressure) {
+                int64_t qz = 0;
+                for (auto&& p: points) {
+                    int64_t z = quantize(p.z);
+                    writeDelta(encodedPressure, z - qz);
+                    qz = z;
+                }
+                encodedPressure.shrink_to_fit();
+            }
+            return;
+        }
+        default:
+            this->storage = StrokeStorage::COMPACT;
+            fillCoordinates(points, xd, yd);
+    }
+
+    if (withPressure) {
+        pressure.reserve(points.size());
+        std::transform(points.begin(), points.end(), std::back_inserter(pressure), [](const Point& p) { return p.z; });
+    }
+}
+
+auto StrokeGeometry::size() const -> size_t {
+    switch (storage) {
+        case StrokeStorage::COMPACT_FLOAT:
+            return xf.size();
+        case StrokeStorage::QUANTIZED:
+            return count;
+        default:
+            return xd.size();
+    }
+}
+
+auto StrokeGeometry::empty() const -> bool { return size() == 0; }
+
+auto StrokeGeometry::hasPressure() const -> bool { return !pressure.empty() || !encodedPressure.empty(); }
+
+auto StrokeGeometry::isSinglePrecision() const -> bool { return storage == StrokeStorage::COMPACT_FLOAT; }
+
+auto StrokeGeometry::getStorage() const -> StrokeStorage { return storage; }
+
+auto StrokeGeometry::hasRandomAccess() const -> bool { return storage != StrokeStorage::QUANTIZED; }
+
+auto StrokeGeometry::getPoint(size_t i) const -> Point {
+    switch (storage) {
+        case StrokeStorage::COMPACT_FLOAT:
+            return Point(xf[i], yf[i], pressure.empty() ? Point::NO_PRESSURE : pressure[i]);
+        case StrokeStorage::QUANTIZED: {
+            const uint8_t* pos = encodedPositions.data();
+            int64_t qx = 0;
+            int64_t qy = 0;
+            for (size_t k = 0; k <= i; ++k) {
+                qx += readDelta(pos);
+                qy += readDelta(pos);
+            }
+            double z = Point::NO_PRESSURE;
+            if (!encodedPressure.empty()) {
+                const uint8_t* pressurePos = encodedPressure.data();
+                int64_t qz = 0;
+                for (size_t k = 0; k <= i; ++k) { qz += readDelta(pressurePos); }
+                z = dequantize(qz);
+            }
+            return Point(dequantize(qx), dequantize(qy), z);
+        }
+        default:
+            return Point(xd[i], yd[i], pressure.empty() ? Point::NO_PRESSURE : pressure[i]);
+    }
+}
+
+auto StrokeGeometry::toPoints() const -> std::vector<Point> {
+    std::vector<Point> points;
+    points.reserve(size());
+    forEachPoint([&points](const Point& p) { points.push_back(p); });
+    return points;
+}
+
+auto StrokeGeometry::getMemoryUsage() const -> size_t {
+    return sizeof(double) * (xd.capacity() + yd.capacity() + pressure.capacity()) +
+           sizeof(float) * (xf.capacity() + yf.capacity()) + encodedPositions.capacity() + encodedPressure.capacity();
+}
+
+void StrokeGeometry::getBounds(double& minX, double& minY, double& maxX, double& maxY, double& maxPressure) const {
+    maxPressure = 0.0;
+    switch (storage) {
+        case StrokeStorage::COMPACT_FLOAT:
+            getCoordinateBounds(xf, yf, minX, minY, maxX, maxY);
+            break;
+        case StrokeStorage::QUANTIZED: {
+            // Work on the integers, and only convert the extremal values
+            const uint8_t* pos = encodedPositions.data();
+            int64_t qx = readDelta(pos);
+            int64_t qy = readDelta(pos);
+            int64_t qMinX = qx, qMaxX = qx, qMinY = qy, qMaxY = qy;
+            for (size_t i = 1; i < count; ++i) {
+                qx += readDelta(pos);
+                qy += readDelta(pos);
+                qMinX = std::min(qMinX, qx);
+                qMaxX = std::max(qMaxX, qx);
+                qMinY = std::min(qMinY, qy);
+                qMaxY = std::max(qMaxY, qy);
+            }
+            minX = dequantize(qMinX);
+            maxX = dequantize(qMaxX);
+            minY = dequantize(qMinY);
+            maxY = dequantize(qMaxY);
+
+            if (!encodedPressure.empty()) {
+                const uint8_t* pressurePos = encodedPressure.data();
+                int64_t qz = readDelta(pressurePos);
+                int64_t qMaxZ = qz;
+                for (size_t i = 1; i < count; ++i) {
+                    qz += readDelta(pressurePos);
+                    qMaxZ = std::max(qMaxZ, qz);
+                }
+                maxPressure = dequantize(qMaxZ);
+            }
+            return;
+        }
+        default:
+            getCoordinateBounds(xd, yd, minX, minY, maxX, maxY);
+    }
+    if (!pressure.empty()) {
+        maxPressure = *std::max_element(pressure.begin(), pressure.end());
+    }
+}
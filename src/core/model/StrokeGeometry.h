@@ -0,0 +1,249 @@
+/*
+ * Xournal++
+ *
+ * Compact storage for the points of a finished stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Point.h"
+
+/**
+ * How the points of finished strokes are stored in memory
+ */
+enum class StrokeStorage {
+    /**
+     * std::vector<Point>, as while the stroke is edited
+     */
+    POINTS = 0,
+    /**
+     * Structure of arrays, pressure only stored if the stroke has pressure
+     */
+    COMPACT = 1,
+    /**
+     * Same as COMPACT, with single precision coordinates
+     */
+    COMPACT_FLOAT = 2,
+    /**
+     * Fixed-point deltas at the precision of the file format, variable length encoded
+     */
+    QUANTIZED = 3
+};
+
+/**
+ * @brief Compact storage for the points of a stroke.
+ *
+ * With StrokeStorage::COMPACT and StrokeStorage::COMPACT_FLOAT, the x and y coordinates are stored in separate arrays,
+ * so loops only reading positions (bounding box, hit tests, path construction) do not pull the pressure values into
+ * the cache.
+ *
+ * With StrokeStorage::QUANTIZED, the coordinates are rounded to multiples of QUANTUM (the precision with which they
+ * are written to .xopp files) and the differences between consecutive points are stored as zigzag varints. Decoding
+ * gives back exactly the values a save/load round trip would give. The points can only be read in order: getPoint()
+ * is linear in the index, see hasRandomAccess().
+ *
+ * In all cases, the pressure values are only stored if the stroke has pressure.
+ * The geometry is immutable: a stroke being edited is converted back to a std::vector<Point>.
+ */
+class StrokeGeometry {
+public:
+    /**
+     * Resolution of StrokeStorage::QUANTIZED, matching Util::PRECISION_FORMAT_STRING
+     */
+    static constexpr double STEPS_PER_UNIT = 1e8;
+    static constexpr double QUANTUM = 1.0 / STEPS_PER_UNIT;
+
+    /**
+     * @param points The points. Pressure values are stored iff points.front().z != Point::NO_PRESSURE
+     * @param storage The format: StrokeStorage::COMPACT, StrokeStorage::COMPACT_FLOAT or StrokeStorage::QUANTIZED.
+     *                Quantization falls back to StrokeStorage::COMPACT if a value is out of the representable range.
+     */
+    StrokeGeometry(const std::vector<Point>& points, StrokeStorage storage);
+
+public:
+    size_t size() const;
+    bool empty() const;
+    bool hasPressure() const;
+    bool isSinglePrecision() const;
+    StrokeStorage getStorage() const;
+
+    /**
+     * @return Whether getPoint() runs in constant time
+     */
+    bool hasRandomAccess() const;
+
+    /**
+     * @return The point of index i, as a Point
+     */
+    Point getPoint(size_t i) const;
+
+    /**
+     * @return All the points, in the format used by Stroke
+     */
+    std::vector<Point> toPoints() const;
+
+    /**
+     * @return The (approximate) heap memory used by this geometry, in bytes
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @brief Call fn(x, y) for every point, in order.
+     */
+    template <typename Fn>
+    void forEachPosition(Fn&& fn) const {
+        switch (storage) {
+            case StrokeStorage::COMPACT_FLOAT:
+                forEachPositionImpl(xf, yf, fn);
+                break;
+            case StrokeStorage::QUANTIZED:
+                findQuantized([&fn](double x, double y) {
+                    fn(x, y);
+                    return false;
+                });
+                break;
+            default:
+                forEachPositionImpl(xd, yd, fn);
+        }
+    }
+
+    /**
+     * @brief Call pred(x, y) for the points, in order, until it returns true.
+     * @return true if pred returned true for some point
+     */
+    template <typename Pred>
+    bool findPosition(Pred&& pred) const {
+        switch (storage) {
+            case StrokeStorage::COMPACT_FLOAT:
+                return findPositionImpl(xf, yf, pred);
+            case StrokeStorage::QUANTIZED:
+                return findQuantized(pred);
+            default:
+                return findPositionImpl(xd, yd, pred);
+        }
+    }
+
+    /**
+     * @brief Call fn(const Point&) for every point (with its pressure), in order.
+     */
+    template <typename Fn>
+    void forEachPoint(Fn&& fn) const {
+        if (storage != StrokeStorage::QUANTIZED) {
+            for (size_t i = 0; i < size(); ++i) { fn(getPoint(i)); }
+            return;
+        }
+
+        const uint8_t* pos = encodedPositions.data();
+        const uint8_t* pressurePos = encodedPressure.data();
+        const bool withPressure = !encodedPressure.empty();
+        int64_t qx = 0;
+        int64_t qy = 0;
+        int64_t qz = 0;
+        for (size_t i = 0; i < count; ++i) {
+            qx += readDelta(pos);
+            qy += readDelta(pos);
+            double z = Point::NO_PRESSURE;
+            if (withPressure) {
+                qz += readDelta(pressurePos);
+                z = dequantize(qz);
+            }
+            fn(Point(dequantize(qx), dequantize(qy), z));
+        }
+    }
+
+    /**
+     * @brief Computes the extremal coordinates of the points, and the maximal pressure (0 if there is no pressure)
+     * Assumes the geometry is not empty
+     */
+    void getBounds(double& minX, double& minY, double& maxX, double& maxY, double& maxPressure) const;
+
+private:
+    template <typename Float, typename Fn>
+    static void forEachPositionImpl(const std::vector<Float>& xs, const std::vector<Float>& ys, Fn& fn) {
+        const size_t n = xs.size();
+        const Float* px = xs.data();
+        const Float* py = ys.data();
+        for (size_t i = 0; i < n; ++i) { fn(static_cast<double>(px[i]), static_cast<double>(py[i])); }
+    }
+
+    template <typename Float, typename Pred>
+    static bool findPositionImpl(const std::vector<Float>& xs, const std::vector<Float>& ys, Pred& pred) {
+        const size_t n = xs.size();
+        for (size_t i = 0; i < n; ++i) {
+            if (pred(static_cast<double>(xs[i]), static_cast<double>(ys[i]))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    template <typename Pred>
+    bool findQuantized(Pred&& pred) const {
+        const uint8_t* pos = encodedPositions.data();
+        int64_t qx = 0;
+        int64_t qy = 0;
+        for (size_t i = 0; i < count; ++i) {
+            qx += readDelta(pos);
+            qy += readDelta(pos);
+            if (pred(dequantize(qx), dequantize(qy))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Reads a zigzag encoded varint and advances pos past it
+     */
+    static inline int64_t readDelta(const uint8_t*& pos) {
+        uint64_t v = *pos++;
+        if (v & 0x80) {
+            v &= 0x7f;
+            int shift = 7;
+            uint8_t b = 0;
+            do {
+                b = *pos++;
+                v |= static_cast<uint64_t>(b & 0x7f) << shift;
+                shift += 7;
+            } while (b & 0x80);
+        }
+        return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1);
+    }
+
+    /**
+     * Division (not multiplication by 1 / QUANTUM): this gives the double nearest to the decimal value, as parsing the
+     * saved file would
+     */
+    static inline double dequantize(int64_t q) { return static_cast<double>(q) / STEPS_PER_UNIT; }
+
+private:
+    StrokeStorage storage;
+
+    // Only one of those pairs is in use with COMPACT and COMPACT_FLOAT
+    std::vector<double> xd;
+    std::vector<double> yd;
+    std::vector<float> xf;
+    std::vector<float> yf;
+
+    /**
+     * Empty if the stroke has no pressure, or is quantized
+     */
+    std::vector<double> pressure;
+
+    /**
+     * QUANTIZED: number of points, the deltas of x and y (interleaved), and the deltas of the pressure (empty if the
+     * stroke has no pressure)
+     */
+    size_t count = 0;
+    std::vector<uint8_t> encodedPositions;
+    std::vector<uint8_t> encodedPressure;
+};
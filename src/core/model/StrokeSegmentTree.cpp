@@ -0,0 +1,122 @@
+#include "StrokeSegmentTree.h"
+
+#include <limits>
+
+#include "StrokeGeometry.h"
+
+using xoj::util::Rectangle;
+
+/**
+ * @param forEachPosition Calls its argument with the coordinates of the points, in order
+ * @return The boxes of the leaves
+ */
+template <class ForEachPosition>
+static auto leafBoxes(size_t segmentCount, ForEachPosition&& forEachPosition) -> std::vector<Rectangle<double>> {
+    struct Bounds {
+        double minX = std::numeric_limits<double>::max();
+        double minY = std::numeric_limits<double>::max();
+        double maxX = std::numeric_limits<double>::lowest();
+        double maxY = std::numeric_limits<double>::lowest();
+
+        void add(double x, double y) {
+            minX = std::min(minX, x);
+            minY = std::min(minY, y);
+            maxX = std::max(maxX, x);
+            maxY = std::max(maxY, y);
+        }
+    };
+
+    // The leaf j holds the segments [j * LEAF_SIZE, (j + 1) * LEAF_SIZE), i.e. the points [j * LEAF_SIZE, (j + 1) *
+    // LEAF_SIZE]: the points at the border of two leaves belong to both
+    const size_t leafSize = StrokeSegmentTree::LEAF_SIZE;
+    std::vector<Bounds> bounds((segmentCount + leafSize - 1) / leafSize);
+    size_t i = 0;
+    forEachPosition([&](double x, double y) {
+        size_t leaf = i / leafSize;
+        if (leaf < bounds.size()) {
+            bounds[leaf].add(x, y);
+        }
+        if (leaf > 0 && i % leafSize == 0) {
+            bounds[leaf - 1].add(x, y);
+        }
+        i++;
+    });
+
+    std::vector<Rectangle<double>> leaves;
+    leaves.reserve(bounds.size());
+    for (const Bounds& b: bounds) { leaves.emplace_back(b.minX, b.minY, b.maxX - b.minX, b.maxY - b.minY); }
+    return leaves;
+}
+
+StrokeSegmentTree::StrokeSegmentTree(const std::vector<Point>& points):
+        segmentCount(points.size() < 2 ? 0 : points.size() - 1) {
+    if (this->segmentCount == 0) {
+        return;
+    }
+
+    build(leafBoxes(this->segmentCount, [&points](auto&& fn) {
+        for (const Point& p: points) { fn(p.x, p.y); }
+    }));
+}
+
+StrokeSegmentTree::StrokeSegmentTree(const StrokeGeometry& geometry):
+        segmentCount(geometry.size() < 2 ? 0 : geometry.size() - 1) {
+    if (this->segmentCount == 0) {
+        return;
+    }
+
+    build(leafBoxes(this->segmentCount, [&geometry](auto&& fn) { geometry.forEachPosition(fn); }));
+}
+
+void StrokeSegmentTree::build(std::vector<Rectangle<double>> leaves) {
+    this->levels.push_back(std::move(leaves));
+
+    while (this->levels.back().size() > 1) {
+        const auto& children = this->levels.back();
+        std::vector<Rectangle<double>> parents;
+        parents.reserve((children.size() + 1) / 2);
+        for (size_t i = 0; i < children.size(); i += 2) {
+            Rectangle<double> box = children[i];
+            if (i + 1 < children.size()) {
+                box.unite(children[i + 1]);
+            }
+            parents.push_back(box);
+        }
+        this->levels.push_back(std::move(parents));
+    }
+}
+
+auto StrokeSegmentTree::getSegmentCount() const -> size_t { return this->segmentCount; }
+
+auto StrokeSegmentTree::touches(const Rectangle<double>& a, const Rectangle<double>& b) -> bool {
+    return a.x <= b.x + b.width && b.x <= a.x + a.width && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+auto StrokeSegmentTree::findSegments(const Rectangle<double>& rect, size_t firstSegment, size_t lastSegment) const
+        -> std::vector<Interval<size_t>> {
+    std::vector<Interval<size_t>> result;
+    if (this->segmentCount == 0 || firstSegment > lastSegment) {
+        return result;
+    }
+    lastSegment = std::min(lastSegment, this->segmentCount - 1);
+
+    traverse(
+            [&](const Rectangle<double>& box, size_t first, size_t last) {
+                return last >= firstSegment && first <= lastSegment && touches(box, rect);
+            },
+            [&](size_t first, size_t last) {
+                first = std::max(first, firstSegment);
+                last = std::min(last, lastSegment);
+                if (!result.empty() && result.back().max + 1 == first) {
+                    result.back().max = last;
+                } else {
+                    result.emplace_back(first, last);
+                }
+                return true;
+            });
+    return result;
+}
+
+auto StrokeSegmentTree::findSegments(const Rectangle<double>& rect) const -> std::vector<Interval<size_t>> {
+    return findSegments(rect, 0, this->segmentCount == 0 ? 0 : this->segmentCount - 1);
+}
@@ -0,0 +1,117 @@
+/*
+ * Xournal++
+ *
+ * Bounding volume hierarchy of the segments of a stroke
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "util/Interval.h"
+#include "util/Rectangle.h"
+
+#include "Point.h"
+
+class StrokeGeometry;
+
+/**
+ * @brief Bounding boxes of the segments of a stroke, grouped into a binary tree, so that the segments close to a
+ * rectangle are found in logarithmic time.
+ *
+ * The segment i goes from the point i to the point i + 1. The leaves hold the bounding boxes of LEAF_SIZE consecutive
+ * segments, and each node the union of the boxes of its two children. The boxes do not account for the stroke width:
+ * queries must pad their rectangles accordingly.
+ *
+ * The tree is a snapshot of the points it was built from: it must be rebuilt after any change of the geometry.
+ */
+class StrokeSegmentTree {
+public:
+    static constexpr size_t LEAF_SIZE = 16;
+
+    /**
+     * Strokes with fewer points are searched linearly: the tree would not pay off
+     */
+    static constexpr size_t MIN_POINTS = 128;
+
+    explicit StrokeSegmentTree(const std::vector<Point>& points);
+
+    /**
+     * Builds the tree of a compact stroke, without decoding its geometry
+     */
+    explicit StrokeSegmentTree(const StrokeGeometry& geometry);
+
+    size_t getSegmentCount() const;
+
+    /**
+     * @return The maximal intervals of consecutive segments among [firstSegment, lastSegment] whose leaf intersects the
+     * (closed) rectangle, in increasing order. Every segment intersecting the rectangle is in one of them.
+     */
+    std::vector<Interval<size_t>> findSegments(const xoj::util::Rectangle<double>& rect, size_t firstSegment,
+                                               size_t lastSegment) const;
+
+    std::vector<Interval<size_t>> findSegments(const xoj::util::Rectangle<double>& rect) const;
+
+    /**
+     * Depth first traversal of the nodes, in the order of the segments.
+     *
+     * @param enter Called as enter(box, firstSegment, lastSegment) for every node reached, with the box and the
+     * segments of the node: the subtree is skipped if it returns false
+     * @param leaf Called as leaf(firstSegment, lastSegment) for every leaf entered: the traversal stops if it returns
+     * false
+     * @return false if the traversal was stopped
+     */
+    template <class Enter, class Leaf>
+    bool traverse(Enter&& enter, Leaf&& leaf) const {
+        if (this->levels.empty()) {
+            return true;
+        }
+        return traverse(this->levels.size() - 1, 0, enter, leaf);
+    }
+
+    /**
+     * @return Whether the closed rectangles a and b intersect (unlike Rectangle::intersects, touching counts)
+     */
+    static bool touches(const xoj::util::Rectangle<double>& a, const xoj::util::Rectangle<double>& b);
+
+private:
+    template <class Enter, class Leaf>
+    bool traverse(size_t level, size_t node, Enter& enter, Leaf& leaf) const {
+        size_t first = (node << level) * LEAF_SIZE;
+        size_t last = std::min(((node + 1) << level) * LEAF_SIZE, this->segmentCount) - 1;
+        if (!enter(this->levels[level][node], first, last)) {
+            return true;
+        }
+        if (level == 0) {
+            return leaf(first, last);
+        }
+        const auto& children = this->levels[level - 1];
+        for (size_t child = 2 * node; child < std::min(2 * node + 2, children.size()); child++) {
+            if (!traverse(level - 1, child, enter, leaf)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    /**
+     * Builds the levels above the leaves
+     */
+    void build(std::vector<xoj::util::Rectangle<double>> leaves);
+
+private:
+    size_t segmentCount = 0;
+
+    /**
+     * levels[0] holds the leaves, levels.back() the root. The node j of a level has the children 2j and 2j + 1.
+     */
+    std::vector<std::vector<xoj::util::Rectangle<double>>> levels;
+};
@@ -1,5 +1,6 @@
 #include "TexImage.h"
 
+#include <atomic>
 #include <utility>
 
 #include "util/pixbuf-utils.h"
@@ -8,7 +9,10 @@
 
 using xoj::util::Rectangle;
 
-TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) { this->sizeCalculated = true; }
+TexImage::TexImage(): Element(ELEMENT_TEXIMAGE) {
+    this->sizeCalculated = true;
+    updateRenderRevision();
+}
 
 TexImage::~TexImage() { freeImageAndPdf(); }
 
@@ -18,10 +22,22 @@ void TexImage::freeImageAndPdf() {
         this->image = nullptr;
     }
 
+    if (this->page) {
+        g_object_unref(this->page);
+        this->page = nullptr;
+    }
+
     if (this->pdf) {
         g_object_unref(this->pdf);
         this->pdf = nullptr;
     }
+
+    updateRenderRevision();
+}
+
+void TexImage::updateRenderRevision() {
+    static std::atomic<uint64_t> nextRevision{1};
+    this->renderRevision = nextRevision++;
 }
 
 auto TexImage::clone() const -> Element* {
@@ -33,7 +49,7 @@ auto TexImage::clone() const -> Element* {
     img->height = this->height;
     img->text = this->text;
     img->snappedBounds = this->snappedBounds;
-    img->sizeCalculated = this->sizeCalculated;
+    img->sizeCalculated = this->sizeCalculated.load();
 
     // Clone has a copy of our PDF.
     img->pdf = this->pdf;
@@ -50,11 +66,13 @@ auto TexImage::clone() const -> Element* {
 void TexImage::setWidth(double width) {
     this->width = width;
     this->calcSize();
+    updateRenderRevision();
 }
 
 void TexImage::setHeight(double height) {
     this->height = height;
     this->calcSize();
+    updateRenderRevision();
 }
 
 auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned int length) -> cairo_status_t {
@@ -73,7 +91,10 @@ auto TexImage::cairoReadFunction(TexImage* image, unsigned char* data, unsigned
  */
 auto TexImage::getBinaryData() const -> std::string const& { return this->binaryData; }
 
-void TexImage::setText(std::string text) { this->text = std::move(text); }
+void TexImage::setText(std::string text) {
+    this->text = std::move(text);
+    updateRenderRevision();
+}
 
 auto TexImage::getText() const -> std::string { return this->text; }
 
@@ -91,10 +112,9 @@ auto TexImage::loadData(std::string&& bytes, GError** err) -> bool {
         if (!pdf || poppler_document_get_n_pages(this->pdf) < 1) {
             return false;
         }
+        this->page = poppler_document_get_page(this->pdf, 0);
         if (!this->width && !this->height) {
-            PopplerPage* page = poppler_document_get_page(this->pdf, 0);
-            poppler_page_get_size(page, &this->width, &this->height);
-            g_object_unref(page);
+            poppler_page_get_size(this->page, &this->width, &this->height);
         }
     } else if (type == "PNG") {
         this->image = cairo_image_surface_create_from_png_stream(
@@ -110,6 +130,10 @@ auto TexImage::getImage() const -> cairo_surface_t* { return this->image; }
 
 auto TexImage::getPdf() const -> PopplerDocument* { return this->pdf; }
 
+auto TexImage::getPdfPage() const -> PopplerPage* { return this->page; }
+
+auto TexImage::getRenderRevision() const -> uint64_t { return this->renderRevision; }
+
 void TexImage::scale(double x0, double y0, double fx, double fy, double rotation,
                      bool) {  // line width scaling option is not used
 
@@ -119,6 +143,7 @@ void TexImage::scale(double x0, double y0, double fx, double fy, double rotation
     this->width *= fx;
     this->height *= fy;
     this->calcSize();
+    updateRenderRevision();
 }
 
 void TexImage::rotate(double x0, double y0, double th) {
@@ -155,6 +180,7 @@ void TexImage::readSerialized(ObjectInputStream& in) {
     in.readData(reinterpret_cast<void**>(&data), &len);
 
     this->loadData(std::string(data, len), nullptr);
+    g_free(data);
 
     in.endObject();
     this->calcSize();
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -50,6 +51,17 @@ public:
      */
     PopplerDocument* getPdf() const;
 
+    /**
+     * @return The first page of the PDF, kept open as long as the PDF is loaded. nullptr if not rendered as a PDF.
+     */
+    PopplerPage* getPdfPage() const;
+
+    /**
+     * @return An identifier of the rendered content (PDF, text and size). It changes whenever one of them changes, and
+     * is never shared by two TexImages.
+     */
+    uint64_t getRenderRevision() const;
+
     void scale(double x0, double y0, double fx, double fy, double rotation, bool restoreLineWidth) override;
     void rotate(double x0, double y0, double th) override;
 
@@ -79,12 +91,24 @@ private:
      */
     void freeImageAndPdf();
 
+    /**
+     * The rendering changed: take a new render revision
+     */
+    void updateRenderRevision();
+
 private:
     /**
      * Tex PDF Document, if rendered as PDF
      */
     PopplerDocument* pdf = nullptr;
 
+    /**
+     * First page of pdf
+     */
+    PopplerPage* page = nullptr;
+
+    uint64_t renderRevision = 0;
+
     /**
      * Tex image, if rendered as image. Note: this is deprecated and subject to removal in a later version.
      */
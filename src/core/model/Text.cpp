@@ -1,5 +1,6 @@
 #include "Text.h"
 
+#include <atomic>
 #include <utility>
 
 #include "util/Stacktrace.h"
@@ -12,6 +13,7 @@ using xoj::util::Rectangle;
 Text::Text(): AudioElement(ELEMENT_TEXT) {
     this->font.setName("Sans");
     this->font.setSize(12);
+    updateTextRevision();
 }
 
 Text::~Text() = default;
@@ -27,7 +29,7 @@ auto Text::clone() const -> Element* {
     text->height = this->height;
     text->cloneAudioData(this);
     text->snappedBounds = this->snappedBounds;
-    text->sizeCalculated = this->sizeCalculated;
+    text->sizeCalculated = this->sizeCalculated.load();
     text->inEditing = this->inEditing;
 
     return text;
@@ -45,10 +47,18 @@ auto Text::getText() const -> std::string { return this->text; }
 
 void Text::setText(std::string text) {
     this->text = std::move(text);
+    updateTextRevision();
 
     calcSize();
 }
 
+auto Text::getTextRevision() const -> uint64_t { return this->textRevision; }
+
+void Text::updateTextRevision() {
+    static std::atomic<uint64_t> nextRevision{1};
+    this->textRevision = nextRevision++;
+}
+
 void Text::calcSize() const {
     xoj::view::TextView::calcSize(this, this->width, this->height);
     this->updateSnapping();
@@ -124,6 +134,7 @@ void Text::readSerialized(ObjectInputStream& in) {
     this->AudioElement::readSerialized(in);
 
     this->text = in.readString();
+    updateTextRevision();
 
     font.readSerialized(in);
 
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 #include <gtk/gtk.h>
 
 #include "AudioElement.h"
@@ -31,6 +33,11 @@ public:
     std::string getText() const;
     void setText(std::string text);
 
+    /**
+     * @return An identifier of the text content. It changes whenever the text changes, and is never shared by two Texts.
+     */
+    uint64_t getTextRevision() const;
+
     void setWidth(double width);
     void setHeight(double height);
 
@@ -59,10 +66,17 @@ protected:
     void calcSize() const override;
     void updateSnapping() const;
 
+    /**
+     * The text changed: take a new text revision
+     */
+    void updateTextRevision();
+
 private:
     XojFont font;
 
     std::string text;
 
+    uint64_t textRevision = 0;
+
     bool inEditing = false;
 };
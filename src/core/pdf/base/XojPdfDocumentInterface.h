@@ -30,7 +30,10 @@ public:
 public:
     virtual bool save(fs::path const& file, GError** error) const = 0;
     virtual bool load(fs::path const& file, std::string password, GError** error) = 0;
-    virtual bool load(gpointer data, gsize length, std::string password, GError** error) = 0;
+    /**
+     * Load the document from memory. The bytes are referenced as long as the document is loaded.
+     */
+    virtual bool load(GBytes* bytes, std::string password, GError** error) = 0;
     virtual bool isLoaded() const = 0;
 
     virtual XojPdfPageSPtr getPage(size_t page) const = 0;
@@ -17,6 +17,8 @@
 
 #include <cairo/cairo.h>
 
+class XojPdfTextLayout;
+
 /// Determines how text is selected on a user action.
 enum class XojPdfPageSelectionStyle : uint8_t {
     /// Standard selection, where all text between start and end positions is selected.
@@ -64,6 +66,14 @@ public:
 
     virtual std::vector<XojPdfRectangle> findText(std::string& text) = 0;
 
+    /// @return All the text of the page, in reading order (UTF-8)
+    virtual std::string getText() = 0;
+
+    /// Extract the positions of all the characters of the page. This is slow.
+    /// @return The layout, which answers the text selection queries without
+    /// the PDF backend
+    virtual std::shared_ptr<XojPdfTextLayout> getTextLayout() = 0;
+
     /// Retrieve the text contained in the provided rectangle using the given
     /// selection style.
     /// @param rect start and end points
@@ -0,0 +1,182 @@
+#include "XojPdfTextLayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/**
+ * @return The length in bytes of the UTF-8 character starting with the byte c
+ */
+static auto utf8CharLength(unsigned char c) -> size_t {
+    if (c < 0x80) {
+        return 1;
+    }
+    if ((c >> 5) == 0x6) {
+        return 2;
+    }
+    if ((c >> 4) == 0xE) {
+        return 3;
+    }
+    return 4;
+}
+
+static auto isSameLine(const XojPdfRectangle& r1, const XojPdfRectangle& r2) -> bool {
+    const auto eps = 1e-5;
+    return std::abs(r1.y1 - r2.y1) < eps && std::abs(r1.y2 - r2.y2) < eps;
+}
+
+XojPdfTextLayout::XojPdfTextLayout(const std::string& text, const std::vector<XojPdfRectangle>& charRects):
+        text(text) {
+    chars.reserve(charRects.size());
+
+    size_t pos = 0;
+    bool afterNewline = false;
+    for (const XojPdfRectangle& r: charRects) {
+        if (pos >= this->text.size()) {
+            break;
+        }
+        const size_t len = std::min(utf8CharLength(static_cast<unsigned char>(this->text[pos])), this->text.size() - pos);
+        const char c = this->text[pos];
+
+        Char ch{{std::min(r.x1, r.x2), std::min(r.y1, r.y2), std::max(r.x1, r.x2), std::max(r.y1, r.y2)},
+                0,
+                pos,
+                pos + len,
+                c == ' ' || c == '\t' || c == '\n' || c == '\r'};
+        pos += len;
+
+        if (chars.empty() || afterNewline || !isSameLine(chars.back().rect, ch.rect)) {
+            lines.push_back({chars.size(), chars.size(), ch.rect.x1, ch.rect.y1, ch.rect.x2, ch.rect.y2});
+        }
+        Line& line = lines.back();
+        ch.line = lines.size() - 1;
+        line.last = chars.size() + 1;
+        if (c != '\n') {
+            line.x1 = std::min(line.x1, ch.rect.x1);
+            line.x2 = std::max(line.x2, ch.rect.x2);
+            line.y1 = std::min(line.y1, ch.rect.y1);
+            line.y2 = std::max(line.y2, ch.rect.y2);
+        }
+        afterNewline = c == '\n';
+
+        chars.push_back(ch);
+    }
+}
+
+auto XojPdfTextLayout::empty() const -> bool { return chars.empty(); }
+
+auto XojPdfTextLayout::getCharCount() const -> size_t { return chars.size(); }
+
+auto XojPdfTextLayout::getLineCount() const -> size_t { return lines.size(); }
+
+auto XojPdfTextLayout::charIndexAt(double x, double y) const -> size_t {
+    if (lines.empty()) {
+        return 0;
+    }
+
+    // The line containing the point, or else the vertically nearest one (the horizontally nearest one among the lines
+    // at the same height, e.g. in different columns)
+    const Line* nearest = &lines.front();
+    double minDy = std::numeric_limits<double>::max();
+    double minDx = std::numeric_limits<double>::max();
+    for (const Line& line: lines) {
+        const double dx = std::max({line.x1 - x, 0.0, x - line.x2});
+        const double dy = std::max({line.y1 - y, 0.0, y - line.y2});
+        if (dy < minDy || (dy == minDy && dx < minDx)) {
+            minDy = dy;
+            minDx = dx;
+            nearest = &line;
+            if (dx == 0 && dy == 0) {
+                break;
+            }
+        }
+    }
+
+    // Also outside of the line (above, below or in the margins), the position only depends on x
+    for (size_t i = nearest->first; i < nearest->last; i++) {
+        if (x < (chars[i].rect.x1 + chars[i].rect.x2) / 2) {
+            return i;
+        }
+    }
+    return nearest->last;
+}
+
+auto XojPdfTextLayout::getSelectedRange(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) const
+        -> std::pair<size_t, size_t> {
+    size_t first = charIndexAt(rect.x1, rect.y1);
+    size_t last = charIndexAt(rect.x2, rect.y2);
+    if (first > last) {
+        std::swap(first, last);
+    }
+
+    const size_t n = chars.size();
+    if (style == XojPdfPageSelectionStyle::Word) {
+        while (first > 0 && first < n && chars[first - 1].line == chars[first].line && !chars[first - 1].whitespace) {
+            first--;
+        }
+        while (last < n && !chars[last].whitespace && (last == first || chars[last].line == chars[last - 1].line)) {
+            last++;
+        }
+    } else if (style == XojPdfPageSelectionStyle::Line) {
+        if (first < n) {
+            const size_t lastLine = last > first ? chars[last - 1].line : chars[first].line;
+            first = lines[chars[first].line].first;
+            last = lines[lastLine].last;
+        }
+    }
+
+    return {first, last};
+}
+
+auto XojPdfTextLayout::getLineRects(size_t first, size_t last) const -> std::vector<XojPdfRectangle> {
+    std::vector<XojPdfRectangle> rects;
+    if (first >= last) {
+        return rects;
+    }
+
+    for (size_t l = chars[first].line; l <= chars[last - 1].line; l++) {
+        const Line& line = lines[l];
+        double x1 = std::numeric_limits<double>::max();
+        double x2 = std::numeric_limits<double>::lowest();
+        for (size_t i = std::max(first, line.first); i < std::min(last, line.last); i++) {
+            if (this->text[chars[i].begin] == '\n') {
+                continue;
+            }
+            x1 = std::min(x1, chars[i].rect.x1);
+            x2 = std::max(x2, chars[i].rect.x2);
+        }
+        if (x1 <= x2) {
+            rects.emplace_back(x1, line.y1, x2, line.y2);
+        }
+    }
+    return rects;
+}
+
+auto XojPdfTextLayout::selectTextRegion(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) const
+        -> cairo_region_t* {
+    return selectTextLines(rect, style).region;
+}
+
+auto XojPdfTextLayout::selectTextLines(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) const
+        -> XojPdfPage::TextSelection {
+    auto [first, last] = getSelectedRange(rect, style);
+    std::vector<XojPdfRectangle> rects = getLineRects(first, last);
+
+    cairo_region_t* region = cairo_region_create();
+    for (const XojPdfRectangle& r: rects) {
+        const int x1 = static_cast<int>(std::floor(r.x1));
+        const int y1 = static_cast<int>(std::floor(r.y1));
+        cairo_rectangle_int_t crect = {x1, y1, static_cast<int>(std::ceil(r.x2)) - x1,
+                                       static_cast<int>(std::ceil(r.y2)) - y1};
+        cairo_region_union_rectangle(region, &crect);
+    }
+    return {region, std::move(rects)};
+}
+
+auto XojPdfTextLayout::selectText(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) const -> std::string {
+    auto [first, last] = getSelectedRange(rect, style);
+    if (first >= last) {
+        return "";
+    }
+    return this->text.substr(chars[first].begin, chars[last - 1].end - chars[first].begin);
+}
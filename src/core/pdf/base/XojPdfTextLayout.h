@@ -0,0 +1,97 @@
+/*
+ * Xournal++
+ *
+ * Position of the characters of a PDF page, for text selection
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <cairo/cairo.h>
+
+#include "XojPdfPage.h"
+
+/**
+ * @brief The characters of a PDF page with their bounding boxes, grouped in lines.
+ *
+ * Extracting this layout from the PDF is slow, but once it is known, the text selection queries (selected region, line
+ * rectangles and text) are answered without the PDF backend: this is used while the user drags a text selection.
+ *
+ * Only the XojPdfPageSelectionStyle::Linear, Word and Line styles are supported. The selection goes, in reading order,
+ * from the character at the start point to the one at the end point, and is extended to whole words or lines.
+ */
+class XojPdfTextLayout {
+public:
+    /**
+     * @param text The text of the page (UTF-8), one bounding box per character
+     * @param charRects The bounding boxes of the characters of text, in reading order, in page coordinates
+     */
+    XojPdfTextLayout(const std::string& text, const std::vector<XojPdfRectangle>& charRects);
+
+public:
+    bool empty() const;
+    size_t getCharCount() const;
+    size_t getLineCount() const;
+
+    /**
+     * @return The region covered by the selected characters, line by line
+     */
+    cairo_region_t* selectTextRegion(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) const;
+
+    /**
+     * @return The same as XojPdfPage::selectTextLines(): one rectangle per selected line
+     */
+    XojPdfPage::TextSelection selectTextLines(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) const;
+
+    /**
+     * @return The selected text
+     */
+    std::string selectText(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) const;
+
+    /**
+     * @return The range [first, last) of the characters selected between the start (x1, y1) and end (x2, y2) points
+     */
+    std::pair<size_t, size_t> getSelectedRange(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) const;
+
+private:
+    struct Char {
+        XojPdfRectangle rect;
+        size_t line;
+        /**
+         * Position of the character in text, in bytes
+         */
+        size_t begin;
+        size_t end;
+        bool whitespace;
+    };
+
+    struct Line {
+        size_t first;
+        size_t last;
+        double x1;
+        double y1;
+        double x2;
+        double y2;
+    };
+
+    /**
+     * @return The index of the character before which the point (x, y) is, in reading order
+     */
+    size_t charIndexAt(double x, double y) const;
+
+    std::vector<XojPdfRectangle> getLineRects(size_t first, size_t last) const;
+
+private:
+    std::string text;
+    std::vector<Char> chars;
+    std::vector<Line> lines;
+};
@@ -13,28 +13,40 @@ using std::string;
 
 PopplerGlibDocument::PopplerGlibDocument() = default;
 
-PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc): document(doc.document) {
+PopplerGlibDocument::PopplerGlibDocument(const PopplerGlibDocument& doc): document(doc.document), bytes(doc.bytes) {
     if (document) {
         g_object_ref(document);
     }
+    if (bytes) {
+        g_bytes_ref(bytes);
+    }
 }
 
-PopplerGlibDocument::~PopplerGlibDocument() {
+PopplerGlibDocument::~PopplerGlibDocument() { unload(); }
+
+void PopplerGlibDocument::unload() {
     if (document) {
         g_object_unref(document);
         document = nullptr;
     }
+    if (bytes) {
+        g_bytes_unref(bytes);
+        bytes = nullptr;
+    }
 }
 
 void PopplerGlibDocument::assign(XojPdfDocumentInterface* doc) {
-    if (document) {
-        g_object_unref(document);
+    auto* other = dynamic_cast<PopplerGlibDocument*>(doc);
+    if (other->document) {
+        g_object_ref(other->document);
     }
-
-    document = (dynamic_cast<PopplerGlibDocument*>(doc))->document;
-    if (document) {
-        g_object_ref(document);
+    if (other->bytes) {
+        g_bytes_ref(other->bytes);
     }
+    unload();
+
+    document = other->document;
+    bytes = other->bytes;
 }
 
 auto PopplerGlibDocument::equals(XojPdfDocumentInterface* doc) const -> bool {
@@ -59,22 +71,24 @@ auto PopplerGlibDocument::load(fs::path const& file, string password, GError** e
         return false;
     }
 
-    if (document) {
-        g_object_unref(document);
-        document = nullptr;
-    }
+    unload();
 
     this->document = poppler_document_new_from_file(uri->c_str(), password.c_str(), error);
     return this->document != nullptr;
 }
 
-auto PopplerGlibDocument::load(gpointer data, gsize length, string password, GError** error) -> bool {
-    if (document) {
-        g_object_unref(document);
+auto PopplerGlibDocument::load(GBytes* bytes, string password, GError** error) -> bool {
+    g_bytes_ref(bytes);
+    unload();
+
+    gsize length = 0;
+    auto* data = static_cast<char*>(const_cast<void*>(g_bytes_get_data(bytes, &length)));
+    this->document = poppler_document_new_from_data(data, static_cast<int>(length), password.c_str(), error);
+    if (this->document) {
+        this->bytes = bytes;
+    } else {
+        g_bytes_unref(bytes);
     }
-
-    this->document =
-            poppler_document_new_from_data(static_cast<char*>(data), static_cast<int>(length), password.c_str(), error);
     return this->document != nullptr;
 }
 
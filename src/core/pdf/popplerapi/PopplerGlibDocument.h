@@ -30,13 +30,24 @@ public:
 public:
     bool save(fs::path const& filepath, GError** error) const override;
     bool load(fs::path const& filepath, std::string password, GError** error) override;
-    bool load(gpointer data, gsize length, std::string password, GError** error) override;
+    bool load(GBytes* bytes, std::string password, GError** error) override;
     bool isLoaded() const override;
 
     XojPdfPageSPtr getPage(size_t page) const override;
     size_t getPageCount() const override;
     XojPdfBookmarkIterator* getContentsIter() const override;
 
+private:
+    /**
+     * Release the document, and the bytes it was loaded from
+     */
+    void unload();
+
 private:
     PopplerDocument* document = nullptr;
+
+    /**
+     * The data of a document loaded from memory, which Poppler does not copy
+     */
+    GBytes* bytes = nullptr;
 };
@@ -6,6 +6,7 @@
 #include <poppler.h>
 
 #include "pdf/base/XojPdfPage.h"
+#include "pdf/base/XojPdfTextLayout.h"
 #include "util/GListView.h"
 #include "util/Rectangle.h"
 
@@ -86,6 +87,33 @@ auto PopplerGlibPage::findText(std::string& text) -> std::vector<XojPdfRectangle
     return findings;
 }
 
+auto PopplerGlibPage::getText() -> std::string {
+    char* text = poppler_page_get_text(page);
+    if (text == nullptr) {
+        return "";
+    }
+    std::string result = text;
+    g_free(text);
+    return result;
+}
+
+auto PopplerGlibPage::getTextLayout() -> std::shared_ptr<XojPdfTextLayout> {
+    std::string text = getText();
+
+    PopplerRectangle* rectArray = nullptr;
+    guint numRects = 0;
+    std::vector<XojPdfRectangle> charRects;
+    if (poppler_page_get_text_layout(this->page, &rectArray, &numRects)) {
+        charRects.reserve(numRects);
+        for (guint i = 0; i < numRects; i++) {
+            charRects.emplace_back(rectArray[i].x1, rectArray[i].y1, rectArray[i].x2, rectArray[i].y2);
+        }
+        g_free(rectArray);
+    }
+
+    return std::make_shared<XojPdfTextLayout>(text, charRects);
+}
+
 auto getPopplerSelectionStyle(XojPdfPageSelectionStyle style) -> PopplerSelectionStyle {
     switch (style) {
         case XojPdfPageSelectionStyle::Word:
@@ -32,6 +32,10 @@ public:
 
     std::vector<XojPdfRectangle> findText(std::string& text) override;
 
+    std::string getText() override;
+
+    std::shared_ptr<XojPdfTextLayout> getTextLayout() override;
+
     std::string selectText(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override;
 
     cairo_region_t* selectTextRegion(const XojPdfRectangle& rect, XojPdfPageSelectionStyle style) override;
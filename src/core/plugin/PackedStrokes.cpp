@@ -0,0 +1,50 @@
+#include "PackedStrokes.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <cstring>
+#include <utility>
+
+#include <glib.h>
+
+#include "model/Point.h"
+#include "model/Stroke.h"
+
+auto createPackedStrokes(const char* data, const std::vector<size_t>& counts, bool pressure, const Stroke& style)
+        -> std::vector<Element*> {
+    const size_t stride = pressure ? 3 : 2;
+
+    // The buffer may not be aligned for doubles
+    auto readDouble = [data](size_t i) {
+        double value;
+        std::memcpy(&value, data + i * sizeof(double), sizeof(double));
+        return value;
+    };
+
+    std::vector<Element*> strokes;
+    strokes.reserve(counts.size());
+    size_t first = 0;
+    for (size_t count: counts) {
+        if (count < 2) {
+            g_warning("Stroke shorter than two points. Discarding. (Has %zu/2)", count);
+            first += count;
+            continue;
+        }
+
+        std::vector<Point> points;
+        points.reserve(count);
+        for (size_t i = first; i < first + count; i++) {
+            double z = pressure ? readDouble(3 * i + 2) : Point::NO_PRESSURE;
+            points.emplace_back(readDouble(stride * i), readDouble(stride * i + 1), z);
+        }
+        first += count;
+
+        auto* stroke = new Stroke();
+        stroke->applyStyleFrom(&style);
+        stroke->setPointVector(std::move(points));
+        strokes.push_back(stroke);
+    }
+    return strokes;
+}
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * Xournal++
+ *
+ * Strokes read from a packed buffer of coordinates, for app.addStrokesPacked
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "config-features.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <cstddef>
+#include <vector>
+
+class Element;
+class Stroke;
+
+/**
+ * @brief Create strokes from a buffer of native doubles: x, y pairs, or x, y, pressure triples if pressure is true.
+ *
+ * @param data The buffer, which does not need to be aligned for doubles
+ * @param counts Number of points of each stroke, in order. They must add up to the number of points of the buffer.
+ *        Strokes shorter than two points are discarded.
+ * @param style The strokes get the attributes of this one
+ * @return The new strokes, owned by the caller
+ */
+auto createPackedStrokes(const char* data, const std::vector<size_t>& counts, bool pressure, const Stroke& style)
+        -> std::vector<Element*>;
+
+#endif
@@ -145,30 +145,30 @@ void Plugin::registerXournalppLibs(lua_State* luaPtr) {
     }
 }
 
-void Plugin::addPluginToLuaPath() {
-    lua_getglobal(lua.get(), "package");
+void Plugin::addPluginToLuaPath(lua_State* luaPtr, fs::path const& path) {
+    lua_getglobal(luaPtr, "package");
 
     // get field "path" from table at top of stack (-1)
-    lua_getfield(lua.get(), -1, "path");
+    lua_getfield(luaPtr, -1, "path");
 
     // grab path string from top of stack
-    std::string luaPath = lua_tostring(lua.get(), -1);
+    std::string luaPath = lua_tostring(luaPtr, -1);
 
     // prepend the path of the current plugin
-    auto curPath = this->path / "?.lua";
+    auto curPath = path / "?.lua";
     std::string combinedPath = curPath.string() + ";" + luaPath;
 
     // get rid of the std::string on the stack we just pushed
-    lua_pop(lua.get(), 1);
+    lua_pop(luaPtr, 1);
 
     // push the new one
-    lua_pushstring(lua.get(), combinedPath.c_str());
+    lua_pushstring(luaPtr, combinedPath.c_str());
 
     // set the field "path" in table at -2 with value at top of stack
-    lua_setfield(lua.get(), -2, "path");
+    lua_setfield(luaPtr, -2, "path");
 
     // get rid of package table from top of stack
-    lua_pop(lua.get(), 1);
+    lua_pop(luaPtr, 1);
 }
 
 void Plugin::loadScript() {
@@ -209,7 +209,7 @@ void Plugin::loadScript() {
 
     registerXournalppLibs(lua.get());
 
-    addPluginToLuaPath();
+    addPluginToLuaPath(lua.get(), this->path);
 
     // Run the loaded Lua script
     if (lua_pcall(lua.get(), 0, 0, 0) != LUA_OK) {
@@ -224,23 +224,87 @@ void Plugin::loadScript() {
     }
 }
 
-auto Plugin::callFunction(const std::string& fnc) -> bool {
+auto Plugin::callFunction(const std::string& fnc) -> bool { return callFunction(fnc, {}); }
+
+auto Plugin::callFunction(const std::string& fnc, const std::vector<LuaValue>& args) -> bool {
+    if (fnc.empty()) {
+        return true;
+    }
+
     lua_getglobal(lua.get(), fnc.c_str());
+    for (auto const& arg: args) { arg.push(lua.get()); }
 
     // Run the function
-    if (lua_pcall(lua.get(), 0, 0, 0)) {
+    if (lua_pcall(lua.get(), static_cast<int>(args.size()), 0, 0)) {
         const char* errMsg = lua_tostring(lua.get(), -1);
         std::map<int, std::string> button;
         button.insert(std::pair<int, std::string>(0, _("OK")));
         XojMsgBox::showPluginMessage(name, errMsg, button, true);
 
         g_warning("Error in Plugin: \"%s\", error: \"%s\"", name.c_str(), errMsg);
+        lua_pop(lua.get(), 1);
         return false;
     }
 
     return true;
 }
 
+auto Plugin::startJob(std::string function, LuaValue argument, PluginJob::Callbacks callbacks) -> size_t {
+    // By default, the strokes of the job go to the layer selected now
+    PageRef page = control->getCurrentPage();
+    Layer* layer = page ? page->getSelectedLayer() : nullptr;
+
+    size_t id = nextJobId++;
+    auto& job = jobs[id] = std::make_unique<PluginJob>(this, id, std::move(function), std::move(argument),
+                                                       std::move(callbacks), std::move(page), layer);
+    job->start();
+    return id;
+}
+
+auto Plugin::cancelJob(size_t id) -> bool {
+    auto it = jobs.find(id);
+    if (it == jobs.end()) {
+        return false;
+    }
+    it->second->cancel();
+    return true;
+}
+
+void Plugin::removeJob(size_t id) { jobs.erase(id); }
+
+auto Plugin::createPackedStrokes(const LuaValue& args, std::vector<Element*>& strokes) -> bool {
+    lua_State* L = lua.get();
+    lua_pushcfunction(L, +[](lua_State* L) -> int {
+        auto* result = static_cast<std::vector<Element*>*>(lua_touserdata(L, 2));
+        lua_settop(L, 1);
+        luaL_checktype(L, 1, LUA_TTABLE);
+        if (const char* error = readPackedStrokesHelper(L, *result)) {
+            return luaL_error(L, "%s", error);
+        }
+        return 0;
+    });
+    args.push(L);
+    lua_pushlightuserdata(L, &strokes);
+
+    if (lua_pcall(L, 2, 0, 0) != LUA_OK) {
+        g_warning("Error in Plugin: \"%s\", error: \"%s\"", name.c_str(), lua_tostring(L, -1));
+        lua_pop(L, 1);
+        return false;
+    }
+    return true;
+}
+
+auto Plugin::readElementQuery(lua_State* L) -> ElementQuery { return readElementQueryHelper(L); }
+
+auto Plugin::copyElements(Document* doc, PageRef page, const ElementQuery& query, ElementCopies& elements)
+        -> std::string {
+    return copyElementsHelper(doc, std::move(page), query, elements);
+}
+
+void Plugin::pushElements(lua_State* L, const ElementCopies& elements) { pushElementsHelper(L, elements); }
+
+auto Plugin::getMainfilePath() const -> fs::path { return path / mainfile; }
+
 auto Plugin::getName() const -> std::string const& { return name; }
 auto Plugin::getDescription() const -> std::string const& { return description; }
 auto Plugin::getAuthor() const -> std::string const& { return author; }
@@ -15,12 +15,15 @@
 
 #ifdef ENABLE_PLUGINS
 
+#include <map>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include <gtk/gtk.h>
 
+#include "PluginJob.h"
 #include "filesystem.h"
 
 extern "C" {
@@ -29,6 +32,8 @@ extern "C" {
 
 class Plugin;
 class Control;
+class Document;
+class Element;
 
 struct MenuEntry final {
     MenuEntry() = default;
@@ -102,6 +107,40 @@ public:
     ///@return The main controller
     auto getControl() const -> Control*;
 
+    /// @return the path to the main plugin script
+    auto getMainfilePath() const -> fs::path;
+
+    /// Start a job, see PluginJob
+    /// @return The ID of the job
+    auto startJob(std::string function, LuaValue argument, PluginJob::Callbacks callbacks) -> size_t;
+
+    /// Cancel a job
+    /// @return false if there is no such job (anymore)
+    auto cancelJob(size_t id) -> bool;
+
+    /// Delete a finished job
+    void removeJob(size_t id);
+
+    /// Execute lua function with the given arguments, nothing if fnc is empty
+    auto callFunction(const std::string& fnc, const std::vector<LuaValue>& args) -> bool;
+
+    /// Create the strokes described by the arguments of app.addStrokesPacked, without adding them
+    auto createPackedStrokes(const LuaValue& args, std::vector<Element*>& strokes) -> bool;
+
+    /// Read the arguments of app.getElements, raises a Lua error if they are invalid (any thread)
+    static auto readElementQuery(lua_State* L) -> ElementQuery;
+
+    /// Copy the elements selected by the query, on page if the query gives none, with their sizes (UI thread)
+    /// @return An error message, empty on success
+    static auto copyElements(Document* doc, PageRef page, const ElementQuery& query, ElementCopies& elements)
+            -> std::string;
+
+    /// Push the copied elements in the table returned by app.getElements (any thread)
+    static void pushElements(lua_State* L, const ElementCopies& elements);
+
+    /// Add the plugin folder to the lua path
+    static void addPluginToLuaPath(lua_State* luaPtr, fs::path const& path);
+
 private:
     /// Load ini file
     void loadIni();
@@ -112,9 +151,6 @@ private:
     /// Load custom Lua Libraries
     static void registerXournalppLibs(lua_State* luaPtr);
 
-    /// Add the plugin folder to the lua path
-    void addPluginToLuaPath();
-
 public:
     /// Get Plugin from lua engine
     static auto getPluginFromLua(lua_State* lua) -> Plugin*;
@@ -124,6 +160,9 @@ private:
     std::unique_ptr<lua_State, LuaDeleter> lua{};  ///< Lua engine
     std::vector<MenuEntry> menuEntries;            ///< All registered menu entries
 
+    std::map<size_t, std::unique_ptr<PluginJob>> jobs;  ///< Running jobs, cancelled on destruction
+    size_t nextJobId = 1;                                ///< ID of the next job
+
     std::string name;             ///< Plugin name
     std::string description;      ///< Description of the plugin
     std::string author;           ///< Author of the plugin
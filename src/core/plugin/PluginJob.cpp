@@ -0,0 +1,465 @@
+#include "PluginJob.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <utility>
+
+#include "control/Control.h"
+#include "model/Document.h"
+#include "model/Layer.h"
+#include "model/XojPage.h"
+#include "undo/InsertUndoAction.h"
+#include "undo/UndoRedoHandler.h"
+#include "util/XojMsgBox.h"
+#include "util/i18n.h"
+
+#include "Plugin.h"
+
+extern "C" {
+#include <lauxlib.h>
+#include <lualib.h>
+}
+
+/**
+ * Nested tables deeper than this are rejected, which also catches cycles
+ */
+constexpr int MAX_TABLE_DEPTH = 32;
+
+/**
+ * Number of Lua instructions between two checks of the cancellation
+ */
+constexpr int CANCEL_CHECK_INSTRUCTIONS = 1000;
+
+auto LuaValue::fromStack(lua_State* L, int index) -> LuaValue { return fromStack(L, lua_absindex(L, index), 0); }
+
+auto LuaValue::fromStack(lua_State* L, int index, int depth) -> LuaValue {
+    LuaValue value;
+    switch (lua_type(L, index)) {
+        case LUA_TNIL:
+        case LUA_TNONE:
+            break;
+        case LUA_TBOOLEAN:
+            value.type = Type::BOOLEAN;
+            value.boolean = lua_toboolean(L, index);
+            break;
+        case LUA_TNUMBER:
+            if (lua_isinteger(L, index)) {
+                value.type = Type::INTEGER;
+                value.integer = lua_tointeger(L, index);
+            } else {
+                value.type = Type::NUMBER;
+                value.number = lua_tonumber(L, index);
+            }
+            break;
+        case LUA_TSTRING: {
+            size_t length = 0;
+            const char* data = lua_tolstring(L, index, &length);
+            value.type = Type::STRING;
+            value.string.assign(data, length);
+            break;
+        }
+        case LUA_TTABLE:
+            if (depth >= MAX_TABLE_DEPTH) {
+                luaL_error(L, "Table nested too deeply to be passed to or from a job!");
+            }
+            value.type = Type::TABLE;
+            lua_pushnil(L);
+            while (lua_next(L, index) != 0) {
+                value.table.push_back(fromStack(L, lua_absindex(L, -2), depth + 1));
+                value.table.push_back(fromStack(L, lua_absindex(L, -1), depth + 1));
+                lua_pop(L, 1);
+            }
+            break;
+        default:
+            luaL_error(L, "Only nil, booleans, numbers, strings and tables can be passed to or from a job, not %s!",
+                       luaL_typename(L, index));
+    }
+    return value;
+}
+
+void LuaValue::push(lua_State* L) const {
+    switch (this->type) {
+        case Type::NIL:
+            lua_pushnil(L);
+            break;
+        case Type::BOOLEAN:
+            lua_pushboolean(L, this->boolean);
+            break;
+        case Type::INTEGER:
+            lua_pushinteger(L, this->integer);
+            break;
+        case Type::NUMBER:
+            lua_pushnumber(L, this->number);
+            break;
+        case Type::STRING:
+            lua_pushlstring(L, this->string.data(), this->string.size());
+            break;
+        case Type::TABLE:
+            lua_createtable(L, 0, static_cast<int>(this->table.size() / 2));
+            for (size_t i = 0; i + 1 < this->table.size(); i += 2) {
+                this->table[i].push(L);
+                this->table[i + 1].push(L);
+                lua_rawset(L, -3);
+            }
+            break;
+    }
+}
+
+PluginJob::PluginJob(Plugin* plugin, size_t id, std::string function, LuaValue argument, Callbacks callbacks,
+                     PageRef page, Layer* layer):
+        plugin(plugin),
+        id(id),
+        function(std::move(function)),
+        argument(std::move(argument)),
+        callbacks(std::move(callbacks)),
+        doc(plugin->getControl()->getDocument()),
+        page(std::move(page)),
+        layer(layer) {}
+
+PluginJob::~PluginJob() {
+    // If the job did not finish, the Plugin is being destroyed
+    cancel();
+    if (this->thread.joinable()) {
+        this->thread.join();
+    }
+
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    if (this->dispatchSource != 0) {
+        g_source_remove(this->dispatchSource);
+    }
+}
+
+void PluginJob::start() { this->thread = std::thread([this] { run(); }); }
+
+void PluginJob::cancel() {
+    {
+        // The worker may be waiting for an answer of the UI thread, see requestElements()
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->cancelled = true;
+    }
+    this->requestDone.notify_all();
+}
+
+auto PluginJob::isCancelled() const -> bool { return this->cancelled; }
+
+auto PluginJob::getId() const -> size_t { return this->id; }
+
+auto PluginJob::getJobFromLua(lua_State* lua) -> PluginJob* {
+    lua_getfield(lua, LUA_REGISTRYINDEX, "Xournalpp_PluginJob");
+
+    if (lua_islightuserdata(lua, -1)) {
+        auto* data = static_cast<PluginJob*>(lua_touserdata(lua, -1));
+        lua_pop(lua, 1);
+        return data;
+    }
+
+    lua_pop(lua, 1);
+    return nullptr;
+}
+
+void PluginJob::run() {
+    std::unique_ptr<lua_State, LuaDeleter> lua(luaL_newstate());
+    lua_State* L = lua.get();
+    luaL_openlibs(L);
+
+    // Register the job to the Lua instance, and the job library instead of the app library
+    lua_pushlightuserdata(L, this);
+    lua_setfield(L, LUA_REGISTRYINDEX, "Xournalpp_PluginJob");
+    luaL_requiref(L, "job", luaopen_job, 1);
+    lua_pop(L, 1);
+
+    Plugin::addPluginToLuaPath(L, this->plugin->getPath());
+
+    // Interrupt the Lua code when the job is cancelled, even if it does not check job.isCancelled()
+    lua_sethook(
+            L,
+            +[](lua_State* L, lua_Debug*) {
+                if (getJobFromLua(L)->isCancelled()) {
+                    luaL_error(L, "Job cancelled");
+                }
+            },
+            LUA_MASKCOUNT, CANCEL_CHECK_INSTRUCTIONS);
+
+    auto errorMessage = [L] {
+        const char* errMsg = lua_tostring(L, -1);
+        return std::string(errMsg ? errMsg : "Unknown error");
+    };
+
+    Message finished{Message::Type::FINISHED};
+    auto luafile = this->plugin->getMainfilePath();
+    if (luaL_loadfile(L, luafile.string().c_str()) != LUA_OK || lua_pcall(L, 0, 0, 0) != LUA_OK) {
+        finished.text = errorMessage();
+    } else {
+        lua_getglobal(L, this->function.c_str());
+        this->argument.push(L);
+        if (lua_pcall(L, 1, 0, 0) != LUA_OK) {
+            finished.text = errorMessage();
+        } else {
+            finished.success = true;
+        }
+    }
+    post(std::move(finished));
+}
+
+void PluginJob::post(Message message) {
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+
+    // Only the latest progress matters
+    if (message.type == Message::Type::PROGRESS && !this->queue.empty() &&
+        this->queue.back().type == Message::Type::PROGRESS) {
+        this->queue.back() = std::move(message);
+    } else {
+        this->queue.push_back(std::move(message));
+    }
+
+    if (this->dispatchSource == 0) {
+        this->dispatchSource = g_idle_add(
+                +[](gpointer data) -> gboolean {
+                    static_cast<PluginJob*>(data)->dispatch();
+                    return G_SOURCE_REMOVE;
+                },
+                this);
+    }
+}
+
+void PluginJob::dispatch() {
+    std::deque<Message> messages;
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        messages.swap(this->queue);
+        this->dispatchSource = 0;
+    }
+
+    LuaValue jobId;
+    jobId.type = LuaValue::Type::INTEGER;
+    jobId.integer = static_cast<lua_Integer>(this->id);
+
+    for (Message& m: messages) {
+        switch (m.type) {
+            case Message::Type::POST:
+                this->plugin->callFunction(this->callbacks.onMessage, {jobId, m.value});
+                break;
+            case Message::Type::PROGRESS: {
+                LuaValue fraction;
+                fraction.type = LuaValue::Type::NUMBER;
+                fraction.number = m.fraction;
+                LuaValue text;
+                text.type = LuaValue::Type::STRING;
+                text.string = m.text;
+                this->plugin->callFunction(this->callbacks.onProgress, {jobId, fraction, text});
+                break;
+            }
+            case Message::Type::STROKES:
+                addStrokes(m.value, m.page, m.layer);
+                break;
+            case Message::Type::ELEMENTS:
+                copyElements(*m.request);
+                break;
+            case Message::Type::FINISHED: {
+                if (!m.success) {
+                    g_warning("Job of Plugin \"%s\" failed: \"%s\"", this->plugin->getName().c_str(), m.text.c_str());
+                    if (this->callbacks.onFinished.empty() && !isCancelled()) {
+                        std::map<int, std::string> button;
+                        button.insert(std::pair<int, std::string>(0, _("OK")));
+                        XojMsgBox::showPluginMessage(this->plugin->getName(), m.text, button, true);
+                    }
+                }
+
+                LuaValue success;
+                success.type = LuaValue::Type::BOOLEAN;
+                success.boolean = m.success;
+                LuaValue error;
+                if (!m.success) {
+                    error.type = LuaValue::Type::STRING;
+                    error.string = m.text;
+                }
+                this->plugin->callFunction(this->callbacks.onFinished, {jobId, success, error});
+
+                // The job is deleted: nothing may be accessed afterwards
+                this->plugin->removeJob(this->id);
+                return;
+            }
+        }
+    }
+}
+
+void PluginJob::addStrokes(const LuaValue& args, lua_Integer pageNr, lua_Integer layerNr) {
+    std::vector<Element*> strokes;
+    if (!this->plugin->createPackedStrokes(args, strokes) || strokes.empty()) {
+        return;
+    }
+
+    // Rendering and job.getElements read the layer meanwhile
+    this->doc->lock();
+    PageRef page = this->page;
+    if (pageNr != 0) {
+        page = pageNr >= 1 && static_cast<size_t>(pageNr) <= this->doc->getPageCount() ?
+                       this->doc->getPage(static_cast<size_t>(pageNr - 1)) :
+                       PageRef();
+    }
+
+    Layer* layer = nullptr;
+    if (page) {
+        auto* layers = page->getLayers();
+        if (layerNr >= 1 && static_cast<size_t>(layerNr) <= layers->size()) {
+            layer = (*layers)[static_cast<size_t>(layerNr - 1)];
+        } else if (layerNr == 0 && pageNr != 0) {
+            layer = page->getSelectedLayer();
+        } else if (layerNr == 0 && std::find(layers->begin(), layers->end(), this->layer) != layers->end()) {
+            layer = this->layer;
+        }
+    }
+    if (layer) {
+        layer->addElements(strokes);
+    }
+    this->doc->unlock();
+
+    if (!layer) {
+        g_warning("Job of Plugin \"%s\": there is no layer %d on page %d to add the strokes to",
+                  this->plugin->getName().c_str(), static_cast<int>(layerNr), static_cast<int>(pageNr));
+        for (Element* e: strokes) { delete e; }
+        return;
+    }
+
+    registerUndoAction(page, layer, std::move(strokes));
+    page->firePageChanged();
+}
+
+void PluginJob::registerUndoAction(const PageRef& page, Layer* layer, std::vector<Element*> strokes) {
+    UndoRedoHandler* undo = this->plugin->getControl()->getUndoRedoHandler();
+
+    // The user may have edited, undone or saved meanwhile: the previous action is then left as it is, so that the
+    // strokes are always undone in the order they were added
+    if (this->lastAction && this->lastLayer == layer && undo->getRevision() == this->lastUndoRevision) {
+        this->lastAction->addElements(strokes);
+        return;
+    }
+
+    auto action = std::make_unique<InsertsUndoAction>(page, layer, std::move(strokes));
+    this->lastAction = action.get();
+    this->lastLayer = layer;
+    undo->addUndoAction(std::move(action));
+    this->lastUndoRevision = undo->getRevision();
+}
+
+void PluginJob::copyElements(ElementRequest& request) {
+    ElementCopies elements;
+    std::string error = Plugin::copyElements(this->doc, request.query.page == 0 ? this->page : PageRef(),
+                                             request.query, elements);
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        request.elements = std::move(elements);
+        request.error = std::move(error);
+        request.done = true;
+    }
+    this->requestDone.notify_all();
+}
+
+auto PluginJob::requestElements(lua_State* L, const ElementQuery& query) -> bool {
+    auto request = std::make_shared<ElementRequest>();
+    request->query = query;
+    Message message{Message::Type::ELEMENTS};
+    message.request = request;
+    post(std::move(message));
+
+    {
+        std::unique_lock<std::mutex> lock(this->queueMutex);
+        this->requestDone.wait(lock, [&] { return request->done || isCancelled(); });
+        if (!request->done) {
+            lua_pushliteral(L, "Job cancelled");
+            return false;
+        }
+    }
+
+    if (!request->error.empty()) {
+        lua_pushstring(L, request->error.c_str());
+        return false;
+    }
+    Plugin::pushElements(L, request->elements);
+    return true;
+}
+
+auto PluginJob::luaopen_job(lua_State* L) -> int {
+    static const luaL_Reg joblib[] = {
+            /**
+             * Sends a value to the onMessage callback, on the UI thread.
+             *
+             * Example: job.post({["page"] = 3, ["count"] = 120})
+             */
+            {"post",
+             +[](lua_State* L) -> int {
+                 getJobFromLua(L)->post({Message::Type::POST, LuaValue::fromStack(L, 1)});
+                 return 0;
+             }},
+            /**
+             * Reports the progress, between 0 and 1, with an optional text, to the onProgress callback.
+             *
+             * Example: job.progress(page / pageCount, "Page " .. page)
+             */
+            {"progress",
+             +[](lua_State* L) -> int {
+                 Message message{Message::Type::PROGRESS};
+                 message.fraction = luaL_checknumber(L, 1);
+                 message.text = luaL_optstring(L, 2, "");
+                 getJobFromLua(L)->post(std::move(message));
+                 return 0;
+             }},
+            /**
+             * Returns whether the job was cancelled, in order to stop cleanly.
+             *
+             * Example: if job.isCancelled() then return end
+             */
+            {"isCancelled",
+             +[](lua_State* L) -> int {
+                 lua_pushboolean(L, getJobFromLua(L)->isCancelled());
+                 return 1;
+             }},
+            /**
+             * Adds strokes like app.addStrokesPacked, on the UI thread. allowUndoRedoAction is ignored: the strokes are
+             * undone together with those of the previous call, unless the undo list changed meanwhile. The optional
+             * page and layer (1-based) give the target of the strokes. Without a page, they go to the layer that was
+             * selected when the job started, or to the given layer of that page. With a page but no layer, they go to
+             * the selected layer of the page.
+             *
+             * Example: job.addStrokesPacked({["points"] = points, ["page"] = 3, ["layer"] = 1})
+             */
+            {"addStrokesPacked",
+             +[](lua_State* L) -> int {
+                 luaL_checktype(L, 1, LUA_TTABLE);
+                 lua_getfield(L, 1, "page");
+                 lua_Integer page = luaL_optinteger(L, -1, 0);
+                 lua_getfield(L, 1, "layer");
+                 lua_Integer layer = luaL_optinteger(L, -1, 0);
+                 lua_pop(L, 2);
+
+                 Message message{Message::Type::STROKES, LuaValue::fromStack(L, 1)};
+                 message.page = page;
+                 message.layer = layer;
+                 getJobFromLua(L)->post(std::move(message));
+                 return 0;
+             }},
+            /**
+             * Returns the elements of a page like app.getElements. The page defaults to the page that was current
+             * when the job started. The elements are copied on the UI thread, after the strokes added before by the
+             * job; the Lua tables are built on the worker thread.
+             *
+             * Example: local elements = job.getElements({["page"] = 2, ["layer"] = 1})
+             */
+            {"getElements",
+             +[](lua_State* L) -> int {
+                 ElementQuery query = Plugin::readElementQuery(L);
+                 if (!getJobFromLua(L)->requestElements(L, query)) {
+                     return lua_error(L);
+                 }
+                 return 1;
+             }},
+            {nullptr, nullptr}};
+
+    luaL_newlib(L, joblib);
+    return 1;
+}
+
+#endif
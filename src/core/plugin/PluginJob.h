@@ -0,0 +1,209 @@
+/*
+ * Xournal++
+ *
+ * A long running Lua function of a Plugin, executed on a worker thread
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include "config-features.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <glib.h>
+
+#include "model/PageRef.h"
+#include "util/Rectangle.h"
+
+#include "filesystem.h"
+
+extern "C" {
+#include <lua.h>
+}
+
+class Document;
+class Element;
+class InsertsUndoAction;
+class Layer;
+class Plugin;
+
+/**
+ * @brief Copy of a Lua value, to pass it from one Lua state to another.
+ *
+ * Only nil, booleans, numbers, strings and tables of those are supported.
+ */
+struct LuaValue final {
+    enum class Type { NIL, BOOLEAN, INTEGER, NUMBER, STRING, TABLE };
+
+    /**
+     * Copies the value at the index of the Lua stack. Raises a Lua error for unsupported values.
+     */
+    static auto fromStack(lua_State* L, int index) -> LuaValue;
+
+    /**
+     * Pushes a copy of the value on the Lua stack
+     */
+    void push(lua_State* L) const;
+
+    Type type = Type::NIL;
+    bool boolean = false;
+    lua_Integer integer = 0;
+    lua_Number number = 0;
+    std::string string;
+    std::vector<LuaValue> table;  ///< Keys and values, alternately
+
+private:
+    static auto fromStack(lua_State* L, int index, int depth) -> LuaValue;
+};
+
+/**
+ * @brief The arguments of app.getElements
+ */
+struct ElementQuery final {
+    lua_Integer page = 0;    ///< 1-based, 0 for the default page
+    lua_Integer layer = -1;  ///< 1-based, -1 for all the layers
+    std::optional<xoj::util::Rectangle<double>> bounds;
+};
+
+/**
+ * Copies of elements, with the 1-based index of their layer
+ */
+using ElementCopies = std::vector<std::pair<std::unique_ptr<Element>, int>>;
+
+/**
+ * @brief A Lua function of a Plugin, run in a Lua state of its own on a worker thread, so that the UI is not blocked.
+ *
+ * The job state loads the main file of the plugin, without the app library, which is only safe on the UI thread.
+ * Instead the job library passes messages back to the UI thread: posted values, the progress, the strokes to add and
+ * the requests of job.getElements. Those are handled on the UI thread in order. Posted values and the progress are
+ * passed to the callbacks given to app.startJob, in the main state of the Plugin.
+ * The strokes go to the given page and layer, by default to the layer that was selected when the job started. They
+ * are shown and get their undo action as soon as they are added. The strokes of a batch join the undo action of the
+ * previous batch if nothing else happened to the undo list meanwhile and they go to the same layer. The elements read by job.getElements are copied on the UI thread, where the texts are measured, and
+ * turned into Lua tables on the worker thread.
+ *
+ * The job is cancelled on request or when the Plugin is destroyed: the Lua code is interrupted at the next hook.
+ */
+class PluginJob final {
+public:
+    struct Callbacks {
+        std::string onMessage;   ///< Called as onMessage(id, value)
+        std::string onProgress;  ///< Called as onProgress(id, fraction, text)
+        std::string onFinished;  ///< Called as onFinished(id, success, error)
+    };
+
+    PluginJob(Plugin* plugin, size_t id, std::string function, LuaValue argument, Callbacks callbacks,
+              PageRef page, Layer* layer);
+    ~PluginJob();
+
+    PluginJob(const PluginJob&) = delete;
+    PluginJob& operator=(const PluginJob&) = delete;
+
+public:
+    /// Start the worker thread
+    void start();
+
+    /// Request the job to stop, without waiting for it
+    void cancel();
+
+    auto isCancelled() const -> bool;
+
+    auto getId() const -> size_t;
+
+    /// Get the job from its Lua state
+    static auto getJobFromLua(lua_State* lua) -> PluginJob*;
+
+private:
+    /**
+     * A call of job.getElements, answered by the UI thread. Guarded by queueMutex.
+     */
+    struct ElementRequest {
+        ElementQuery query;
+        ElementCopies elements;
+        std::string error;  ///< Empty on success
+        bool done = false;  ///< Whether elements and error are set
+    };
+
+    struct Message {
+        enum class Type { POST, PROGRESS, STROKES, ELEMENTS, FINISHED };
+
+        Type type;
+        LuaValue value;        ///< Posted value, or arguments of addStrokesPacked
+        double fraction = 0;   ///< Progress
+        std::string text;      ///< Progress text, or error message
+        bool success = false;  ///< Whether the job succeeded
+
+        lua_Integer page = 0;   ///< 1-based page of the strokes, 0 for the default one
+        lua_Integer layer = 0;  ///< 1-based layer of the strokes, 0 for the default one
+
+        std::shared_ptr<ElementRequest> request;  ///< Call of job.getElements
+    };
+
+    /// Body of the worker thread
+    void run();
+
+    /// Queue a message for the UI thread (worker thread)
+    void post(Message message);
+
+    /// Handle the queued messages (UI thread)
+    void dispatch();
+
+    /// Add the strokes described by the arguments of addStrokesPacked (UI thread)
+    void addStrokes(const LuaValue& args, lua_Integer pageNr, lua_Integer layerNr);
+
+    /// Register the undo action of strokes just added to the layer, or extend the previous one (UI thread)
+    void registerUndoAction(const PageRef& page, Layer* layer, std::vector<Element*> strokes);
+
+    /// Answer a call of job.getElements (UI thread)
+    void copyElements(ElementRequest& request);
+
+    /// Push the elements selected by the query, or the error message, once the UI thread has copied them (worker
+    /// thread)
+    /// @return Whether it succeeded
+    auto requestElements(lua_State* L, const ElementQuery& query) -> bool;
+
+    /// Load the job library
+    static auto luaopen_job(lua_State* L) -> int;
+
+private:
+    Plugin* plugin;
+    size_t id;
+    std::string function;
+    LuaValue argument;
+    Callbacks callbacks;
+
+    Document* doc;  ///< The document, read by job.getElements
+    PageRef page;   ///< Default page of the added strokes and of job.getElements
+    Layer* layer;   ///< Default layer of the added strokes
+
+    InsertsUndoAction* lastAction = nullptr;  ///< Undo action of the last strokes added
+    Layer* lastLayer = nullptr;               ///< Layer of lastAction
+    size_t lastUndoRevision = 0;              ///< Revision of the undo list when lastAction was last extended
+
+    std::atomic<bool> cancelled{false};
+    std::thread thread;
+
+    std::mutex queueMutex;
+    std::deque<Message> queue;  ///< Messages waiting for the UI thread
+    guint dispatchSource = 0;   ///< Pending idle source dispatching the queue, 0 if none
+
+    std::condition_variable requestDone;  ///< Notified when a call of job.getElements is answered, or on cancel
+};
+
+#endif
@@ -12,6 +12,11 @@
 
 #include <cstring>
 #include <map>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include <gtk/gtk.h>
 #include <stdint.h>
@@ -27,12 +32,15 @@
 #include "model/Font.h"
 #include "model/SplineSegment.h"
 #include "model/StrokeStyle.h"
+#include "model/TexImage.h"
 #include "model/Text.h"
 #include "undo/InsertUndoAction.h"
 #include "util/StringUtils.h"
 #include "util/XojMsgBox.h"
 #include "util/safe_casts.h"
 
+#include "PackedStrokes.h"
+
 /**
  * Renames file 'from' to file 'to' in the file system.
  * Overwrites 'to' if it already exists.
@@ -382,14 +390,12 @@ static int applib_layerAction(lua_State* L) {
 }
 
 /**
- * Helper function for addStroke API. Parses pen settings from API call, taking
- * in a Stroke and a chosen Layer, sets the pen settings, and applies the stroke.
+ * Helper function for addStroke API. Parses pen settings from the table on top
+ * of the Lua stack and sets them on the Stroke.
  */
-static void addStrokeHelper(lua_State* L, Stroke* stroke) {
+static void setStrokeStyleHelper(lua_State* L, Stroke* stroke) {
     Plugin* plugin = Plugin::getPluginFromLua(L);
     Control* ctrl = plugin->getControl();
-    PageRef const& page = ctrl->getCurrentPage();
-    Layer* layer = page->getSelectedLayer();
 
     std::string size;
     double thickness;
@@ -471,10 +477,22 @@ static void addStrokeHelper(lua_State* L, Stroke* stroke) {
         stroke->setLineStyle(StrokeStyle::parseStyle(lineStyle.data()));
 
     lua_pop(L, 5);  // Finally done with all that Lua data.
+}
+
+/**
+ * Helper function for addStroke API. Parses pen settings from API call, taking
+ * in a Stroke and a chosen Layer, sets the pen settings, and applies the stroke.
+ */
+static void addStrokeHelper(lua_State* L, Stroke* stroke) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* ctrl = plugin->getControl();
+    PageRef const& page = ctrl->getCurrentPage();
+    Layer* layer = page->getSelectedLayer();
+
+    setStrokeStyleHelper(L, stroke);
 
     // Add the stroke
     layer->addElement(stroke);
-    return;
 }
 
 /**
@@ -787,6 +805,258 @@ static int applib_addStrokes(lua_State* L) {
     return 0;
 }
 
+/**
+ * Helper function for addStrokesPacked. Creates the strokes described by the
+ * table at index 1 of the Lua stack, without adding them anywhere.
+ *
+ * No Lua error is raised while the C++ locals are alive: the error message is
+ * returned instead, and nullptr if the strokes were created.
+ */
+static const char* readPackedStrokesHelper(lua_State* L, std::vector<Element*>& strokes) {
+    // setStrokeStyleHelper would raise an error on a tool which is not a string
+    lua_getfield(L, 1, "tool");
+    const bool validTool = lua_isnil(L, -1) || lua_isstring(L, -1);
+    lua_pop(L, 1);
+    if (!validTool) {
+        return "Tool is not a string!";
+    }
+
+    lua_getfield(L, 1, "pressure");
+    const size_t stride = lua_toboolean(L, -1) ? 3 : 2;
+    lua_pop(L, 1);
+
+    lua_getfield(L, 1, "points");
+    const char* data = nullptr;
+    size_t length = 0;
+    if (lua_type(L, -1) == LUA_TSTRING) {
+        data = lua_tolstring(L, -1, &length);
+    } else if (lua_type(L, -1) == LUA_TUSERDATA) {
+        data = static_cast<const char*>(lua_touserdata(L, -1));
+        length = lua_rawlen(L, -1);
+    } else {
+        lua_pop(L, 1);
+        return "Missing point buffer!";
+    }
+    if (length % (stride * sizeof(double)) != 0) {
+        lua_pop(L, 1);
+        return "Point buffer incomplete!";
+    }
+    const size_t numPoints = length / (stride * sizeof(double));
+
+    std::vector<size_t> counts;
+    lua_getfield(L, 1, "counts");
+    if (lua_istable(L, -1)) {
+        size_t numStrokes = lua_rawlen(L, -1);
+        counts.reserve(numStrokes);
+        size_t total = 0;
+        for (size_t a = 1; a <= numStrokes; a++) {
+            lua_rawgeti(L, -1, static_cast<lua_Integer>(a));
+            lua_Integer count = lua_tointeger(L, -1);
+            lua_pop(L, 1);
+            if (count < 0) {
+                lua_pop(L, 2);
+                return "Negative point count!";
+            }
+            counts.push_back(static_cast<size_t>(count));
+            total += counts.back();
+        }
+        if (total != numPoints) {
+            lua_pop(L, 2);
+            return "Point counts do not match the point buffer!";
+        }
+    } else {
+        counts.push_back(numPoints);
+    }
+    lua_pop(L, 1);
+
+    // The style is the same for all the strokes
+    Stroke style;
+    lua_pushvalue(L, 1);
+    setStrokeStyleHelper(L, &style);
+    lua_pop(L, 1);
+
+    strokes = createPackedStrokes(data, counts, stride == 3, style);
+    lua_pop(L, 1);  // Stack is now the same as it was on entry to this function
+
+    return nullptr;
+}
+
+/**
+ * Helper function for addStrokesPacked. Adds the strokes described by the
+ * table at index 1 of the Lua stack to the current layer.
+ *
+ * Like readPackedStrokesHelper, returns the error message instead of raising
+ * it, and nullptr if the strokes were added.
+ */
+static const char* addStrokesPackedHelper(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    Control* ctrl = plugin->getControl();
+    PageRef const& page = ctrl->getCurrentPage();
+    Layer* layer = page->getSelectedLayer();
+
+    std::vector<Element*> strokes;
+    if (const char* error = readPackedStrokesHelper(L, strokes)) {
+        return error;
+    }
+
+    // Check how the user wants to handle undoing
+    lua_getfield(L, 1, "allowUndoRedoAction");
+    if (!lua_isnil(L, -1) && !lua_isstring(L, -1)) {
+        lua_pop(L, 1);
+        for (Element* e: strokes) { delete e; }
+        return "allowUndoRedoAction is not a string!";
+    }
+    const char* allowUndoRedoAction = lua_isnil(L, -1) ? "grouped" : lua_tostring(L, -1);
+
+    layer->addElements(strokes);
+
+    if (strcmp("grouped", allowUndoRedoAction) == 0) {
+        UndoRedoHandler* undo = ctrl->getUndoRedoHandler();
+        undo->addUndoAction(std::make_unique<InsertsUndoAction>(page, layer, strokes));
+    } else if (strcmp("individual", allowUndoRedoAction) == 0) {
+        UndoRedoHandler* undo = ctrl->getUndoRedoHandler();
+        for (Element* element: strokes) undo->addUndoAction(std::make_unique<InsertUndoAction>(page, layer, element));
+    } else if (strcmp("none", allowUndoRedoAction) == 0)
+        g_warning("Not allowing undo/redo action.");
+    else
+        g_warning("Unrecognized undo/redo option: %s", allowUndoRedoAction);
+    lua_pop(L, 1);
+
+    if (!strokes.empty()) {
+        page->firePageChanged();
+    }
+
+    return nullptr;
+}
+
+/**
+ * Given a packed buffer of coordinates, draws a batch of strokes on the canvas
+ * in one go: the points are read straight from the buffer, all the strokes
+ * share the same attributes, are added as a single undo action and the page is
+ * repainted once. Meant for plugins importing many strokes, where addStrokes is
+ * slow.
+ *
+ * Required Arguments: points
+ * Optional Arguments: counts, pressure, tool, width, color, fill, lineStyle
+ *
+ * points is a string (or a userdata) holding native-endian doubles: x, y pairs,
+ * or x, y, pressure triples if pressure is true. counts gives the number of
+ * points of each stroke, in order; without it, all the points make a single
+ * stroke. Strokes shorter than two points are discarded.
+ *
+ * If optional arguments are not provided, the specified tool settings are used.
+ * If the tool is not provided, the current pen settings are used.
+ * The only tools supported are Pen and Highlighter.
+ *
+ * The function checks that the buffer holds a whole number of points and that
+ * the counts add up to it, and throws an error if not.
+ *
+ * Example:
+ *
+ * app.addStrokesPacked({
+ *     ["points"] = string.pack("dddddddddd", 110, 200, 120, 205, 130, 210, 310, 300, 320, 305),
+ *     ["counts"] = {3, 2},
+ *     ["tool"] = "pen",
+ *     ["width"] = 1.21,
+ *     ["color"] = 0x808000,
+ *     ["fill"] = 0,
+ *     ["lineStyle"] = "solid",
+ *     ["allowUndoRedoAction"] = "grouped", -- All the strokes are grouped into one undo/redo action (or "individual"
+ * or "none")
+ * })
+ */
+static int applib_addStrokesPacked(lua_State* L) {
+    // Discard any extra arguments passed in
+    lua_settop(L, 1);
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    // Raised here, once the C++ locals of the helpers are destroyed: lua_error does not unwind them
+    if (const char* error = addStrokesPackedHelper(L)) {
+        return luaL_error(L, "%s", error);
+    }
+    return 0;
+}
+
+/**
+ * Runs a function of the plugin in the background, on a worker thread, so
+ * that long computations do not freeze the UI. Returns the ID of the job.
+ *
+ * Required Arguments: function
+ * Optional Arguments: argument, onMessage, onProgress, onFinished
+ *
+ * The job runs in a Lua state of its own, in which the main file of the plugin
+ * is loaded again: it shares no variables with the plugin, and has no access to
+ * the app library. The function is called with the argument, which is copied
+ * (only nil, booleans, numbers, strings and tables of those are allowed). Within
+ * the job, the job library talks to the UI thread:
+ *   job.post(value)               calls onMessage(id, value)
+ *   job.progress(fraction, text)  calls onProgress(id, fraction, text)
+ *   job.isCancelled()             tells whether the job was cancelled
+ *   job.addStrokesPacked(table)   adds strokes like app.addStrokesPacked
+ *   job.getElements(table)        reads elements like app.getElements
+ * The callbacks are names of global functions of the plugin, called on the UI
+ * thread. The strokes go to the page and layer given to job.addStrokesPacked,
+ * by default to the layer selected when the job started. Their undo action is
+ * registered as they are added, and extended by the next strokes of the job as
+ * long as nothing else happened to the undo list. When the job ends,
+ * onFinished(id, success, error) is called.
+ *
+ * Example:
+ *
+ * function vectorize(pages)
+ *   for i, page in ipairs(pages) do
+ *     if job.isCancelled() then return end
+ *     job.addStrokesPacked({["points"] = compute(page), ["width"] = 1.0})
+ *     job.progress(i / #pages, "Page " .. i)
+ *   end
+ * end
+ *
+ * local id = app.startJob({["function"] = "vectorize", ["argument"] = {1, 2, 3},
+ *                          ["onProgress"] = "showProgress", ["onFinished"] = "done"})
+ */
+static int applib_startJob(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+
+    // Discard any extra arguments passed in
+    lua_settop(L, 1);
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    lua_getfield(L, 1, "function");
+    if (!lua_isstring(L, -1))
+        luaL_error(L, "Missing job function!");
+    std::string function = lua_tostring(L, -1);
+
+    lua_getfield(L, 1, "argument");
+    LuaValue argument = LuaValue::fromStack(L, -1);
+
+    PluginJob::Callbacks callbacks;
+    lua_getfield(L, 1, "onMessage");
+    callbacks.onMessage = luaL_optstring(L, -1, "");
+    lua_getfield(L, 1, "onProgress");
+    callbacks.onProgress = luaL_optstring(L, -1, "");
+    lua_getfield(L, 1, "onFinished");
+    callbacks.onFinished = luaL_optstring(L, -1, "");
+    lua_pop(L, 5);
+
+    size_t id = plugin->startJob(std::move(function), std::move(argument), std::move(callbacks));
+    lua_pushinteger(L, as_signed(id));
+    return 1;
+}
+
+/**
+ * Cancels a job started with app.startJob. The job stops at its next check of
+ * job.isCancelled(), or is interrupted. Its onFinished callback is called.
+ * Returns false if the job is already finished.
+ *
+ * Example: app.cancelJob(id)
+ */
+static int applib_cancelJob(lua_State* L) {
+    Plugin* plugin = Plugin::getPluginFromLua(L);
+    lua_Integer id = luaL_checkinteger(L, 1);
+    lua_pushboolean(L, id > 0 && plugin->cancelJob(static_cast<size_t>(id)));
+    return 1;
+}
+
 /**
  * Notifies program of any updates to the working document caused
  * by the API.
@@ -1375,6 +1645,245 @@ static int applib_getDocumentStructure(lua_State* L) {
     return 1;
 }
 
+/**
+ * Helper function for getElements: pushes the table describing an element.
+ * Stroke points are pushed as a single string, copied at once from the points of the stroke.
+ */
+static void pushElementHelper(lua_State* L, Element* e, int layerId) {
+    static_assert(std::is_standard_layout_v<Point> && sizeof(Point) == 3 * sizeof(double),
+                  "The points are packed as (x, y, pressure) triples");
+
+    lua_newtable(L);  // beginning of table for the element
+
+    lua_pushliteral(L, "layer");
+    lua_pushinteger(L, layerId);
+    lua_settable(L, -3);
+
+    lua_pushliteral(L, "bounds");
+    lua_createtable(L, 0, 4);
+    lua_pushnumber(L, e->getX());
+    lua_setfield(L, -2, "x");
+    lua_pushnumber(L, e->getY());
+    lua_setfield(L, -2, "y");
+    lua_pushnumber(L, e->getElementWidth());
+    lua_setfield(L, -2, "width");
+    lua_pushnumber(L, e->getElementHeight());
+    lua_setfield(L, -2, "height");
+    lua_settable(L, -3);
+
+    lua_pushliteral(L, "color");
+    lua_pushinteger(L, int(uint32_t(e->getColor())));
+    lua_settable(L, -3);
+
+    lua_pushliteral(L, "type");
+    switch (e->getType()) {
+        case ELEMENT_STROKE: {
+            lua_pushliteral(L, "stroke");
+            lua_settable(L, -3);
+
+            auto* stroke = dynamic_cast<Stroke*>(e);
+            const char* tool = stroke->getToolType() == STROKE_TOOL_HIGHLIGHTER ? "highlighter" :
+                               stroke->getToolType() == STROKE_TOOL_ERASER      ? "eraser" :
+                                                                                  "pen";
+            lua_pushstring(L, tool);
+            lua_setfield(L, -2, "tool");
+            lua_pushnumber(L, stroke->getWidth());
+            lua_setfield(L, -2, "width");
+            lua_pushinteger(L, stroke->getFill());
+            lua_setfield(L, -2, "fill");
+            lua_pushstring(L, StrokeStyle::formatStyle(stroke->getLineStyle()).c_str());
+            lua_setfield(L, -2, "lineStyle");
+            lua_pushboolean(L, stroke->hasPressure());
+            lua_setfield(L, -2, "pressure");
+
+            auto const& points = stroke->getPointVector();
+            lua_pushinteger(L, as_signed(points.size()));
+            lua_setfield(L, -2, "count");
+            lua_pushlstring(L, reinterpret_cast<const char*>(points.data()), points.size() * sizeof(Point));
+            lua_setfield(L, -2, "points");
+            break;
+        }
+        case ELEMENT_TEXT: {
+            lua_pushliteral(L, "text");
+            lua_settable(L, -3);
+
+            auto* text = dynamic_cast<Text*>(e);
+            lua_pushstring(L, text->getText().c_str());
+            lua_setfield(L, -2, "text");
+            lua_createtable(L, 0, 2);
+            lua_pushstring(L, text->getFontName().c_str());
+            lua_setfield(L, -2, "name");
+            lua_pushnumber(L, text->getFontSize());
+            lua_setfield(L, -2, "size");
+            lua_setfield(L, -2, "font");
+            break;
+        }
+        case ELEMENT_TEXIMAGE:
+            lua_pushliteral(L, "teximage");
+            lua_settable(L, -3);
+
+            lua_pushstring(L, dynamic_cast<TexImage*>(e)->getText().c_str());
+            lua_setfield(L, -2, "text");
+            break;
+        default:
+            lua_pushliteral(L, "image");
+            lua_settable(L, -3);
+            break;
+    }
+}
+
+/**
+ * Helper function for app.getElements and job.getElements (see Plugin::readElementQuery()): reads the arguments
+ */
+static ElementQuery readElementQueryHelper(lua_State* L) {
+    // Discard any extra arguments passed in
+    lua_settop(L, 1);
+    if (lua_isnoneornil(L, 1)) {
+        lua_settop(L, 0);
+        lua_newtable(L);
+    }
+    luaL_checktype(L, 1, LUA_TTABLE);
+
+    ElementQuery query;
+    lua_getfield(L, 1, "page");
+    query.page = luaL_optinteger(L, -1, 0);
+    lua_getfield(L, 1, "layer");
+    query.layer = luaL_optinteger(L, -1, -1);
+    lua_pop(L, 2);
+
+    lua_getfield(L, 1, "bounds");
+    if (lua_istable(L, -1)) {
+        lua_getfield(L, -1, "x");
+        lua_getfield(L, -2, "y");
+        lua_getfield(L, -3, "width");
+        lua_getfield(L, -4, "height");
+        query.bounds.emplace(luaL_checknumber(L, -4), luaL_checknumber(L, -3), luaL_checknumber(L, -2),
+                             luaL_checknumber(L, -1));
+        lua_pop(L, 4);
+    }
+    lua_pop(L, 1);
+    return query;
+}
+
+/**
+ * Helper function for app.getElements and job.getElements (see Plugin::copyElements()): copies the elements selected
+ * by the query, on the given page if the query has none. Returns an error message, empty on success.
+ */
+static std::string copyElementsHelper(Document* doc, PageRef page, const ElementQuery& query, ElementCopies& elements) {
+    doc->lockShared();
+
+    if (query.page != 0) {
+        page = query.page >= 1 && static_cast<size_t>(query.page) <= doc->getPageCount() ?
+                       doc->getPage(static_cast<size_t>(query.page - 1)) :
+                       PageRef();
+    }
+    if (!page) {
+        doc->unlockShared();
+        return FS(FORMAT_STR("No page {1}!") % static_cast<int64_t>(query.page));
+    }
+    auto& layers = *page->getLayers();
+    if (query.layer != -1 && (query.layer < 1 || static_cast<size_t>(query.layer) > layers.size())) {
+        doc->unlockShared();
+        return FS(FORMAT_STR("No layer {1} on this page!") % static_cast<int64_t>(query.layer));
+    }
+
+    // The copies of compact strokes share the geometry, they are cheap
+    for (size_t l = 0; l < layers.size(); l++) {
+        if (query.layer != -1 && static_cast<size_t>(query.layer) != l + 1) {
+            continue;
+        }
+        for (Element* e: layers[l]->getElements()) {
+            if (query.bounds && !e->intersectsArea(query.bounds->x, query.bounds->y, query.bounds->width,
+                                                   query.bounds->height)) {
+                continue;
+            }
+            // The copy keeps the size: the Lua tables may be built on another thread, which must not measure texts
+            e->getElementWidth();
+            elements.emplace_back(e->clone(), static_cast<int>(l + 1));
+        }
+    }
+
+    doc->unlockShared();
+    return {};
+}
+
+/**
+ * Helper function for app.getElements and job.getElements (see Plugin::pushElements())
+ */
+static void pushElementsHelper(lua_State* L, const ElementCopies& elements) {
+    lua_createtable(L, static_cast<int>(elements.size()), 0);
+    lua_Integer count = 0;
+    for (auto&& [e, layer]: elements) {
+        pushElementHelper(L, e.get(), layer);
+        lua_rawseti(L, -2, ++count);
+    }
+}
+
+/**
+ * Helper function for app.getElements: pushes the elements selected by the query, or the error message. Returns
+ * whether it succeeded. The caller raises the error, once the C++ objects are destroyed.
+ */
+static bool pushElementsOrErrorHelper(lua_State* L, Document* doc, PageRef page, const ElementQuery& query) {
+    ElementCopies elements;
+    std::string error = copyElementsHelper(doc, std::move(page), query, elements);
+    if (!error.empty()) {
+        lua_pushstring(L, error.c_str());
+        return false;
+    }
+    pushElementsHelper(L, elements);
+    return true;
+}
+
+/**
+ * Returns the elements of a page, or of one of its layers, in a Lua table of the shape
+ * {
+ *   {
+ *     "type" = "stroke" | "text" | "image" | "teximage",
+ *     "layer" = integer,
+ *     "bounds" = {"x" = number, "y" = number, "width" = number, "height" = number},
+ *     "color" = integer,
+ *     -- for strokes
+ *     "tool" = "pen" | "highlighter" | "eraser",
+ *     "width" = number,
+ *     "fill" = integer,
+ *     "lineStyle" = string,
+ *     "pressure" = bool,
+ *     "count" = integer,
+ *     "points" = string (count packed (x, y, pressure) triples of native doubles, pressure is -1 if there is none),
+ *     -- for texts
+ *     "text" = string,
+ *     "font" = {"name" = string, "size" = number},
+ *     -- for LaTeX images
+ *     "text" = string,
+ *   },
+ *   ...
+ * }
+ * in the order of the layers, then of the elements of each layer.
+ *
+ * Optional Arguments: page, layer, bounds
+ *
+ * The page defaults to the current page. Without a layer, the elements of all layers are returned.
+ * With bounds, only the elements whose bounding box intersects the rectangle are returned.
+ * The points of a stroke can be read with string.unpack("ddd", points, 24 * i + 1), or passed as
+ * they are to app.addStrokesPacked (with "pressure" = true).
+ *
+ * The document is only locked for reading: rendering goes on meanwhile.
+ *
+ * Example: local elements = app.getElements({["page"] = 2, ["layer"] = 1,
+ *                                            ["bounds"] = {["x"] = 0, ["y"] = 0, ["width"] = 100, ["height"] = 100}})
+ */
+static int applib_getElements(lua_State* L) {
+    Control* control = Plugin::getPluginFromLua(L)->getControl();
+    ElementQuery query = readElementQueryHelper(L);
+
+    // Control::getCurrentPage() locks the document on its own
+    if (!pushElementsOrErrorHelper(L, control->getDocument(), query.page == 0 ? control->getCurrentPage() : PageRef(),
+                                   query)) {
+        return lua_error(L);
+    }
+    return 1;
+}
+
 /**
  * Scrolls to the page specified relatively or absolutely (by default)
  * The page number is clamped to the range between the first and last page
@@ -1722,6 +2231,7 @@ static const luaL_Reg applib[] = {{"msgbox", applib_msgbox},
                                   {"changeBackgroundPdfPageNr", applib_changeBackgroundPdfPageNr},
                                   {"getToolInfo", applib_getToolInfo},
                                   {"getDocumentStructure", applib_getDocumentStructure},
+                                  {"getElements", applib_getElements},
                                   {"scrollToPage", applib_scrollToPage},
                                   {"scrollToPos", applib_scrollToPos},
                                   {"setCurrentPage", applib_setCurrentPage},
@@ -1734,6 +2244,9 @@ static const luaL_Reg applib[] = {{"msgbox", applib_msgbox},
                                   {"getDisplayDpi", applib_getDisplayDpi},
                                   {"export", applib_export},
                                   {"addStrokes", applib_addStrokes},
+                                  {"addStrokesPacked", applib_addStrokesPacked},
+                                  {"startJob", applib_startJob},
+                                  {"cancelJob", applib_cancelJob},
                                   {"addSplines", applib_addSplines},
                                   {"getFilePath", applib_getFilePath},
                                   {"refreshPage", applib_refreshPage},
@@ -6,6 +6,7 @@
 #include "model/Element.h"
 #include "model/Layer.h"
 #include "model/PageRef.h"
+#include "util/Range.h"
 #include "util/i18n.h"
 
 InsertUndoAction::InsertUndoAction(const PageRef& page, Layer* layer, Element* element):
@@ -77,11 +78,28 @@ InsertsUndoAction::~InsertsUndoAction() {
 
 auto InsertsUndoAction::getText() -> std::string { return _("Insert elements"); }
 
-auto InsertsUndoAction::undo(Control* control) -> bool {
-    for (Element* elem: this->elements) {
-        this->layer->removeElement(elem, false);
-        this->page->fireElementChanged(elem);
+void InsertsUndoAction::addElements(const std::vector<Element*>& added) {
+    this->elements.insert(this->elements.end(), added.begin(), added.end());
+}
+
+/**
+ * Repaints the union of the elements at once, rather than one after the other
+ */
+static void fireElementsChanged(const PageRef& page, const std::vector<Element*>& elements) {
+    if (elements.empty()) {
+        return;
+    }
+    Range range(elements.front()->getX(), elements.front()->getY());
+    for (Element* e: elements) {
+        range.addPoint(e->getX(), e->getY());
+        range.addPoint(e->getX() + e->getElementWidth(), e->getY() + e->getElementHeight());
     }
+    page->fireRangeChanged(range);
+}
+
+auto InsertsUndoAction::undo(Control* control) -> bool {
+    this->layer->removeElements(this->elements);
+    fireElementsChanged(this->page, this->elements);
 
     this->undone = true;
 
@@ -89,10 +107,8 @@ auto InsertsUndoAction::undo(Control* control) -> bool {
 }
 
 auto InsertsUndoAction::redo(Control* control) -> bool {
-    for (Element* elem: this->elements) {
-        this->layer->addElement(elem);
-        this->page->fireElementChanged(elem);
-    }
+    this->layer->addElements(this->elements);
+    fireElementsChanged(this->page, this->elements);
 
     this->undone = false;
 
@@ -43,6 +43,11 @@ public:
 
     std::string getText() override;
 
+    /**
+     * @brief Extend the action with elements just added to its layer. Only valid for the last action of the undo list.
+     */
+    void addElements(const std::vector<Element*>& added);
+
 private:
     Layer* layer;
     std::vector<Element*> elements;
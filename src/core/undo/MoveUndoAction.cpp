@@ -14,8 +14,7 @@ MoveUndoAction::MoveUndoAction(Layer* sourceLayer, const PageRef& sourcePage, st
     this->sourceLayer = sourceLayer;
     this->text = _("Move");
 
-    this->dx = mx;
-    this->dy = my;
+    this->transform = ElementTransform::translation(mx, my);
 
     this->elements = *selected;
 
@@ -29,9 +28,9 @@ MoveUndoAction::~MoveUndoAction() = default;
 
 void MoveUndoAction::move() {
     if (this->undone) {
-        for (Element* e: this->elements) { e->move(dx, dy); }
+        this->transform.applyTo(this->elements);
     } else {
-        for (Element* e: this->elements) { e->move(-dx, -dy); }
+        this->transform.inverse().applyTo(this->elements);
     }
 }
 
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include "model/ElementTransform.h"
+
 #include "UndoAction.h"
 
 class Layer;
@@ -42,6 +44,5 @@ private:
 
     std::string text;
 
-    double dx = 0;
-    double dy = 0;
+    ElementTransform transform;
 };
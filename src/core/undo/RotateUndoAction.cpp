@@ -10,39 +10,30 @@ RotateUndoAction::RotateUndoAction(const PageRef& page, std::vector<Element*>* e
         UndoAction("RotateUndoAction") {
     this->page = page;
     this->elements = *elements;
-    this->x0 = x0;
-    this->y0 = y0;
-    this->rotation = rotation;
+    this->transform = ElementTransform::rotation(x0, y0, rotation);
 }
 
 RotateUndoAction::~RotateUndoAction() { this->page = nullptr; }
 
 auto RotateUndoAction::undo(Control* control) -> bool {
-    applyRotation(-this->rotation);
+    applyRotation(this->transform.inverse());
     this->undone = true;
     return true;
 }
 
 auto RotateUndoAction::redo(Control* control) -> bool {
-    applyRotation(this->rotation);
+    applyRotation(this->transform);
     this->undone = false;
     return true;
 }
 
-void RotateUndoAction::applyRotation(double rotation) {
+void RotateUndoAction::applyRotation(const ElementTransform& transform) {
     if (this->elements.empty()) {
         return;
     }
 
     Range r(elements.front()->getX(), elements.front()->getY());
-
-    for (Element* e: this->elements) {
-        r.addPoint(e->getX(), e->getY());
-        r.addPoint(e->getX() + e->getElementWidth(), e->getY() + e->getElementHeight());
-        e->rotate(this->x0, this->y0, rotation);
-        r.addPoint(e->getX(), e->getY());
-        r.addPoint(e->getX() + e->getElementWidth(), e->getY() + e->getElementHeight());
-    }
+    transform.applyTo(this->elements, &r);
 
     this->page->fireRangeChanged(r);
 }
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include "model/ElementTransform.h"
+
 #include "UndoAction.h"
 
 class RotateUndoAction: public UndoAction {
@@ -24,12 +26,10 @@ public:
     std::string getText() override;
 
 private:
-    void applyRotation(double rotation);
+    void applyRotation(const ElementTransform& transform);
 
 private:
     std::vector<Element*> elements;
 
-    double x0;
-    double y0;
-    double rotation = 0;
+    ElementTransform transform;
 };
@@ -12,42 +12,31 @@ ScaleUndoAction::ScaleUndoAction(const PageRef& page, std::vector<Element*>* ele
         UndoAction("ScaleUndoAction") {
     this->page = page;
     this->elements = *elements;
-    this->x0 = x0;
-    this->y0 = y0;
-    this->fx = std::isfinite(fx) ? fx : 1.0;
-    this->fy = std::isfinite(fy) ? fy : 1.0;
-    this->rotation = rotation;
-    this->restoreLineWidth = restoreLineWidth;
+    this->transform = ElementTransform::scaling(x0, y0, std::isfinite(fx) ? fx : 1.0, std::isfinite(fy) ? fy : 1.0,
+                                                rotation, restoreLineWidth);
 }
 
 ScaleUndoAction::~ScaleUndoAction() { this->page = nullptr; }
 
 auto ScaleUndoAction::undo(Control* control) -> bool {
-    applyScale(1 / this->fx, 1 / this->fy, restoreLineWidth);
+    applyScale(this->transform.inverse());
     this->undone = true;
     return true;
 }
 
 auto ScaleUndoAction::redo(Control* control) -> bool {
-    applyScale(this->fx, this->fy, restoreLineWidth);
+    applyScale(this->transform);
     this->undone = false;
     return true;
 }
 
-void ScaleUndoAction::applyScale(double fx, double fy, bool restoreLineWidth) {
+void ScaleUndoAction::applyScale(const ElementTransform& transform) {
     if (this->elements.empty()) {
         return;
     }
 
     Range r(elements.front()->getX(), elements.front()->getY());
-
-    for (Element* e: this->elements) {
-        r.addPoint(e->getX(), e->getY());
-        r.addPoint(e->getX() + e->getElementWidth(), e->getY() + e->getElementHeight());
-        e->scale(this->x0, this->y0, fx, fy, this->rotation, restoreLineWidth);
-        r.addPoint(e->getX(), e->getY());
-        r.addPoint(e->getX() + e->getElementWidth(), e->getY() + e->getElementHeight());
-    }
+    transform.applyTo(this->elements, &r);
 
     this->page->fireRangeChanged(r);
 }
@@ -11,6 +11,8 @@
 
 #pragma once
 
+#include "model/ElementTransform.h"
+
 #include "UndoAction.h"
 
 class ScaleUndoAction: public UndoAction {
@@ -25,15 +27,10 @@ public:
     std::string getText() override;
 
 private:
-    void applyScale(double fx, double fy, bool restoreLineWidth);
+    void applyScale(const ElementTransform& transform);
 
 private:
     std::vector<Element*> elements;
 
-    double x0;
-    double y0;
-    double fx;
-    double fy;
-    double rotation;
-    bool restoreLineWidth;
+    ElementTransform transform;
 };
@@ -4,6 +4,8 @@
 #include <cinttypes>
 
 #include "control/Control.h"
+#include "model/Layer.h"
+#include "model/XojPage.h"
 #include "util/XojMsgBox.h"
 #include "util/i18n.h"
 
@@ -36,6 +38,17 @@ inline void printUndoList(std::deque<PtrType> list) {
     for (auto&& action: list) { printAction(action); }
 }
 
+/**
+ * Undoing and redoing may move or change the elements in place, which the spatial indexes of the layers do not follow
+ */
+static void invalidateElementIndexes(const std::vector<PageRef>& pages) {
+    for (const PageRef& page: pages) {
+        if (page) {
+            for (Layer* layer: *page->getLayers()) { layer->invalidateElementIndex(); }
+        }
+    }
+}
+
 #ifdef UNDO_TRACE
 constexpr bool UNDO_TRACE = true;
 #else
@@ -85,6 +98,7 @@ void UndoRedoHandler::clearRedo() {
     }
 #endif
     redoList.clear();
+    this->revision++;
     printContents();
 }
 
@@ -98,10 +112,12 @@ void UndoRedoHandler::undo() {
     auto& undoAction = *this->undoList.back();
     this->redoList.emplace_back(std::move(this->undoList.back()));
     this->undoList.pop_back();
+    this->revision++;
 
     Document* doc = control->getDocument();
     doc->lock();
     bool undoResult = undoAction.undo(this->control);
+    invalidateElementIndexes(undoAction.getPages());
     doc->unlock();
 
     if (!undoResult) {
@@ -127,10 +143,12 @@ void UndoRedoHandler::redo() {
 
     this->undoList.emplace_back(std::move(this->redoList.back()));
     this->redoList.pop_back();
+    this->revision++;
 
     Document* doc = control->getDocument();
     doc->lock();
     bool redoResult = redoAction.redo(this->control);
+    invalidateElementIndexes(redoAction.getPages());
     doc->unlock();
 
     if (!redoResult) {
@@ -246,8 +264,12 @@ auto UndoRedoHandler::isChangedAutosave() -> bool {
 
 void UndoRedoHandler::documentAutosaved() {
     this->autosavedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
+    this->revision++;
 }
 
 void UndoRedoHandler::documentSaved() {
     this->savedUndo = this->undoList.empty() ? nullptr : this->undoList.back().get();
+    this->revision++;
 }
+
+auto UndoRedoHandler::getRevision() const -> size_t { return this->revision; }
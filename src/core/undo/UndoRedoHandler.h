@@ -58,6 +58,12 @@ public:
     void documentAutosaved();
     void documentSaved();
 
+    /**
+     * @return A number changed by every modification of the undo and redo lists, and by every save: the last action
+     * is the same as at a previous call, and may be extended, while the revision did not change
+     */
+    size_t getRevision() const;
+
 private:
     void clearRedo();
     void printContents();
@@ -69,6 +75,8 @@ private:
     UndoAction* savedUndo = nullptr;
     UndoAction* autosavedUndo = nullptr;
 
+    size_t revision = 0;
+
     std::vector<UndoRedoListener*> listener;
 
     Control* control = nullptr;
@@ -20,6 +20,8 @@ void DocumentView::setMarkAudioStroke(bool markAudioStroke) { this->markAudioStr
 
 void DocumentView::setPdfCache(PdfCache* cache) { pdfCache = cache; }
 
+void DocumentView::setTexImageCache(xoj::view::TexImageCache* cache) { texImageCache = cache; }
+
 /**
  * Drawing first step
  * @param page The page to draw
@@ -85,7 +87,8 @@ void DocumentView::drawPage(PageRef page, cairo_t* cr, bool dontRenderEditingStr
     }
 
     xoj::view::Context context{cr, (xoj::view::NonAudioTreatment)this->markAudioStroke,
-                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR};
+                               (xoj::view::EditionTreatment) !this->dontRenderEditingStroke, xoj::view::NORMAL_COLOR,
+                               this->texImageCache};
     for (Layer* layer: *page->getLayers()) {
         if (layer->isVisible()) {
             xoj::view::LayerView layerView(layer);
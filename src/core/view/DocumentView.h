@@ -28,6 +28,7 @@ class Document;
 class PdfCache;
 namespace xoj::view {
 struct BackgroundFlags;
+class TexImageCache;
 };
 
 class DocumentView {
@@ -57,6 +58,11 @@ public:
 public:
     void setPdfCache(PdfCache* cache);
 
+    /**
+     * Paint the LaTeX elements from the rasters of this cache, for on-screen rendering
+     */
+    void setTexImageCache(xoj::view::TexImageCache* cache);
+
     /**
      * Drawing first step
      * @param page The page to draw
@@ -84,6 +90,7 @@ private:
     cairo_t* cr = nullptr;
     PageRef page = nullptr;
     PdfCache* pdfCache = nullptr;
+    xoj::view::TexImageCache* texImageCache = nullptr;
     bool dontRenderEditingStroke = false;
     bool markAudioStroke = false;
 
@@ -15,6 +15,18 @@ using namespace xoj::view;
 StrokeView::StrokeView(const Stroke* s): s(s) {}
 
 void StrokeView::pathToCairo(cairo_t* cr) const {
+    if (const StrokeGeometry* geometry = s->getCompactGeometry(); geometry) {
+        bool first = true;
+        geometry->forEachPosition([cr, &first](double x, double y) {
+            if (first) {
+                cairo_move_to(cr, x, y);
+                first = false;
+            } else {
+                cairo_line_to(cr, x, y);
+            }
+        });
+        return;
+    }
     for_first_then_each(
             s->getPointVector(), [cr](auto const& first) { cairo_move_to(cr, first.x, first.y); },
             [cr](auto const& other) { cairo_line_to(cr, other.x, other.y); });
@@ -46,17 +58,35 @@ void StrokeView::drawWithPressure(cairo_t* cr) const {
     s->getLineStyle().getDashes(dashes, dashCount);
     assert((dashCount == 0 && dashes == nullptr) || (dashCount != 0 && dashes != nullptr));
 
-    for (auto p1i = begin(s->getPointVector()), p2i = std::next(p1i), endi = end(s->getPointVector());
-         p1i != endi && p2i != endi; ++p1i, ++p2i) {
-        auto width = p1i->z != Point::NO_PRESSURE ? p1i->z : s->getWidth();
+    auto drawSegment = [&](const Point& p1, const Point& p2) {
+        auto width = p1.z != Point::NO_PRESSURE ? p1.z : s->getWidth();
         cairo_set_line_width(cr, width);
         if (dashes) {
             cairo_set_dash(cr, dashes, dashCount, dashOffset);
-            dashOffset += p1i->lineLengthTo(*p2i);
+            dashOffset += p1.lineLengthTo(p2);
         }
-        cairo_move_to(cr, p1i->x, p1i->y);
-        cairo_line_to(cr, p2i->x, p2i->y);
+        cairo_move_to(cr, p1.x, p1.y);
+        cairo_line_to(cr, p2.x, p2.y);
         cairo_stroke(cr);
+    };
+
+    if (const StrokeGeometry* geometry = s->getCompactGeometry(); geometry) {
+        // Read the compact geometry directly, so that drawing does not decode the stroke
+        bool first = true;
+        Point previous;
+        geometry->forEachPoint([&](const Point& p) {
+            if (!first) {
+                drawSegment(previous, p);
+            }
+            first = false;
+            previous = p;
+        });
+        return;
+    }
+
+    for (auto p1i = begin(s->getPointVector()), p2i = std::next(p1i), endi = end(s->getPointVector());
+         p1i != endi && p2i != endi; ++p1i, ++p2i) {
+        drawSegment(*p1i, *p2i);
     }
 }
 
@@ -0,0 +1,124 @@
+#include "TexImageCache.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include <poppler.h>
+
+#include "model/TexImage.h"
+
+using namespace xoj::view;
+
+namespace {
+
+/**
+ * Zoom buckets are powers of sqrt(2), the exponent is clamped to this range
+ */
+constexpr int MIN_BUCKET = -8;
+constexpr int MAX_BUCKET = 14;
+
+/**
+ * A single raster may not take more than this part of the budget: larger ones are rendered as vectors
+ */
+constexpr size_t MAX_ENTRY_FRACTION = 4;
+
+auto isRasterTarget(cairo_t* cr) -> bool {
+    return cairo_surface_get_type(cairo_get_group_target(cr)) == CAIRO_SURFACE_TYPE_IMAGE;
+}
+
+/**
+ * @return The number of device pixels per unit of the user space of cr
+ */
+auto getDeviceScale(cairo_t* cr) -> double {
+    cairo_matrix_t m;
+    cairo_get_matrix(cr, &m);
+    double scale = std::sqrt(std::abs(m.xx * m.yy - m.xy * m.yx));
+
+    double sx = 1.0;
+    double sy = 1.0;
+    cairo_surface_get_device_scale(cairo_get_group_target(cr), &sx, &sy);
+    return scale * std::max(sx, sy);
+}
+
+auto getBucket(double scale) -> int {
+    int bucket = static_cast<int>(std::ceil(2.0 * std::log2(scale) - 1e-9));
+    return std::clamp(bucket, MIN_BUCKET, MAX_BUCKET);
+}
+
+auto getBucketScale(int bucket) -> double { return std::pow(2.0, 0.5 * bucket); }
+
+auto render(PopplerPage* page, int width, int height) -> cairo_surface_t* {
+    double pageWidth = 0;
+    double pageHeight = 0;
+    poppler_page_get_size(page, &pageWidth, &pageHeight);
+
+    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, width, height);
+    cairo_t* cr = cairo_create(surface);
+    cairo_scale(cr, width / pageWidth, height / pageHeight);
+    poppler_page_render(page, cr);
+    cairo_destroy(cr);
+    return surface;
+}
+
+}  // namespace
+
+TexImageCache::~TexImageCache() { evict(0); }
+
+auto TexImageCache::paint(cairo_t* cr, const TexImage* texImage, double alpha) -> bool {
+    PopplerPage* page = texImage->getPdfPage();
+    if (page == nullptr || !isRasterTarget(cr)) {
+        return false;
+    }
+
+    const double elementWidth = texImage->getElementWidth();
+    const double elementHeight = texImage->getElementHeight();
+    const int bucket = getBucket(getDeviceScale(cr));
+    const double bucketScale = getBucketScale(bucket);
+    const double width = std::ceil(elementWidth * bucketScale);
+    const double height = std::ceil(elementHeight * bucketScale);
+    if (width < 1 || height < 1 || width * height * 4 > static_cast<double>(DEFAULT_BUDGET / MAX_ENTRY_FRACTION)) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+
+    const Key key{texImage->getRenderRevision(), bucket};
+    auto it = entryIndex.find(key);
+    if (it != entryIndex.end()) {
+        entries.splice(entries.begin(), entries, it->second);
+    } else {
+        // Poppler is not thread safe: the page is only rendered with the lock held
+        cairo_surface_t* surface = render(page, static_cast<int>(width), static_cast<int>(height));
+        size_t bytes = static_cast<size_t>(cairo_image_surface_get_stride(surface)) * static_cast<size_t>(height);
+        entries.push_front({key.first, key.second, surface, bytes});
+        entryIndex[key] = entries.begin();
+        usedBytes += bytes;
+        evict(DEFAULT_BUDGET);
+    }
+
+    cairo_surface_t* surface = entries.front().surface;
+
+    cairo_save(cr);
+    cairo_translate(cr, texImage->getX(), texImage->getY());
+    cairo_scale(cr, elementWidth / width, elementHeight / height);
+    cairo_set_source_surface(cr, surface, 0, 0);
+    if (alpha < 1.0) {
+        cairo_paint_with_alpha(cr, alpha);
+    } else {
+        cairo_paint(cr);
+    }
+    cairo_restore(cr);
+
+    return true;
+}
+
+void TexImageCache::evict(size_t budget) {
+    while (usedBytes > budget && !entries.empty()) {
+        Entry& e = entries.back();
+        cairo_surface_destroy(e.surface);
+        usedBytes -= e.bytes;
+        entryIndex.erase({e.revision, e.bucket});
+        entries.pop_back();
+    }
+}
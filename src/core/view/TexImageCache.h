@@ -0,0 +1,80 @@
+/*
+ * Xournal++
+ *
+ * Caches rasterized LaTeX elements for faster repaint
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <mutex>
+#include <utility>
+
+#include <cairo.h>
+
+#include "View.h"
+
+class TexImage;
+
+/**
+ * Rendering the PDF of a TexImage through poppler is slow, and happens on every repaint of the page area. Instead, the
+ * PDF is rendered once per zoom bucket (the zoom rounded up to a power of sqrt(2)) into an image surface, which is then
+ * painted scaled.
+ *
+ * The cache is owned by the XournalView and handed to the on-screen rendering through xoj::view::Context. It holds at
+ * most DEFAULT_BUDGET bytes of pixels: the least recently used rasters are dropped first. Entries are identified by
+ * TexImage::getRenderRevision(), so a TexImage whose text, PDF or size changed gets a new raster; the outdated ones are
+ * never painted again and age out of the cache.
+ */
+class xoj::view::TexImageCache {
+public:
+    static constexpr size_t DEFAULT_BUDGET = 32 * 1024 * 1024;
+
+    TexImageCache() = default;
+    TexImageCache(const TexImageCache&) = delete;
+    TexImageCache& operator=(const TexImageCache&) = delete;
+    ~TexImageCache();
+
+    /**
+     * @brief Paint the PDF of texImage, scaled to the element size and at its position, from a cached raster.
+     *
+     * Only done if the target of cr is an image surface: on vector surfaces the PDF must be rendered as vectors.
+     *
+     * @param alpha The opacity used to paint the raster
+     * @return false if nothing was painted, and the caller should render the PDF itself
+     */
+    bool paint(cairo_t* cr, const TexImage* texImage, double alpha = 1.0);
+
+private:
+    struct Entry {
+        uint64_t revision;
+        int bucket;
+        cairo_surface_t* surface;
+        size_t bytes;
+    };
+
+    using Key = std::pair<uint64_t, int>;
+
+    /**
+     * Drop the least recently used rasters until at most budget bytes are used
+     */
+    void evict(size_t budget);
+
+private:
+    std::mutex cacheMutex;
+
+    /**
+     * Most recently used first
+     */
+    std::list<Entry> entries;
+    std::map<Key, std::list<Entry>::iterator> entryIndex;
+    size_t usedBytes = 0;
+};
@@ -2,6 +2,8 @@
 
 #include "model/TexImage.h"
 
+#include "TexImageCache.h"
+
 using namespace xoj::view;
 
 TexImageView::TexImageView(const TexImage* texImage): texImage(texImage) {}
@@ -17,12 +19,20 @@ void TexImageView::draw(const Context& ctx) const {
     cairo_surface_t* img = texImage->getImage();
 
     if (pdf != nullptr) {
-        if (poppler_document_get_n_pages(pdf) < 1) {
+        PopplerPage* page = texImage->getPdfPage();
+        if (page == nullptr) {
             g_warning("Got latex PDF without pages!: %s", texImage->getText().c_str());
+            cairo_restore(cr);
             return;
         }
 
-        PopplerPage* page = poppler_document_get_page(pdf, 0);
+        // On screen, paint a cached raster. Exports and printing keep the vector rendering
+        // Make TeX images translucent when highlighting audio strokes as they can not have audio
+        if (ctx.texImageCache &&
+            ctx.texImageCache->paint(cr, texImage, ctx.fadeOutNonAudio ? OPACITY_NO_AUDIO : 1.0)) {
+            cairo_restore(cr);
+            return;
+        }
 
         double pageWidth = 0;
         double pageHeight = 0;
@@ -50,8 +60,6 @@ void TexImageView::draw(const Context& ctx) const {
         } else {
             poppler_page_render(page, cr);
         }
-
-        g_clear_object(&page);
     } else if (img != nullptr) {
         int width = cairo_image_surface_get_width(img);
         int height = cairo_image_surface_get_height(img);
@@ -1,5 +1,12 @@
 #include "TextView.h"
 
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <utility>
+
 #include "control/settings/Settings.h"
 #include "model/Text.h"
 #include "pdf/base/XojPdfPage.h"
@@ -8,6 +15,114 @@
 
 using namespace xoj::view;
 
+namespace {
+
+/**
+ * Shaped layouts kept in the cache of each thread. A layout takes a few kilobytes.
+ */
+constexpr size_t MAX_CACHED_LAYOUTS = 1024;
+
+/**
+ * The font descriptions are all dropped when there are more than this (the font sizes of scaled texts are arbitrary)
+ */
+constexpr size_t MAX_CACHED_FONTS = 256;
+
+/**
+ * The text revision, the font name and size, and the hash of the font options of the target surface
+ */
+using LayoutKey = std::tuple<uint64_t, std::string, double, unsigned long>;
+
+/**
+ * Shaped layouts, most recently used first. PangoLayout is not thread-safe, and a layout is bound to the font map of
+ * the thread which created it, so every thread has its own cache.
+ */
+struct LayoutCache {
+    std::list<std::pair<LayoutKey, PangoLayout*>> layouts;
+    std::map<LayoutKey, decltype(layouts)::iterator> index;
+
+    ~LayoutCache() {
+        for (auto&& [key, layout]: layouts) { g_object_unref(layout); }
+    }
+};
+
+thread_local LayoutCache layoutCache;
+
+std::mutex fontMutex;
+std::map<std::pair<std::string, double>, PangoFontDescription*> fontDescriptions;
+
+auto getFontOptionsHash(cairo_t* cr) -> unsigned long {
+    cairo_font_options_t* options = cairo_font_options_create();
+    cairo_surface_get_font_options(cairo_get_target(cr), options);
+    unsigned long hash = cairo_font_options_hash(options);
+    cairo_font_options_destroy(options);
+    return hash;
+}
+
+/**
+ * Texts are measured and searched with a layout for a 1x1 image surface
+ */
+auto createMeasureSurface() -> cairo_surface_t* { return cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1); }
+
+auto getMeasureFontOptionsHash() -> unsigned long {
+    static const unsigned long hash = [] {
+        cairo_surface_t* surface = createMeasureSurface();
+        cairo_t* cr = cairo_create(surface);
+        unsigned long h = getFontOptionsHash(cr);
+        cairo_destroy(cr);
+        cairo_surface_destroy(surface);
+        return h;
+    }();
+    return hash;
+}
+
+/**
+ * @return A new layout of the text t, shaped for the target of cr (or for measuring if cr is nullptr)
+ */
+auto createLayout(cairo_t* cr, const Text* t) -> PangoLayout* {
+    PangoLayout* layout = nullptr;
+    if (cr) {
+        layout = TextView::initPango(cr, t);
+    } else {
+        cairo_surface_t* surface = createMeasureSurface();
+        cairo_t* measureCr = cairo_create(surface);
+        layout = TextView::initPango(measureCr, t);
+        cairo_destroy(measureCr);
+        cairo_surface_destroy(surface);
+    }
+    std::string content = t->getText();
+    pango_layout_set_text(layout, content.c_str(), static_cast<int>(content.length()));
+    return layout;
+}
+
+/**
+ * @brief Call fn(PangoLayout*) with the layout of the text t, shaped for the target of cr (or for measuring if cr is
+ * nullptr). The layout is taken from the cache of the calling thread, or created and cached.
+ */
+template <typename Fn>
+void withLayout(cairo_t* cr, const Text* t, Fn&& fn) {
+    LayoutKey key{t->getTextRevision(), t->getFontName(), t->getFontSize(),
+                  cr ? getFontOptionsHash(cr) : getMeasureFontOptionsHash()};
+
+    auto& cache = layoutCache;
+    auto it = cache.index.find(key);
+    if (it != cache.index.end()) {
+        cache.layouts.splice(cache.layouts.begin(), cache.layouts, it->second);
+    } else {
+        cache.layouts.emplace_front(key, createLayout(cr, t));
+        cache.index[std::move(key)] = cache.layouts.begin();
+
+        while (cache.layouts.size() > MAX_CACHED_LAYOUTS) {
+            g_object_unref(cache.layouts.back().second);
+            cache.index.erase(cache.layouts.back().first);
+            cache.layouts.pop_back();
+        }
+    }
+
+    fn(cache.layouts.front().second);
+}
+
+}  // namespace
+
 TextView::TextView(const Text* text): text(text) {}
 
 TextView::~TextView() = default;
@@ -27,15 +142,26 @@ auto TextView::initPango(cairo_t* cr, const Text* t) -> PangoLayout* {
 }
 
 void TextView::updatePangoFont(PangoLayout* layout, const Text* t) {
-    PangoFontDescription* desc = pango_font_description_from_string(t->getFontName().c_str());
-    pango_font_description_set_absolute_size(desc, t->getFontSize() * PANGO_SCALE);
-
 #if PANGO_VERSION_CHECK(1, 48, 5)  // see https://gitlab.gnome.org/GNOME/pango/-/issues/499
     pango_layout_set_line_spacing(layout, 1.0);
 #endif
 
-    pango_layout_set_font_description(layout, desc);
-    pango_font_description_free(desc);
+    // Parsing the font name is not free: the descriptions are shared by all the texts with the same font
+    std::lock_guard<std::mutex> lock(fontMutex);
+    auto key = std::make_pair(t->getFontName(), t->getFontSize());
+    auto it = fontDescriptions.find(key);
+    if (it == fontDescriptions.end()) {
+        if (fontDescriptions.size() >= MAX_CACHED_FONTS) {
+            for (auto&& [k, d]: fontDescriptions) { pango_font_description_free(d); }
+            fontDescriptions.clear();
+        }
+        PangoFontDescription* desc = pango_font_description_from_string(key.first.c_str());
+        pango_font_description_set_absolute_size(desc, key.second * PANGO_SCALE);
+        it = fontDescriptions.emplace(std::move(key), desc).first;
+    }
+
+    // The layout keeps a copy
+    pango_layout_set_font_description(layout, it->second);
 }
 
 void TextView::draw(const Context& ctx) const {
@@ -57,13 +183,7 @@ void TextView::draw(const Context& ctx) const {
 
     cairo_translate(ctx.cr, text->getX(), text->getY());
 
-    PangoLayout* layout = initPango(ctx.cr, text);
-    std::string content = text->getText();
-    pango_layout_set_text(layout, content.c_str(), static_cast<int>(content.length()));
-
-    pango_cairo_show_layout(ctx.cr, layout);
-
-    g_object_unref(layout);
+    withLayout(ctx.cr, text, [cr = ctx.cr](PangoLayout* layout) { pango_cairo_show_layout(cr, layout); });
 
     cairo_restore(ctx.cr);
 }
@@ -74,55 +194,43 @@ auto TextView::findText(const Text* t, std::string& search) -> std::vector<XojPd
         return {};
     }
 
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-    cairo_t* cr = cairo_create(surface);
-
-    PangoLayout* layout = initPango(cr, t);
-    std::string content = t->getText();
-    pango_layout_set_text(layout, content.c_str(), static_cast<int>(content.length()));
-
-
-    std::string text = StringUtils::toLowerCase(content);
+    std::string text = StringUtils::toLowerCase(t->getText());
 
     std::string pattern = StringUtils::toLowerCase(search);
 
-    std::vector<XojPdfRectangle> list;
-
+    std::vector<size_t> positions;
     for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1)) {
-        XojPdfRectangle mark;
-        PangoRectangle rect = {0};
-        pango_layout_index_to_pos(layout, static_cast<int>(pos), &rect);
-        mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + t->getX();
-        mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + t->getY();
+        positions.push_back(pos);
+    }
+    if (positions.empty()) {
+        return {};
+    }
 
-        pango_layout_index_to_pos(layout, static_cast<int>(pos + patternLength - 1), &rect);
-        mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + t->getX();
-        mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + t->getY();
+    std::vector<XojPdfRectangle> list;
 
-        list.push_back(mark);
-    }
+    withLayout(nullptr, t, [&](PangoLayout* layout) {
+        for (size_t pos: positions) {
+            XojPdfRectangle mark;
+            PangoRectangle rect = {0};
+            pango_layout_index_to_pos(layout, static_cast<int>(pos), &rect);
+            mark.x1 = (static_cast<double>(rect.x)) / PANGO_SCALE + t->getX();
+            mark.y1 = (static_cast<double>(rect.y)) / PANGO_SCALE + t->getY();
 
-    g_object_unref(layout);
-    cairo_surface_destroy(surface);
-    cairo_destroy(cr);
+            pango_layout_index_to_pos(layout, static_cast<int>(pos + patternLength - 1), &rect);
+            mark.x2 = (static_cast<double>(rect.x) + rect.width) / PANGO_SCALE + t->getX();
+            mark.y2 = (static_cast<double>(rect.y) + rect.height) / PANGO_SCALE + t->getY();
+
+            list.push_back(mark);
+        }
+    });
 
     return list;
 }
 
 void TextView::calcSize(const Text* t, double& width, double& height) {
-    cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 1, 1);
-    cairo_t* cr = cairo_create(surface);
-
-    PangoLayout* layout = initPango(cr, t);
-    std::string content = t->getText();
-    pango_layout_set_text(layout, content.c_str(), static_cast<int>(content.length()));
     int w = 0;
     int h = 0;
-    pango_layout_get_size(layout, &w, &h);
+    withLayout(nullptr, t, [&w, &h](PangoLayout* layout) { pango_layout_get_size(layout, &w, &h); });
     width = (static_cast<double>(w)) / PANGO_SCALE;
     height = (static_cast<double>(h)) / PANGO_SCALE;
-    g_object_unref(layout);
-
-    cairo_destroy(cr);
-    cairo_surface_destroy(surface);
 }
@@ -17,6 +17,11 @@
 
 class Text;
 
+/**
+ * The shaped Pango layouts of the texts are cached by each thread, keyed by Text::getTextRevision(), the font and the
+ * font options of the target surface, and shared by drawing, measuring and searching. The layouts are created with an identity font
+ * matrix (see initPango()), so the same layout serves all zoom levels.
+ */
 class xoj::view::TextView: public xoj::view::ElementView {
 public:
     TextView(const Text* t);
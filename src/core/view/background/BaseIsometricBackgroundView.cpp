@@ -16,6 +16,11 @@ BaseIsometricBackgroundView::BaseIsometricBackgroundView(double pageWidth, doubl
     config.loadValue(CFG_RASTER, triangleSize);
 }
 
+auto BaseIsometricBackgroundView::paintPeriodicGrid(cairo_t*, double, double, double, double, double, double) const
+        -> bool {
+    return false;
+}
+
 void BaseIsometricBackgroundView::draw(cairo_t* cr) const {
     // Paint the background color
     PlainBackgroundView::draw(cr);
@@ -34,6 +39,10 @@ void BaseIsometricBackgroundView::draw(cairo_t* cr) const {
     double contentXOffset = (pageWidth - contentWidth) / 2;
     double contentYOffset = (pageHeight - contentHeight) / 2;
 
+    if (paintPeriodicGrid(cr, xstep, ystep, contentXOffset, contentYOffset, contentWidth, contentHeight)) {
+        return;
+    }
+
     // Get the bounds of the mask, in page coordinates
     double minX;
     double maxX;
@@ -27,6 +27,14 @@ protected:
     virtual void paintGrid(cairo_t* cr, int cols, int rows, double xstep, double ystep, double xOffset,
                            double yOffset) const = 0;
 
+    /**
+     * @brief Paint the whole grid, of size contentWidth x contentHeight at (xOffset, yOffset), from a periodic pattern.
+     * See OneColorBackgroundView::paintPeriodic.
+     * @return false if the grid was not painted, and must be drawn with paintGrid
+     */
+    virtual bool paintPeriodicGrid(cairo_t* cr, double xstep, double ystep, double xOffset, double yOffset,
+                                   double contentWidth, double contentHeight) const;
+
 protected:
     double triangleSize = 14.17;  // 5mm
 
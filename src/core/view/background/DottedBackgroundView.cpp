@@ -20,6 +20,17 @@ void DottedBackgroundView::draw(cairo_t* cr) const {
     // Paint the background color
     PlainBackgroundView::draw(cr);
 
+    // The dots are at (i * squareSize, j * squareSize), for i, j >= 1
+    const double halfLineWidth = 0.5 * lineWidth;
+    const double start = squareSize - halfLineWidth;
+    if (paintPeriodic(cr, start, start, pageWidth + squareSize + halfLineWidth, pageHeight + squareSize + halfLineWidth,
+                      0.0, 0.0, squareSize, squareSize, CAIRO_LINE_CAP_ROUND, [](cairo_t* tileCr) {
+                          cairo_move_to(tileCr, 0.0, 0.0);
+                          cairo_line_to(tileCr, 0.0, 0.0);
+                      })) {
+        return;
+    }
+
     // Get the bounds of the mask, in page coordinates
     double minX;
     double maxX;
@@ -29,7 +40,6 @@ void DottedBackgroundView::draw(cairo_t* cr) const {
 
     //  Add a 0.5 * lineWidth padding in case the line is just outside the mask but its thickness still makes it
     //  (partially) visible
-    const double halfLineWidth = 0.5 * lineWidth;
     auto [indexMinX, indexMaxX] =
             getIndexBounds(minX - halfLineWidth, maxX + halfLineWidth, squareSize, squareSize, pageWidth);
     auto [indexMinY, indexMaxY] =
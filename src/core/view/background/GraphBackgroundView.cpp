@@ -25,6 +25,45 @@ void GraphBackgroundView::draw(cairo_t* cr) const {
     // Paint the background color
     PlainBackgroundView::draw(cr);
 
+    // Without margin, the grid is periodic past the first row and column (the lines at i * squareSize, for i >= 1)
+    const double halfLineWidth = 0.5 * lineWidth;
+    const double start = squareSize - halfLineWidth;
+    if (margin == 0.0 &&
+        paintPeriodic(cr, start, start, pageWidth + squareSize + halfLineWidth, pageHeight + squareSize + halfLineWidth,
+                      0.0, 0.0, squareSize, squareSize, CAIRO_LINE_CAP_SQUARE,
+                      [s = this->squareSize](cairo_t* tileCr) {
+                          cairo_move_to(tileCr, 0.0, 0.0);
+                          cairo_line_to(tileCr, s, 0.0);
+                          cairo_move_to(tileCr, 0.0, 0.0);
+                          cairo_line_to(tileCr, 0.0, s);
+                      })) {
+        // The first row and column only have lines in one direction
+        double minX;
+        double maxX;
+        double minY;
+        double maxY;
+        cairo_clip_extents(cr, &minX, &minY, &maxX, &maxY);
+        if (minX < start) {
+            cairo_save(cr);
+            cairo_rectangle(cr, minX, minY, start - minX, maxY - minY);
+            cairo_clip(cr);
+            drawLines(cr);
+            cairo_restore(cr);
+        }
+        if (minY < start && maxX > start) {
+            cairo_save(cr);
+            cairo_rectangle(cr, start, minY, maxX - start, start - minY);
+            cairo_clip(cr);
+            drawLines(cr);
+            cairo_restore(cr);
+        }
+        return;
+    }
+
+    drawLines(cr);
+}
+
+void GraphBackgroundView::drawLines(cairo_t* cr) const {
     // Get the bounds of the mask, in page coordinates
     double minX;
     double maxX;
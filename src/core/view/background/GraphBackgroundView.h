@@ -22,6 +22,12 @@ public:
 
     virtual void draw(cairo_t* cr) const override;
 
+protected:
+    /**
+     * @brief Draw the lines of the grid intersecting the mask of cr
+     */
+    void drawLines(cairo_t* cr) const;
+
 protected:
     bool roundUpMargin = false;
     double margin = 0.0;
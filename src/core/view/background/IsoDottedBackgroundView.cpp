@@ -33,3 +33,17 @@ void IsoDottedBackgroundView::paintGrid(cairo_t* cr, int cols, int rows, double
         }
     }
 }
+
+bool IsoDottedBackgroundView::paintPeriodicGrid(cairo_t* cr, double xstep, double ystep, double xOffset,
+                                                double yOffset, double contentWidth, double contentHeight) const {
+    // The dots are at (xOffset + i * xstep, yOffset + j * ystep) for i + j odd, so a period has two dots
+    const double halfLineWidth = 0.5 * lineWidth;
+    return paintPeriodic(cr, xOffset - halfLineWidth, yOffset - halfLineWidth, xOffset + contentWidth + halfLineWidth,
+                         yOffset + contentHeight + halfLineWidth, xOffset, yOffset, 2 * xstep, 2 * ystep,
+                         CAIRO_LINE_CAP_ROUND, [xstep, ystep](cairo_t* tileCr) {
+                             cairo_move_to(tileCr, xstep, 0.0);
+                             cairo_line_to(tileCr, xstep, 0.0);
+                             cairo_move_to(tileCr, 0.0, ystep);
+                             cairo_line_to(tileCr, 0.0, ystep);
+                         });
+}
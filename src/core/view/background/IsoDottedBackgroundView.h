@@ -24,6 +24,9 @@ protected:
     virtual void paintGrid(cairo_t* cr, int cols, int rows, double xstep, double ystep, double xOffset,
                            double yOffset) const override;
 
+    virtual bool paintPeriodicGrid(cairo_t* cr, double xstep, double ystep, double xOffset, double yOffset,
+                                   double contentWidth, double contentHeight) const override;
+
 protected:
     constexpr static double DEFAULT_LINE_WIDTH = 1.5;
 };
@@ -1,6 +1,12 @@
 #include "OneColorBackgroundView.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <typeindex>
+#include <typeinfo>
 
 #include "model/BackgroundConfig.h"
 #include "util/Util.h"
@@ -31,3 +37,208 @@ Color OneColorBackgroundView::getColorOr(const BackgroundConfig& config, const s
     }
     return defaultColor;
 }
+
+namespace {
+
+/**
+ * Largest side of a tile, in pixels. Patterns whose period is larger are not cached: they are sparse enough to be
+ * drawn directly.
+ */
+constexpr double MAX_TILE_SIZE = 512.0;
+
+/**
+ * A tile spans a whole number of periods, in a whole number of pixels, so its pixels are slightly smaller or larger
+ * than those of the target. Largest shift between both, in pixels, over the painted area, for the tile to be painted
+ * pixel by pixel. Beyond, it is interpolated.
+ */
+constexpr double MAX_MISALIGNMENT = 1.0 / 16.0;
+
+/**
+ * Number of tiles kept: one per background type, line width, color and zoom in use
+ */
+constexpr size_t MAX_CACHED_TILES = 16;
+
+struct TileKey {
+    std::type_index type;
+    double periodWidth;
+    double periodHeight;
+    int periodCountX;
+    int periodCountY;
+    double lineWidth;
+    uint32_t color;
+    cairo_line_cap_t lineCap;
+    int tileWidth;
+    int tileHeight;
+    double phaseX;
+    double phaseY;
+
+    bool operator==(const TileKey& other) const {
+        return type == other.type && periodWidth == other.periodWidth && periodHeight == other.periodHeight &&
+               periodCountX == other.periodCountX && periodCountY == other.periodCountY && lineWidth == other.lineWidth &&
+               color == other.color && lineCap == other.lineCap && tileWidth == other.tileWidth &&
+               tileHeight == other.tileHeight && phaseX == other.phaseX && phaseY == other.phaseY;
+    }
+};
+
+struct Tile {
+    TileKey key;
+    cairo_surface_t* surface;
+};
+
+std::mutex tileMutex;
+
+/**
+ * Most recently used first
+ */
+std::list<Tile> tiles;
+
+struct TileAxis {
+    int periodCount;  ///< Number of periods spanned by the tile, 0 if the period is too large for a tile
+    int size;         ///< In pixels
+    bool aligned;     ///< If the pixels of the tile stay within MAX_MISALIGNMENT of those of the target
+};
+
+/**
+ * @brief Choose the number of periods spanned by a tile along one axis: the fewest aligning the tile on the target,
+ * or else the one aligning it best.
+ *
+ * @param periodPixels Size of a period on the target, in pixels
+ * @param distancePixels Largest distance from the origin of the pattern to the painted area, in pixels
+ */
+auto chooseTileAxis(double periodPixels, double distancePixels) -> TileAxis {
+    TileAxis best{0, 0, false};
+    double bestMisalignment = 0.0;
+    for (int n = 1; n * periodPixels <= MAX_TILE_SIZE && !best.aligned; n++) {
+        const double size = n * periodPixels;
+        const double tileSize = std::round(size);
+        if (tileSize < 1.0) {
+            continue;
+        }
+        const double misalignment = distancePixels * std::abs(tileSize - size) / size;
+        if (best.periodCount == 0 || misalignment < bestMisalignment) {
+            best = {n, static_cast<int>(tileSize), misalignment <= MAX_MISALIGNMENT};
+            bestMisalignment = misalignment;
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+bool OneColorBackgroundView::paintPeriodic(cairo_t* cr, double minX, double minY, double maxX, double maxY,
+                                           double originX, double originY, double periodWidth, double periodHeight,
+                                           cairo_line_cap_t lineCap,
+                                           const std::function<void(cairo_t*)>& addPeriodPath) const {
+    cairo_surface_t* target = cairo_get_group_target(cr);
+    if (cairo_surface_get_type(target) != CAIRO_SURFACE_TYPE_IMAGE) {
+        return false;
+    }
+
+    double clipMinX;
+    double clipMinY;
+    double clipMaxX;
+    double clipMaxY;
+    cairo_clip_extents(cr, &clipMinX, &clipMinY, &clipMaxX, &clipMaxY);
+    minX = std::max(minX, clipMinX);
+    minY = std::max(minY, clipMinY);
+    maxX = std::min(maxX, clipMaxX);
+    maxY = std::min(maxY, clipMaxY);
+    if (minX >= maxX || minY >= maxY) {
+        // Nothing to paint
+        return true;
+    }
+
+    // Size of a period on the target, in pixels
+    cairo_matrix_t m;
+    cairo_get_matrix(cr, &m);
+    double deviceScaleX = 1.0;
+    double deviceScaleY = 1.0;
+    cairo_surface_get_device_scale(target, &deviceScaleX, &deviceScaleY);
+    double deviceOffsetX = 0.0;
+    double deviceOffsetY = 0.0;
+    cairo_surface_get_device_offset(target, &deviceOffsetX, &deviceOffsetY);
+    if (m.xy != 0.0 || m.yx != 0.0 || m.xx <= 0.0 || m.yy <= 0.0) {
+        return false;
+    }
+    const double scaleX = m.xx * deviceScaleX;
+    const double scaleY = m.yy * deviceScaleY;
+
+    const double distanceX = std::max(std::abs(minX - originX), std::abs(maxX - originX)) * scaleX;
+    const double distanceY = std::max(std::abs(minY - originY), std::abs(maxY - originY)) * scaleY;
+    const TileAxis axisX = chooseTileAxis(periodWidth * scaleX, distanceX);
+    const TileAxis axisY = chooseTileAxis(periodHeight * scaleY, distanceY);
+    if (axisX.periodCount == 0 || axisY.periodCount == 0) {
+        return false;
+    }
+    const int periodCountX = axisX.periodCount;
+    const int periodCountY = axisY.periodCount;
+    const int tileWidth = axisX.size;
+    const int tileHeight = axisY.size;
+    // Scale of the tile: its periods fill a whole number of pixels. The pattern matrix uses the same scale, so that the
+    // painted pattern keeps its exact period.
+    const double tileScaleX = tileWidth / (periodCountX * periodWidth);
+    const double tileScaleY = tileHeight / (periodCountY * periodHeight);
+
+    // The tile is drawn with the sub-pixel position of the origin on the target, so that it is painted pixel aligned
+    const double originPixelX = deviceScaleX * (m.xx * originX + m.x0) + deviceOffsetX;
+    const double originPixelY = deviceScaleY * (m.yy * originY + m.y0) + deviceOffsetY;
+    const double phaseX = originPixelX - std::floor(originPixelX);
+    const double phaseY = originPixelY - std::floor(originPixelY);
+
+    const TileKey key{typeid(*this), periodWidth, periodHeight,    periodCountX, periodCountY, lineWidth,
+                      uint32_t(foregroundColor), lineCap, tileWidth, tileHeight,   phaseX,       phaseY};
+
+    std::unique_lock<std::mutex> lock(tileMutex);
+    auto it = std::find_if(tiles.begin(), tiles.end(), [&key](const Tile& t) { return t.key == key; });
+    if (it != tiles.end()) {
+        tiles.splice(tiles.begin(), tiles, it);
+    } else {
+        cairo_surface_t* surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, key.tileWidth, key.tileHeight);
+        cairo_t* tileCr = cairo_create(surface);
+        cairo_translate(tileCr, phaseX, phaseY);
+        cairo_scale(tileCr, tileScaleX, tileScaleY);
+        // Add the neighbouring periods too, for the strokes crossing the border of the tile
+        for (int dy = -1; dy <= periodCountY; ++dy) {
+            for (int dx = -1; dx <= periodCountX; ++dx) {
+                cairo_save(tileCr);
+                cairo_translate(tileCr, dx * periodWidth, dy * periodHeight);
+                addPeriodPath(tileCr);
+                cairo_restore(tileCr);
+            }
+        }
+        Util::cairo_set_source_rgbi(tileCr, foregroundColor);
+        cairo_set_line_width(tileCr, lineWidth);
+        cairo_set_line_cap(tileCr, lineCap);
+        cairo_stroke(tileCr);
+        cairo_destroy(tileCr);
+
+        tiles.push_front({key, surface});
+        if (tiles.size() > MAX_CACHED_TILES) {
+            cairo_surface_destroy(tiles.back().surface);
+            tiles.pop_back();
+        }
+    }
+
+    cairo_surface_t* tile = cairo_surface_reference(tiles.front().surface);
+    lock.unlock();
+
+    cairo_pattern_t* pattern = cairo_pattern_create_for_surface(tile);
+    cairo_pattern_set_extend(pattern, CAIRO_EXTEND_REPEAT);
+    // No interpolation if the pixels of the tile fall on those of the target
+    cairo_pattern_set_filter(pattern, axisX.aligned && axisY.aligned ? CAIRO_FILTER_NEAREST : CAIRO_FILTER_BILINEAR);
+    cairo_matrix_t patternMatrix;
+    cairo_matrix_init_translate(&patternMatrix, phaseX, phaseY);
+    cairo_matrix_scale(&patternMatrix, tileScaleX, tileScaleY);
+    cairo_matrix_translate(&patternMatrix, -originX, -originY);
+    cairo_pattern_set_matrix(pattern, &patternMatrix);
+
+    cairo_save(cr);
+    cairo_rectangle(cr, minX, minY, maxX - minX, maxY - minY);
+    cairo_set_source(cr, pattern);
+    cairo_fill(cr);
+    cairo_restore(cr);
+    cairo_pattern_destroy(pattern);
+    cairo_surface_destroy(tile);
+
+    return true;
+}
@@ -11,6 +11,11 @@
 
 #pragma once
 
+#include <functional>
+#include <string>
+
+#include <cairo.h>
+
 #include "PlainBackgroundView.h"
 
 class BackgroundConfig;
@@ -30,6 +35,24 @@ protected:
      */
     static Color getColorOr(const BackgroundConfig& config, const std::string& str, const Color& defaultColor);
 
+    /**
+     * @brief Stroke, with the foreground color and line width, a pattern repeating with period
+     * (periodWidth, periodHeight) from (originX, originY), in the rectangle [minX, maxX] x [minY, maxY] (clipped to
+     * the mask of cr).
+     *
+     * A few periods are rendered at the resolution of the target into a cached tile, which is then painted as a
+     * repeating pattern: the cost does not depend on the density of the pattern. The tile spans a whole number of
+     * pixels: it is painted pixel by pixel if enough periods fit in it for its pixels to stay aligned with those of the
+     * target, and interpolated otherwise. This is only done on image surfaces, so that exports keep vector backgrounds.
+     *
+     * @param addPeriodPath Adds the path of one period, with origin (0, 0), to the given context. The strokes may
+     *        exceed the period by less than a period.
+     * @return false if nothing was painted: the caller must draw the pattern itself
+     */
+    bool paintPeriodic(cairo_t* cr, double minX, double minY, double maxX, double maxY, double originX, double originY,
+                       double periodWidth, double periodHeight, cairo_line_cap_t lineCap,
+                       const std::function<void(cairo_t*)>& addPeriodPath) const;
+
 protected:
     Color foregroundColor;
     double lineWidth;
@@ -26,10 +26,22 @@ void RuledBackgroundView::draw(cairo_t* cr) const {
     double maxY;
     cairo_clip_extents(cr, &minX, &minY, &maxX, &maxY);
 
+    // The lines are at HEADER_SIZE + i * lineSpacing, for 0 <= i <= lastLine
+    const double halfLineWidth = 0.5 * lineWidth;
+    const int lastLine = static_cast<int>(std::floor((pageHeight - HEADER_SIZE - FOOTER_SIZE) / lineSpacing));
+    if (paintPeriodic(cr, minX, HEADER_SIZE - halfLineWidth, maxX, HEADER_SIZE + lastLine * lineSpacing + halfLineWidth,
+                      0.0, HEADER_SIZE, lineSpacing, lineSpacing, CAIRO_LINE_CAP_BUTT,
+                      [s = this->lineSpacing](cairo_t* tileCr) {
+                          cairo_move_to(tileCr, 0.0, 0.0);
+                          cairo_line_to(tileCr, s, 0.0);
+                      })) {
+        return;
+    }
+
     //  Add a 0.5 * lineWidth padding in case the line is just outside the mask but its thickness still makes it
     //  (partially) visible
     auto [indexMinY, indexMaxY] =
-            getIndexBounds(minY - HEADER_SIZE - 0.5 * lineWidth, maxY - HEADER_SIZE + 0.5 * lineWidth, lineSpacing, 0.0,
+            getIndexBounds(minY - HEADER_SIZE - halfLineWidth, maxY - HEADER_SIZE + halfLineWidth, lineSpacing, 0.0,
                            pageHeight - HEADER_SIZE - FOOTER_SIZE);
 
     for (int i = indexMinY; i <= indexMaxY; ++i) {
@@ -41,3 +41,21 @@ void GzOutputStream::close() {
         this->fp = nullptr;
     }
 }
+
+////////////////////////////////////////////////////////
+/// ChecksumOutputStream ///////////////////////////////
+////////////////////////////////////////////////////////
+
+ChecksumOutputStream::ChecksumOutputStream(OutputStream* out): out(out), crc(crc32(0L, Z_NULL, 0)) {}
+
+void ChecksumOutputStream::write(const char* data, int len) {
+    this->crc = crc32(this->crc, reinterpret_cast<const Bytef*>(data), static_cast<uInt>(len));
+    this->length += static_cast<uint64_t>(len);
+    this->out->write(data, len);
+}
+
+void ChecksumOutputStream::close() { this->out->close(); }
+
+auto ChecksumOutputStream::getCrc() const -> uint32_t { return static_cast<uint32_t>(this->crc); }
+
+auto ChecksumOutputStream::getLength() const -> uint64_t { return this->length; }
@@ -1,25 +1,86 @@
 #include "util/XojPreviewExtractor.h"
 
-#include <array>
+#include <algorithm>
 #include <cstring>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <vector>
 
 #include <glib.h>
 #include <zip.h>
 #include <zlib.h>
 
-#include "util/GzUtil.h"
 #include "util/PathUtil.h"
 
 #include "filesystem.h"
 
-const char* TAG_PREVIEW_NAME = "preview";
-const int TAG_PREVIEW_NAME_LEN = strlen(TAG_PREVIEW_NAME);
-const char* TAG_PAGE_NAME = "page";
-const int TAG_PAGE_NAME_LEN = strlen(TAG_PAGE_NAME);
-const char* TAG_PREVIEW_END_NAME = "/preview";
-const int TAG_PREVIEW_END_NAME_LEN = strlen(TAG_PREVIEW_END_NAME);
+constexpr std::string_view TAG_PREVIEW_NAME = "preview";
+constexpr std::string_view TAG_PAGE_NAME = "page";
+constexpr std::string_view TAG_PREVIEW_END_NAME = "/preview";
 constexpr auto BUF_SIZE = 8192;
 
+/**
+ * The preview and the first page are at the beginning of the document: no more than this is inflated to find them
+ */
+constexpr size_t MAX_PREVIEW_SEARCH = 1 << 20;
+
+namespace {
+/**
+ * Finds the preview tag at the beginning of a document, which may be given piece by piece as it is inflated
+ */
+class PreviewScanner {
+public:
+    enum class Result { INCOMPLETE, PREVIEW, NO_PREVIEW, ERROR };
+
+    /**
+     * Resumes the search where the previous call stopped
+     * @param buffer The beginning of the document, which may only have grown since the previous call
+     */
+    auto scan(const char* buffer, size_t len) -> Result {
+        while (this->pos < len) {
+            // memchr is vectorized by the C library, so the base64 data of the preview is skipped quickly
+            const auto* open = static_cast<const char*>(std::memchr(buffer + this->pos, '<', len - this->pos));
+            if (!open) {
+                this->pos = len;
+                return Result::INCOMPLETE;
+            }
+            const auto tagStart = static_cast<size_t>(open - buffer) + 1;
+            const auto* close = static_cast<const char*>(std::memchr(buffer + tagStart, '>', len - tagStart));
+            if (!close) {
+                // The tag is completed by the next piece
+                this->pos = tagStart - 1;
+                return Result::INCOMPLETE;
+            }
+            const std::string_view tag(buffer + tagStart, static_cast<size_t>(close - buffer) - tagStart);
+            this->pos = static_cast<size_t>(close - buffer) + 1;
+
+            if (tag == TAG_PREVIEW_NAME) {
+                this->previewStart = this->pos;
+            } else if (tag == TAG_PREVIEW_END_NAME) {
+                if (!this->previewStart) {
+                    return Result::ERROR;
+                }
+                this->previewEnd = tagStart - 1;
+                return Result::PREVIEW;
+            } else if (tag.substr(0, TAG_PAGE_NAME.size()) == TAG_PAGE_NAME) {
+                return Result::NO_PREVIEW;
+            }
+        }
+        return Result::INCOMPLETE;
+    }
+
+    /**
+     * The base64 data of the preview, once found
+     */
+    std::optional<size_t> previewStart;
+    size_t previewEnd = 0;
+
+private:
+    size_t pos = 0;
+};
+}  // namespace
+
 XojPreviewExtractor::XojPreviewExtractor() = default;
 
 XojPreviewExtractor::~XojPreviewExtractor() {
@@ -42,52 +103,64 @@ auto XojPreviewExtractor::getData(gsize& dataLen) -> unsigned char* {
  * @param len Buffer len
  * @return If an image was read, or the error
  */
-auto XojPreviewExtractor::readPreview(char* buffer, int len) -> PreviewExtractResult {
-    bool inTag = false;
-    int startTag = 0;
-    int startPreview = -1;
-    int endPreview = -1;
-    int pageStart = -1;
-    for (int i = 0; i < len; i++) {
-        if (inTag) {
-            if (buffer[i] == '>') {
-                inTag = false;
-                int tagLen = i - startTag;
-                if (tagLen == TAG_PREVIEW_NAME_LEN &&
-                    strncmp(TAG_PREVIEW_NAME, buffer + startTag, TAG_PREVIEW_NAME_LEN) == 0) {
-                    startPreview = i + 1;
-                }
-                if (tagLen == TAG_PREVIEW_END_NAME_LEN &&
-                    strncmp(TAG_PREVIEW_END_NAME, buffer + startTag, TAG_PREVIEW_END_NAME_LEN) == 0) {
-                    endPreview = i - TAG_PREVIEW_END_NAME_LEN - 1;
-                    break;
-                }
-                if (tagLen >= TAG_PAGE_NAME_LEN && strncmp(TAG_PAGE_NAME, buffer + startTag, TAG_PAGE_NAME_LEN) == 0) {
-                    pageStart = i;
-                    break;
-                }
-            }
-            continue;
-        }
-
-        if (buffer[i] == '<') {
-            inTag = true;
-            startTag = i + 1;
-            continue;
-        }
+auto XojPreviewExtractor::readPreview(const char* buffer, size_t len) -> PreviewExtractResult {
+    PreviewScanner scanner;
+    switch (scanner.scan(buffer, len)) {
+        case PreviewScanner::Result::PREVIEW:
+            decodePreview(buffer + *scanner.previewStart, scanner.previewEnd - *scanner.previewStart);
+            return PREVIEW_RESULT_IMAGE_READ;
+        case PreviewScanner::Result::NO_PREVIEW:
+            return PREVIEW_RESULT_NO_PREVIEW;
+        default:
+            return PREVIEW_RESULT_ERROR_READING_PREVIEW;
     }
+}
 
-    if (startPreview != -1 && endPreview != -1) {
-        buffer[endPreview] = 0;
-        this->data = g_base64_decode(buffer + startPreview, &dataLen);
-        return PREVIEW_RESULT_IMAGE_READ;
-    }
+void XojPreviewExtractor::decodePreview(const char* base64, size_t len) {
+    g_free(this->data);
+    this->data = static_cast<unsigned char*>(g_malloc((len / 4) * 3 + 3));
+    gint state = 0;
+    guint save = 0;
+    this->dataLen = g_base64_decode_step(base64, len, this->data, &state, &save);
+}
 
-    if (pageStart != -1) {
-        return PREVIEW_RESULT_NO_PREVIEW;
+auto XojPreviewExtractor::readGzip(const char* buffer, size_t len) -> PreviewExtractResult {
+    z_stream stream{};
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(buffer));
+    stream.avail_in = static_cast<uInt>(std::min<size_t>(len, std::numeric_limits<uInt>::max()));
+    // Gzip header only
+    if (inflateInit2(&stream, 16 + MAX_WBITS) != Z_OK) {
+        return PREVIEW_RESULT_ERROR_READING_PREVIEW;
     }
 
-    return PREVIEW_RESULT_ERROR_READING_PREVIEW;
+    std::vector<char> xml;
+    PreviewScanner scanner;
+    auto result = PreviewScanner::Result::INCOMPLETE;
+    while (result == PreviewScanner::Result::INCOMPLETE && xml.size() < MAX_PREVIEW_SEARCH) {
+        const size_t inflated = xml.size();
+        xml.resize(inflated + BUF_SIZE);
+        stream.next_out = reinterpret_cast<Bytef*>(xml.data() + inflated);
+        stream.avail_out = BUF_SIZE;
+        int status = inflate(&stream, Z_NO_FLUSH);
+        xml.resize(inflated + BUF_SIZE - stream.avail_out);
+
+        result = scanner.scan(xml.data(), xml.size());
+        if (status != Z_OK) {
+            // End of the stream, or truncated / corrupted data
+            break;
+        }
+    }
+    inflateEnd(&stream);
+
+    switch (result) {
+        case PreviewScanner::Result::PREVIEW:
+            decodePreview(xml.data() + *scanner.previewStart, scanner.previewEnd - *scanner.previewStart);
+            return PREVIEW_RESULT_IMAGE_READ;
+        case PreviewScanner::Result::NO_PREVIEW:
+            return PREVIEW_RESULT_NO_PREVIEW;
+        default:
+            return PREVIEW_RESULT_ERROR_READING_PREVIEW;
+    }
 }
 
 /**
@@ -100,27 +173,36 @@ auto XojPreviewExtractor::readFile(const fs::path& file) -> PreviewExtractResult
     if (!Util::hasXournalFileExt(file)) {
         return PREVIEW_RESULT_BAD_FILE_EXTENSION;
     }
-    // read the new file format
-    int zipError = 0;
-    zip_t* zipFp = zip_open(file.u8string().c_str(), ZIP_RDONLY, &zipError);
 
-    if (!zipFp && zipError == ZIP_ER_NOZIP) {
-        gzFile fp = GzUtil::openPath(file, "r");
-        if (!fp) {
-            return PREVIEW_RESULT_COULD_NOT_OPEN_FILE;
-        }
-
-        // The <preview> Tag is within the first 179 Bytes
-        // The Preview should end within the first 8k
-
-        std::array<char, BUF_SIZE> buffer{};
-        int readLen = gzread(fp, buffer.data(), BUF_SIZE);
+    // The file is mapped rather than read: only the pages holding the beginning of the document are loaded
+    GError* error = nullptr;
+    GMappedFile* mapped = g_mapped_file_new(file.u8string().c_str(), false, &error);
+    if (!mapped) {
+        g_error_free(error);
+        return PREVIEW_RESULT_COULD_NOT_OPEN_FILE;
+    }
+    const char* contents = g_mapped_file_get_contents(mapped);
+    const size_t len = g_mapped_file_get_length(mapped);
+
+    PreviewExtractResult result = PREVIEW_RESULT_ERROR_READING_PREVIEW;
+    if (len >= 2 && contents[0] == 'P' && contents[1] == 'K') {
+        // read the new file format
+        result = readZip(file);
+    } else if (len >= 2 && static_cast<unsigned char>(contents[0]) == 0x1f &&
+               static_cast<unsigned char>(contents[1]) == 0x8b) {
+        result = readGzip(contents, len);
+    } else if (len > 0) {
+        // Uncompressed XML
+        result = readPreview(contents, std::min(len, MAX_PREVIEW_SEARCH));
+    }
 
-        PreviewExtractResult result = readPreview(buffer.data(), readLen);
+    g_mapped_file_unref(mapped);
+    return result;
+}
 
-        gzclose(fp);
-        return result;
-    }
+auto XojPreviewExtractor::readZip(const fs::path& file) -> PreviewExtractResult {
+    int zipError = 0;
+    zip_t* zipFp = zip_open(file.u8string().c_str(), ZIP_RDONLY, &zipError);
     if (!zipFp) {
         return PREVIEW_RESULT_COULD_NOT_OPEN_FILE;
     }
@@ -146,17 +228,20 @@ auto XojPreviewExtractor::readFile(const fs::path& file) -> PreviewExtractResult
         return PREVIEW_RESULT_ERROR_READING_PREVIEW;
     }
 
+    g_free(data);
     data = static_cast<unsigned char*>(g_malloc(thumbStat.size));
     zip_uint64_t readBytes = 0;
     while (readBytes < dataLen) {
-        zip_int64_t read = zip_fread(thumb, data, thumbStat.size);
-        if (read == -1) {
+        zip_int64_t read = zip_fread(thumb, data + readBytes, dataLen - readBytes);
+        if (read <= 0) {
             g_free(data);
+            data = nullptr;
+            dataLen = 0;
             zip_fclose(thumb);
             zip_close(zipFp);
             return PREVIEW_RESULT_ERROR_READING_PREVIEW;
         }
-        readBytes += read;
+        readBytes += static_cast<zip_uint64_t>(read);
     }
 
     zip_fclose(thumb);
@@ -11,6 +11,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -51,3 +52,25 @@ private:
     std::string target;
     fs::path file;
 };
+
+/**
+ * Forwards the data to another stream, computing the CRC-32 and the length of what was written
+ */
+class ChecksumOutputStream: public OutputStream {
+public:
+    explicit ChecksumOutputStream(OutputStream* out);
+
+public:
+    void write(const char* data, int len) override;
+
+    void close() override;
+
+    uint32_t getCrc() const;
+    uint64_t getLength() const;
+
+private:
+    OutputStream* out;
+
+    uLong crc;
+    uint64_t length = 0;
+};
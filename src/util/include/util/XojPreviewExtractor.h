@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string>
 
 #include <glib.h>
@@ -60,18 +61,34 @@ public:
     PreviewExtractResult readFile(const fs::path& file);
 
     /**
-     * Try to read the preview from byte buffer
+     * Try to read the preview from the beginning of an uncompressed document
      * @param buffer Buffer
      * @param len Buffer len
      * @return If an image was read, or the error
      */
-    PreviewExtractResult readPreview(char* buffer, int len);
+    PreviewExtractResult readPreview(const char* buffer, size_t len);
 
     /**
      * @return The preview data, should be a binary PNG
      */
     unsigned char* getData(gsize& dataLen);
 
+private:
+    /**
+     * Read the thumbnail entry of a zip container
+     */
+    PreviewExtractResult readZip(const fs::path& file);
+
+    /**
+     * Inflate the gzipped data only as far as needed to find the preview
+     */
+    PreviewExtractResult readGzip(const char* buffer, size_t len);
+
+    /**
+     * Decode the base64 content of the preview tag
+     */
+    void decodePreview(const char* base64, size_t len);
+
     // Member
 private:
     /**
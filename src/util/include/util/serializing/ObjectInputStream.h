@@ -11,7 +11,9 @@
 
 #pragma once
 
-#include <sstream>
+#include <cstring>
+#include <string>
+#include <vector>
 
 #include <gtk/gtk.h>
 
@@ -19,6 +21,9 @@
 
 class Serializable;
 
+/**
+ * Reads the streams written by ObjectOutputStream, binary or compressed, of both versions
+ */
 class ObjectInputStream {
 public:
     ObjectInputStream() = default;
@@ -37,18 +42,54 @@ public:
     size_t readSizeT();
     std::string readString();
 
+    /**
+     * Reads an array written by ObjectOutputStream::writeData(). The data is allocated with g_malloc().
+     */
     void readData(void** data, int* len);
 
+    /**
+     * Reads an array of T written by ObjectOutputStream::writeData(), directly into a vector
+     */
+    template <typename T>
+    std::vector<T> readData() {
+        size_t count = 0;
+        const char* bytes = readArray(sizeof(T), count);
+        std::vector<T> data(count);
+        if (count > 0) {
+            std::memcpy(data.data(), bytes, count * sizeof(T));
+        }
+        return data;
+    }
+
     /// Reads raw image data from the stream.
     std::string readImage();
 
 private:
     void checkType(char type);
 
+    /**
+     * @return The next len bytes of the stream, which are skipped
+     */
+    const char* take(size_t len);
+
+    template <typename T>
+    T readValue();
+
+    /**
+     * Reads the header of an array, whose elements must be of the given width
+     *
+     * @return The elements, count of them
+     */
+    const char* readArray(size_t width, size_t& count);
+
+    /**
+     * Replaces the compressed fields of the stream by the uncompressed ones
+     */
+    void decompress();
+
     static std::string getType(char type);
 
 private:
-    std::istringstream istream;
-    size_t pos();
-    size_t len = 0;
+    std::string data;
+    size_t position = 0;
 };
@@ -22,7 +22,22 @@ class Serializable;
 
 class ObjectOutputStream {
 public:
+    enum class Compression {
+        NONE,
+        FAST  ///< zlib at its fastest level. Worth it for redundant data only: coordinates barely compress.
+    };
+
+    /**
+     * Stream of the first version, written through the encoder, e.g. for streams read by older versions
+     */
     ObjectOutputStream(ObjectEncoding* encoder);
+
+    /**
+     * Binary stream, whose fields are appended to a single buffer. Uncompressed, it is identical to the binary encoded
+     * stream, so that older versions read it. The stream is compressed by getStr() if requested: it then has a version
+     * of its own, XML_FAST_VERSION_STR.
+     */
+    explicit ObjectOutputStream(Compression compression = Compression::NONE);
     virtual ~ObjectOutputStream();
 
 public:
@@ -40,8 +55,32 @@ public:
     /// Writes the raw image data to the output stream.
     void writeImage(const std::string_view& imgData);
 
+    /**
+     * Get the stream, once all is written. The caller owns the string.
+     */
     GString* getStr();
 
 private:
+    void addTag(char type);
+    void addData(const void* data, size_t len);
+    void writeString(const char* str, size_t len);
+
+    GString* compress();
+
+private:
+    /**
+     * Encoder of the first version, nullptr for the binary stream
+     */
     ObjectEncoding* encoder = nullptr;
+
+    /**
+     * Binary stream
+     */
+    GString* data = nullptr;
+    Compression compression = Compression::NONE;
+
+    /**
+     * Length of the version string, which is not compressed
+     */
+    size_t headerLength = 0;
 };
@@ -17,6 +17,7 @@ class ObjectInputStream;
 class ObjectOutputStream;
 
 extern const char* XML_VERSION_STR;
+extern const char* XML_FAST_VERSION_STR;
 
 class Serializable {
 public:
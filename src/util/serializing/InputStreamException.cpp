@@ -1,6 +1,7 @@
 #include "util/serializing/InputStreamException.h"
 
 const char* XML_VERSION_STR = "XojStrm1:";
+const char* XML_FAST_VERSION_STR = "XojStrm2:";
 
 InputStreamException::InputStreamException(const std::string& message, const std::string& filename, int line) {
     this->message = message + ", " + filename + ": " + std::to_string(line);
@@ -1,38 +1,32 @@
 #include "util/serializing/ObjectInputStream.h"
 
+#include <sstream>
+#include <utility>
+
+#include <zlib.h>
+
 #include "util/i18n.h"
 #include "util/pixbuf-utils.h"
 #include "util/serializing/Serializable.h"
 
-// This function requires that T is read from its binary representation to work (e.g. integer type)
-template <typename T>
-T readTypeFromSStream(std::istringstream& istream) {
-    if (istream.str().size() < sizeof(T)) {
-        std::ostringstream oss;
-        oss << "End reached: trying to read " << sizeof(T) << " bytes while only " << istream.str().size()
-            << " bytes available";
-        throw InputStreamException(oss.str(), __FILE__, __LINE__);
-    }
-    T output;
-
-    istream.read((char*)&output, sizeof(T));
-
-    return output;
-}
-
-size_t ObjectInputStream::pos() { return istream.tellg(); }
+/**
+ * Maximal compression ratio of zlib, to reject corrupt lengths before allocating
+ */
+constexpr size_t MAX_COMPRESSION_RATIO = 1032;
 
 auto ObjectInputStream::read(const char* data, int data_len) -> bool {
-    istream.clear();
-    len = (size_t)data_len;
-    std::string dataStr = std::string(data, len);
-    istream.str(dataStr);
+    this->data.assign(data, static_cast<size_t>(data_len));
+    this->position = 0;
 
     try {
         std::string version = readString();
-        if (version != XML_VERSION_STR) {
-            g_warning("ObjectInputStream version mismatch... two different Xournal versions running? (%s / %s)",
-                      version.c_str(), XML_VERSION_STR);
+        if (version == XML_FAST_VERSION_STR) {
+            if (this->data.compare(this->position, 2, "_z") == 0) {
+                decompress();
+            }
+        } else if (version != XML_VERSION_STR) {
+            g_warning("ObjectInputStream version mismatch... two different Xournal versions running? (%s / %s or %s)",
+                      version.c_str(), XML_VERSION_STR, XML_FAST_VERSION_STR);
             return false;
         }
     } catch (InputStreamException& e) {
@@ -42,6 +36,47 @@ auto ObjectInputStream::read(const char* data, int data_len) -> bool {
     return true;
 }
 
+auto ObjectInputStream::take(size_t len) -> const char* {
+    size_t available = this->data.size() - this->position;
+    if (available < len) {
+        std::ostringstream oss;
+        oss << "End reached: trying to read " << len << " bytes while only " << available << " bytes available";
+        throw InputStreamException(oss.str(), __FILE__, __LINE__);
+    }
+    const char* bytes = this->data.data() + this->position;
+    this->position += len;
+    return bytes;
+}
+
+// This function requires that T is read from its binary representation to work (e.g. integer type)
+template <typename T>
+auto ObjectInputStream::readValue() -> T {
+    T output;
+    std::memcpy(&output, take(sizeof(T)), sizeof(T));
+    return output;
+}
+
+void ObjectInputStream::decompress() {
+    take(2);
+    auto length = readValue<size_t>();
+    size_t compressedLength = this->data.size() - this->position;
+    if (length / MAX_COMPRESSION_RATIO > compressedLength) {
+        throw InputStreamException("Invalid length of the compressed stream", __FILE__, __LINE__);
+    }
+
+    std::string fields(length, '\0');
+    uLongf fieldsLength = static_cast<uLongf>(length);
+    if (uncompress(reinterpret_cast<Bytef*>(fields.data()), &fieldsLength,
+                   reinterpret_cast<const Bytef*>(this->data.data() + this->position),
+                   static_cast<uLong>(compressedLength)) != Z_OK ||
+        fieldsLength != length) {
+        throw InputStreamException("Could not uncompress the stream", __FILE__, __LINE__);
+    }
+
+    this->data = std::move(fields);
+    this->position = 0;
+}
+
 void ObjectInputStream::readObject(const char* name) {
     std::string type = readObject();
     if (type != name) {
@@ -56,12 +91,12 @@ auto ObjectInputStream::readObject() -> std::string {
 }
 
 auto ObjectInputStream::getNextObjectName() -> std::string {
-    auto position = istream.tellg();
+    size_t position = this->position;
 
     checkType('{');
     std::string name = readString();
 
-    istream.seekg(position);
+    this->position = position;
     return name;
 }
 
@@ -69,91 +104,86 @@ void ObjectInputStream::endObject() { checkType('}'); }
 
 auto ObjectInputStream::readInt() -> int {
     checkType('i');
-    return readTypeFromSStream<int>(istream);
+    return readValue<int>();
 }
 
 auto ObjectInputStream::readDouble() -> double {
     checkType('d');
-    return readTypeFromSStream<double>(istream);
+    return readValue<double>();
 }
 
 auto ObjectInputStream::readSizeT() -> size_t {
     checkType('l');
-    return readTypeFromSStream<size_t>(istream);
+    return readValue<size_t>();
 }
 
 auto ObjectInputStream::readString() -> std::string {
     checkType('s');
 
-    size_t lenString = (size_t)readTypeFromSStream<int>(istream);
-
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an string", __FILE__, __LINE__);
+    int lenString = readValue<int>();
+    if (lenString < 0) {
+        throw InputStreamException("Negative length of a string", __FILE__, __LINE__);
     }
 
-    std::string output;
-    output.resize(lenString);
-
-    istream.read(&output[0], (long)lenString);
-
-    return output;
+    return std::string(take(static_cast<size_t>(lenString)), static_cast<size_t>(lenString));
 }
 
-void ObjectInputStream::readData(void** data, int* length) {
+auto ObjectInputStream::readArray(size_t width, size_t& count) -> const char* {
     checkType('b');
 
-    if (istream.str().size() < 2 * sizeof(int)) {
-        throw InputStreamException("End reached, but try to read data len and width", __FILE__, __LINE__);
+    int len = readValue<int>();
+    int dataWidth = readValue<int>();
+    if (len < 0 || static_cast<size_t>(dataWidth) != width) {
+        throw InputStreamException(FS(FORMAT_STR("Expected data of width {1}, but read {2} elements of width {3}") %
+                                      static_cast<uint32_t>(width) % len % dataWidth),
+                                   __FILE__, __LINE__);
     }
 
-    int len = readTypeFromSStream<int>(istream);
-    int width = readTypeFromSStream<int>(istream);
+    count = static_cast<size_t>(len);
+    return take(count * width);
+}
+
+void ObjectInputStream::readData(void** data, int* length) {
+    checkType('b');
 
-    if (istream.str().size() < (len * width)) {
-        throw InputStreamException("End reached, but try to read data", __FILE__, __LINE__);
+    int len = readValue<int>();
+    int width = readValue<int>();
+    if (len < 0 || width < 0) {
+        throw InputStreamException("Negative length or width of data", __FILE__, __LINE__);
     }
 
+    const char* bytes = take(static_cast<size_t>(len) * static_cast<size_t>(width));
     if (len == 0) {
         *length = 0;
         *data = nullptr;
     } else {
-        *data = (void*)new char[(size_t)(len * width)];
+        *data = g_malloc(static_cast<gsize>(len) * static_cast<gsize>(width));
+        std::memcpy(*data, bytes, static_cast<size_t>(len) * static_cast<size_t>(width));
         *length = len;
-
-        istream.read((char*)*data, len * width);
     }
 }
 
 auto ObjectInputStream::readImage() -> std::string {
     checkType('m');
 
-    if (istream.str().size() < sizeof(size_t)) {
-        throw InputStreamException("End reached, but try to read an image's data's length", __FILE__, __LINE__);
-    }
-
-    const size_t len = readTypeFromSStream<size_t>(istream);
-    if (istream.str().size() < len) {
-        throw InputStreamException("End reached, but try to read an image", __FILE__, __LINE__);
-    }
-    std::string data;
-    data.resize(len);
-    istream.read(data.data(), static_cast<int>(len));
-
-    return data;
+    const auto len = readValue<size_t>();
+    return std::string(take(len), len);
 }
 
 void ObjectInputStream::checkType(char type) {
-    if (istream.str().size() < 2) {
+    if (this->data.size() - this->position < 2) {
         throw InputStreamException(FS(FORMAT_STR("End reached, but try to read {1}, index {2} of {3}") % getType(type) %
-                                      (uint32_t)pos() % (uint32_t)len),
+                                      static_cast<uint32_t>(this->position) % static_cast<uint32_t>(this->data.size())),
                                    __FILE__, __LINE__);
     }
-    char t = 0, underscore = 0;
-    istream >> underscore >> t;
+    char underscore = this->data[this->position];
+    char t = this->data[this->position + 1];
+    this->position += 2;
 
     if (underscore != '_') {
         throw InputStreamException(FS(FORMAT_STR("Expected type signature of {1}, index {2} of {3}, but read '{4}'") %
-                                      getType(type) % ((uint32_t)pos() + 1) % (uint32_t)len % underscore),
+                                      getType(type) % static_cast<uint32_t>(this->position - 1) %
+                                      static_cast<uint32_t>(this->data.size()) % underscore),
                                    __FILE__, __LINE__);
     }
 
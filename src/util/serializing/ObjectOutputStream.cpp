@@ -1,8 +1,17 @@
 #include "util/serializing/ObjectOutputStream.h"
 
+#include <cstring>
+
+#include <zlib.h>
+
 #include "util/serializing/ObjectEncoding.h"
 #include "util/serializing/Serializable.h"
 
+/**
+ * Initial size of the buffer of a binary stream
+ */
+constexpr gsize INITIAL_BUFFER_SIZE = 4096;
+
 ObjectOutputStream::ObjectOutputStream(ObjectEncoding* encoder) {
     g_assert(encoder != nullptr);
     this->encoder = encoder;
@@ -10,51 +19,85 @@ ObjectOutputStream::ObjectOutputStream(ObjectEncoding* encoder) {
     writeString(XML_VERSION_STR);
 }
 
+ObjectOutputStream::ObjectOutputStream(Compression compression): compression(compression) {
+    this->data = g_string_sized_new(INITIAL_BUFFER_SIZE);
+
+    writeString(XML_VERSION_STR);
+    this->headerLength = this->data->len;
+}
+
 ObjectOutputStream::~ObjectOutputStream() {
     delete this->encoder;
     this->encoder = nullptr;
+
+    if (this->data) {
+        g_string_free(this->data, true);
+        this->data = nullptr;
+    }
+}
+
+/**
+ * The type tags are not encoded, only the values
+ */
+inline void ObjectOutputStream::addTag(char type) {
+    const char tag[] = {'_', type, '\0'};
+    if (this->encoder) {
+        this->encoder->addStr(tag);
+    } else {
+        g_string_append_len(this->data, tag, 2);
+    }
+}
+
+inline void ObjectOutputStream::addData(const void* data, size_t len) {
+    if (this->encoder) {
+        this->encoder->addData(data, static_cast<int>(len));
+    } else {
+        g_string_append_len(this->data, static_cast<const char*>(data), static_cast<gssize>(len));
+    }
 }
 
 void ObjectOutputStream::writeObject(const char* name) {
-    this->encoder->addStr("_{");
+    addTag('{');
 
     writeString(name);
 }
 
-void ObjectOutputStream::endObject() { this->encoder->addStr("_}"); }
+void ObjectOutputStream::endObject() { addTag('}'); }
 
 void ObjectOutputStream::writeInt(int i) {
-    this->encoder->addStr("_i");
-    this->encoder->addData(&i, sizeof(int));
+    addTag('i');
+    addData(&i, sizeof(int));
 }
 
 void ObjectOutputStream::writeDouble(double d) {
-    this->encoder->addStr("_d");
-    this->encoder->addData(&d, sizeof(double));
+    addTag('d');
+    addData(&d, sizeof(double));
 }
 
 void ObjectOutputStream::writeSizeT(size_t st) {
-    this->encoder->addStr("_l");
-    this->encoder->addData(&st, sizeof(size_t));
+    addTag('l');
+    addData(&st, sizeof(size_t));
 }
 
-void ObjectOutputStream::writeString(const char* str) { writeString(std::string(str)); }
+void ObjectOutputStream::writeString(const char* str) { writeString(str, strlen(str)); }
+
+void ObjectOutputStream::writeString(const std::string& s) { writeString(s.c_str(), s.length()); }
 
-void ObjectOutputStream::writeString(const std::string& s) {
-    this->encoder->addStr("_s");
-    int len = s.length();
-    this->encoder->addData(&len, sizeof(int));
-    this->encoder->addData(s.c_str(), len);
+void ObjectOutputStream::writeString(const char* str, size_t len) {
+    addTag('s');
+    int length = static_cast<int>(len);
+    addData(&length, sizeof(int));
+    addData(str, len);
 }
 
 void ObjectOutputStream::writeData(const void* data, int len, int width) {
-    this->encoder->addStr("_b");
-    this->encoder->addData(&len, sizeof(int));
+    addTag('b');
+    addData(&len, sizeof(int));
 
     // size of one element
-    this->encoder->addData(&width, sizeof(int));
+    addData(&width, sizeof(int));
     if (data != nullptr) {
-        this->encoder->addData(data, len * width);
+        addData(data, static_cast<size_t>(len) * static_cast<size_t>(width));
     }
 }
 
@@ -64,10 +107,58 @@ static auto cairoWriteFunction(GString* string, const unsigned char* data, unsig
 }
 
 void ObjectOutputStream::writeImage(const std::string_view& imgData) {
-    this->encoder->addStr("_m");
+    addTag('m');
     size_t len = imgData.length();
-    this->encoder->addData(&len, sizeof(size_t));
-    this->encoder->addData(imgData.data(), static_cast<int>(len));
+    addData(&len, sizeof(size_t));
+    addData(imgData.data(), len);
+}
+
+auto ObjectOutputStream::getStr() -> GString* {
+    if (this->encoder) {
+        return this->encoder->getData();
+    }
+
+    if (this->compression == Compression::FAST) {
+        return compress();
+    }
+
+    GString* str = this->data;
+    this->data = nullptr;
+    return str;
 }
 
-auto ObjectOutputStream::getStr() -> GString* { return this->encoder->getData(); }
+/**
+ * The version string XML_FAST_VERSION_STR is followed by a "_z" tag, the length of the uncompressed fields and the
+ * compressed fields. Older versions reject the stream by its version.
+ */
+auto ObjectOutputStream::compress() -> GString* {
+    const char* fields = this->data->str + this->headerLength;
+    size_t fieldsLength = this->data->len - this->headerLength;
+    uLong bound = compressBound(static_cast<uLong>(fieldsLength));
+
+    const int versionLength = static_cast<int>(strlen(XML_FAST_VERSION_STR));
+    GString* str = g_string_sized_new(2 + sizeof(int) + versionLength + 2 + sizeof(size_t) + bound);
+    g_string_append_len(str, "_s", 2);
+    g_string_append_len(str, reinterpret_cast<const char*>(&versionLength), sizeof(int));
+    g_string_append_len(str, XML_FAST_VERSION_STR, versionLength);
+    g_string_append_len(str, "_z", 2);
+    g_string_append_len(str, reinterpret_cast<const char*>(&fieldsLength), sizeof(size_t));
+
+    size_t offset = str->len;
+    g_string_set_size(str, offset + bound);
+    uLongf compressedLength = bound;
+    if (compress2(reinterpret_cast<Bytef*>(str->str + offset), &compressedLength,
+                  reinterpret_cast<const Bytef*>(fields), static_cast<uLong>(fieldsLength), Z_BEST_SPEED) != Z_OK) {
+        // Cannot happen with a buffer of compressBound() bytes, but the uncompressed stream is valid as well
+        g_warning("ObjectOutputStream: could not compress the stream, it is stored uncompressed");
+        g_string_free(str, true);
+        str = this->data;
+        this->data = nullptr;
+        return str;
+    }
+    g_string_set_size(str, offset + compressedLength);
+
+    g_string_free(this->data, true);
+    this->data = nullptr;
+    return str;
+}
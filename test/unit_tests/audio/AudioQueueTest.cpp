@@ -0,0 +1,121 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iterator>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "audio/AudioQueue.h"
+
+TEST(AudioQueue, testFifoOrder) {
+    AudioQueue<float> queue(16);
+    queue.setAudioAttributes(44100, 2);
+    EXPECT_EQ(queue.capacity(), 16);
+
+    std::vector<float> in = {1, 2, 3, 4, 5, 6};
+    queue.emplace(in.begin(), in.end());
+    EXPECT_EQ(queue.size(), 6);
+
+    std::vector<float> out;
+    queue.pop(std::back_inserter(out), 2);
+    EXPECT_EQ(out, std::vector<float>({1, 2}));
+    queue.pop(std::back_inserter(out), 10);
+    EXPECT_EQ(out, in);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(queue.getUnderrunCount(), 1);
+    EXPECT_EQ(queue.getOverrunCount(), 0);
+}
+
+TEST(AudioQueue, testOverrunAndWrapAround) {
+    AudioQueue<float> queue(8);
+    queue.setAudioAttributes(44100, 2);
+
+    std::vector<float> in = {1, 2, 3, 4, 5, 6};
+    queue.emplace(in.begin(), in.end());
+    queue.emplace(in.begin(), in.end());
+    // Only one frame was left
+    EXPECT_EQ(queue.getOverrunCount(), 1);
+    EXPECT_EQ(queue.size(), 8);
+
+    std::vector<float> out(6);
+    queue.pop(out.begin(), 6);
+    EXPECT_EQ(out, in);
+
+    queue.emplace(in.begin(), in.end());
+    out.clear();
+    queue.pop(std::back_inserter(out), 8);
+    EXPECT_EQ(out, std::vector<float>({1, 2, 1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(queue.getOverrunCount(), 1);
+
+    queue.signalEndOfStream();
+    out.clear();
+    queue.pop(std::back_inserter(out), 8);
+    // No underrun is counted after the end of the stream
+    EXPECT_EQ(queue.getUnderrunCount(), 0);
+}
+
+/**
+ * A real-time producer (never waiting) and a slow consumer, sometimes stalling: every sample is either received in
+ * order or counted as dropped.
+ */
+TEST(AudioQueue, testSlowConsumerStress) {
+    constexpr size_t CHUNK = 128;
+    constexpr size_t CHUNKS = 20000;
+    AudioQueue<float> queue(4096);
+    queue.setAudioAttributes(48000, 2);
+
+    std::atomic<size_t> dropped{0};
+    std::thread producer([&] {
+        std::vector<float> chunk(CHUNK);
+        float next = 0;
+        for (size_t i = 0; i < CHUNKS; ++i) {
+            for (auto& v: chunk) { v = next++; }
+            size_t before = queue.size();
+            size_t overrunsBefore = queue.getOverrunCount();
+            queue.emplace(chunk.begin(), chunk.end());
+            if (queue.getOverrunCount() != overrunsBefore) {
+                // The consumer may only have made room meanwhile, so this is a lower bound of the stored samples
+                dropped += CHUNK - std::min(CHUNK, queue.capacity() - before);
+            }
+            if (i % 64 == 0) {
+                std::this_thread::yield();
+            }
+        }
+        queue.signalEndOfStream();
+    });
+
+    std::vector<float> received;
+    received.reserve(CHUNK * CHUNKS);
+    {
+        auto lock = queue.acquire_lock();
+        size_t rounds = 0;
+        while (!(queue.hasStreamEnded() && queue.empty())) {
+            queue.waitForProducer(lock);
+            queue.pop(std::back_inserter(received), 256);
+            if (++rounds % 50 == 0) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+    producer.join();
+
+    // In order, without duplicates
+    for (size_t i = 1; i < received.size(); ++i) { ASSERT_LT(received[i - 1], received[i]); }
+    EXPECT_LE(received.size() + dropped, CHUNK * CHUNKS);
+    EXPECT_EQ(received.size() % 2, 0);
+    if (received.size() < CHUNK * CHUNKS) {
+        EXPECT_GT(queue.getOverrunCount(), 0);
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "control/shaperecognizer/Inertia.h"
+#include "control/shaperecognizer/InertiaPrefixSums.h"
+#include "model/Point.h"
+
+/**
+ * A spiral far from the origin, whose segments are in every direction
+ */
+static auto spiral(size_t n) -> std::vector<Point> {
+    std::vector<Point> points;
+    for (size_t i = 0; i < n; i++) {
+        double t = 0.05 * static_cast<double>(i);
+        points.emplace_back(500 + t * std::cos(t), 300 + t * std::sin(t));
+    }
+    return points;
+}
+
+static void expectSameMoments(const Inertia& expected, const Inertia& actual) {
+    EXPECT_NEAR(expected.getMass(), actual.getMass(), 1e-9 * (1 + expected.getMass()));
+    if (expected.getMass() > 0) {
+        EXPECT_NEAR(expected.centerX(), actual.centerX(), 1e-6);
+        EXPECT_NEAR(expected.centerY(), actual.centerY(), 1e-6);
+        EXPECT_NEAR(expected.xx(), actual.xx(), 1e-6);
+        EXPECT_NEAR(expected.xy(), actual.xy(), 1e-6);
+        EXPECT_NEAR(expected.yy(), actual.yy(), 1e-6);
+    }
+}
+
+TEST(InertiaPrefixSums, testRanges) {
+    auto points = spiral(300);
+    InertiaPrefixSums sums(points);
+    ASSERT_EQ(sums.size(), points.size());
+
+    const int n = static_cast<int>(points.size());
+    for (int start = 0; start < n; start += 13) {
+        for (int end = start; end <= n; end += 7) {
+            Inertia expected;
+            expected.calc(points.data(), start, end);
+            expectSameMoments(expected, sums.calc(start, end));
+        }
+    }
+}
+
+TEST(InertiaPrefixSums, testUpdate) {
+    auto points = spiral(200);
+    std::vector<Point> stroke(points.begin(), points.begin() + 50);
+    InertiaPrefixSums sums(stroke);
+
+    // Points appended as the stroke grows
+    stroke.insert(stroke.end(), points.begin() + 50, points.end());
+    sums.update(stroke);
+    ASSERT_EQ(sums.size(), stroke.size());
+    Inertia expected;
+    expected.calc(stroke.data(), 0, static_cast<int>(stroke.size()));
+    expectSameMoments(expected, sums.calc(0, static_cast<int>(stroke.size())));
+
+    // Fewer points: rebuilt
+    std::vector<Point> shorter(points.begin() + 100, points.begin() + 120);
+    sums.update(shorter);
+    ASSERT_EQ(sums.size(), shorter.size());
+    expected.calc(shorter.data(), 0, static_cast<int>(shorter.size()));
+    expectSameMoments(expected, sums.calc(0, static_cast<int>(shorter.size())));
+}
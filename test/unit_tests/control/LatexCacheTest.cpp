@@ -0,0 +1,79 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <fstream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "control/latex/LatexCache.h"
+
+#include "filesystem.h"
+
+static fs::path writeFile(const fs::path& path, size_t size) {
+    std::ofstream out(path, std::ios::binary);
+    out << std::string(size, 'x');
+    return path;
+}
+
+class LatexCacheTest: public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = fs::temp_directory_path() / "xournalpp-latex-cache-test";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+    }
+
+    void TearDown() override { fs::remove_all(dir); }
+
+    fs::path dir;
+};
+
+TEST_F(LatexCacheTest, testKey) {
+    auto key = LatexCache::computeKey("\\alpha", "pdflatex '{}'");
+    EXPECT_EQ(key, LatexCache::computeKey("\\alpha", "pdflatex '{}'"));
+    EXPECT_NE(key, LatexCache::computeKey("\\beta", "pdflatex '{}'"));
+    EXPECT_NE(key, LatexCache::computeKey("\\alpha", "lualatex '{}'"));
+    EXPECT_NE(LatexCache::computeKey("ab", "c"), LatexCache::computeKey("a", "bc"));
+}
+
+TEST_F(LatexCacheTest, testStoreAndLookup) {
+    LatexCache cache(dir / "cache");
+    auto before = LatexCache::getStatistics();
+
+    auto key = LatexCache::computeKey("\\alpha", "pdflatex");
+    EXPECT_FALSE(cache.lookup(key));
+    cache.store(key, writeFile(dir / "tex.pdf", 100));
+    auto path = cache.lookup(key);
+    ASSERT_TRUE(path);
+    EXPECT_EQ(fs::file_size(*path), 100);
+
+    auto after = LatexCache::getStatistics();
+    EXPECT_EQ(after.hits - before.hits, 1);
+    EXPECT_EQ(after.misses - before.misses, 1);
+}
+
+TEST_F(LatexCacheTest, testEviction) {
+    LatexCache cache(dir / "cache", 250);
+
+    cache.store("a", writeFile(dir / "a.pdf", 100));
+    cache.store("b", writeFile(dir / "b.pdf", 100));
+    // Make "b" the oldest entry, then use "a"
+    fs::last_write_time(dir / "cache" / "b.pdf", fs::file_time_type::clock::now() - std::chrono::hours(1));
+    fs::last_write_time(dir / "cache" / "a.pdf", fs::file_time_type::clock::now() - std::chrono::minutes(1));
+    EXPECT_TRUE(cache.lookup("a"));
+
+    cache.store("c", writeFile(dir / "c.pdf", 100));
+    EXPECT_TRUE(cache.lookup("a"));
+    EXPECT_FALSE(cache.lookup("b"));
+    EXPECT_TRUE(cache.lookup("c"));
+}
@@ -9,15 +9,23 @@
  * @license GNU GPLv2 or later
  */
 
+#include <chrono>
 #include <cmath>
 #include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #include <config-test.h>
 #include <gtest/gtest.h>
+#include <zlib.h>
 
 #include "control/xojfile/LoadHandler.h"
 #include "control/xojfile/SaveHandler.h"
+#include "control/xojfile/StrokeGeometryChunk.h"
+#include "util/GzUtil.h"
 #include "util/PathUtil.h"
 
 #include "filesystem.h"
@@ -425,3 +433,170 @@ TEST(ControlLoadHandler, testLoadStoreLoadGerman) {
     setlocale(LC_ALL, "C");
 }
 #endif
+
+static void expectSameStrokes(Document* a, Document* b) {
+    ASSERT_EQ(a->getPageCount(), b->getPageCount());
+    for (size_t i = 0; i < a->getPageCount(); i++) {
+        auto& layersA = *a->getPage(i)->getLayers();
+        auto& layersB = *b->getPage(i)->getLayers();
+        ASSERT_EQ(layersA.size(), layersB.size());
+        for (size_t l = 0; l < layersA.size(); l++) {
+            auto& elementsA = layersA[l]->getElements();
+            auto& elementsB = layersB[l]->getElements();
+            ASSERT_EQ(elementsA.size(), elementsB.size());
+            for (size_t e = 0; e < elementsA.size(); e++) {
+                ASSERT_EQ(elementsA[e]->getType(), elementsB[e]->getType());
+                if (elementsA[e]->getType() != ELEMENT_STROKE) {
+                    continue;
+                }
+                auto* sA = dynamic_cast<Stroke*>(elementsA[e]);
+                auto* sB = dynamic_cast<Stroke*>(elementsB[e]);
+                EXPECT_EQ(sA->getWidth(), sB->getWidth());
+                ASSERT_EQ(sA->getPointCount(), sB->getPointCount());
+                for (int j = 0; j < sA->getPointCount(); j++) {
+                    EXPECT_NEAR(sA->getPoint(j).x, sB->getPoint(j).x, 1e-12);
+                    EXPECT_NEAR(sA->getPoint(j).y, sB->getPoint(j).y, 1e-12);
+                    EXPECT_NEAR(sA->getPoint(j).z, sB->getPoint(j).z, 1e-12);
+                }
+            }
+        }
+    }
+}
+
+static void saveDocument(Document* doc, const fs::path& path, bool strokeGeometry) {
+    SaveHandler h;
+    h.setWriteStrokeGeometry(strokeGeometry);
+    h.prepareSave(doc);
+    h.saveTo(path);
+    EXPECT_EQ(h.getErrorMessage(), "");
+}
+
+/**
+ * @return The CRC-32 and the length (modulo 2^32) of the content of a gzip file, from its trailer
+ */
+static auto readGzipTrailer(const fs::path& path) -> std::pair<uint32_t, uint32_t> {
+    std::ifstream file(path, std::ios_base::binary);
+    file.seekg(-8, std::ios_base::end);
+    unsigned char trailer[8] = {};
+    file.read(reinterpret_cast<char*>(trailer), 8);
+    auto u32 = [&](int i) {
+        return static_cast<uint32_t>(trailer[i] | trailer[i + 1] << 8 | trailer[i + 2] << 16 |
+                                     static_cast<uint32_t>(trailer[i + 3]) << 24);
+    };
+    return {u32(0), u32(4)};
+}
+
+TEST(ControlLoadHandler, testStrokeGeometryChunk) {
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(GET_TESTFILE("packaged_xopp/suite.xopp"));
+    ASSERT_TRUE(doc);
+
+    auto path = Util::getTmpDirSubfolder() / "geometry.xopp";
+    saveDocument(doc, path, true);
+
+    auto chunk = StrokeGeometryChunk::readFromCache(path);
+    ASSERT_TRUE(chunk);
+    EXPECT_GT(chunk->getStrokeCount(), 0U);
+
+    // The document itself is a plain gzip stream: it ends with the length of the content
+    gzFile fp = GzUtil::openPath(path, "r");
+    ASSERT_TRUE(fp);
+    std::vector<char> buffer(1 << 16);
+    uint32_t contentLength = 0;
+    int len = 0;
+    while ((len = gzread(fp, buffer.data(), static_cast<unsigned>(buffer.size()))) > 0) {
+        contentLength += static_cast<uint32_t>(len);
+    }
+    gzclose(fp);
+    EXPECT_EQ(contentLength, readGzipTrailer(path).second);
+
+    LoadHandler handlerChunk;
+    Document* docChunk = handlerChunk.loadDocument(path);
+    ASSERT_TRUE(docChunk);
+    expectSameStrokes(doc, docChunk);
+}
+
+TEST(ControlLoadHandler, testStrokeGeometryChunkMismatch) {
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(GET_TESTFILE("packaged_xopp/suite.xopp"));
+    ASSERT_TRUE(doc);
+
+    // A chunk written for some other content under the same name must be ignored: only the low 32 bits of the length
+    // are in the name
+    auto path = Util::getTmpDirSubfolder() / "geometry_mismatch.xopp";
+    saveDocument(doc, path, false);
+    auto [crc, length] = readGzipTrailer(path);
+    ASSERT_TRUE(StrokeGeometryChunk().writeToCache(crc, length + (uint64_t{1} << 32)));
+    ASSERT_TRUE(StrokeGeometryChunk::readFromCache(path));
+
+    LoadHandler handler2;
+    Document* doc2 = handler2.loadDocument(path);
+    ASSERT_TRUE(doc2) << handler2.getLastError();
+    expectSameStrokes(doc, doc2);
+}
+
+TEST(ControlLoadHandler, testStrokeGeometryChunkCache) {
+    auto dir = Util::getTmpDirSubfolder() / "geometry_cache";
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(GET_TESTFILE("packaged_xopp/suite.xopp"));
+    ASSERT_TRUE(doc);
+    auto path = Util::getTmpDirSubfolder() / "geometry_cache.xopp";
+    saveDocument(doc, path, false);
+    auto [crc, length] = readGzipTrailer(path);
+    EXPECT_FALSE(StrokeGeometryChunk::readFromCache(path, dir));
+    ASSERT_TRUE(StrokeGeometryChunk().writeToCache(crc, length, dir));
+
+    // The chunk follows the content, whatever the name of the document (backups, autosaves)
+    auto renamed = fs::path{path} += "~";
+    fs::rename(path, renamed);
+    EXPECT_TRUE(StrokeGeometryChunk::readFromCache(renamed, dir));
+
+    // Only the most recently used chunks are kept
+    for (uint32_t i = 0; i < StrokeGeometryChunk::MAX_CACHED_CHUNKS + 4; i++) {
+        ASSERT_TRUE(StrokeGeometryChunk().writeToCache(i, 0, dir));
+    }
+    EXPECT_EQ(std::distance(fs::directory_iterator(dir), fs::directory_iterator()),
+              StrokeGeometryChunk::MAX_CACHED_CHUNKS);
+
+    fs::remove(renamed);
+    fs::remove_all(dir);
+}
+
+#ifdef TEST_CHECK_SPEED
+TEST(ControlLoadHandler, benchmarkStrokeGeometryChunk) {
+    LoadHandler handler;
+    Document* doc = handler.loadDocument(GET_TESTFILE("packaged_xopp/suite.xopp"));
+    ASSERT_TRUE(doc);
+
+    Layer* layer = (*doc->getPage(0)->getLayers())[0];
+    for (int s = 0; s < 5000; s++) {
+        auto* stroke = new Stroke();
+        stroke->setWidth(1.4);
+        for (int i = 0; i < 200; i++) {
+            stroke->addPoint(Point(100 + s * 0.01 + std::cos(i * 0.1) * 50, 200 + std::sin(i * 0.1) * 50, 1 + i * 0.001));
+        }
+        layer->addElement(stroke);
+    }
+
+    auto withChunk = Util::getTmpDirSubfolder() / "geometry_bench.xopp";
+    auto withoutChunk = Util::getTmpDirSubfolder() / "no_geometry_bench.xopp";
+    saveDocument(doc, withoutChunk, false);
+
+    auto timeLoad = [](const fs::path& path) {
+        auto start = std::chrono::steady_clock::now();
+        LoadHandler h;
+        EXPECT_TRUE(h.loadDocument(path));
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    // Both documents have the same content, hence the same cached chunk: load the one without it first
+    fs::remove(StrokeGeometryChunk::getCachePath(withoutChunk));
+    double xmlTime = timeLoad(withoutChunk);
+    saveDocument(doc, withChunk, true);
+    std::cout << "Loading 1M points from XML: " << xmlTime << " ms, with the stroke geometry chunk: "
+              << timeLoad(withChunk) << " ms" << std::endl;
+}
+#endif
+
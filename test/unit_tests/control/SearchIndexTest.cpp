@@ -0,0 +1,102 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "control/SearchIndex.h"
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Text.h"
+#include "model/XojPage.h"
+
+static void addText(Layer* layer, const std::string& content) {
+    auto* t = new Text();
+    t->setText(content);
+    layer->addElement(t);
+}
+
+TEST(SearchIndex, testCountOccurrences) {
+    EXPECT_EQ(SearchIndex::countOccurrences("abcabc", "abc"), 2);
+    EXPECT_EQ(SearchIndex::countOccurrences("aaaa", "aa"), 3);
+    EXPECT_EQ(SearchIndex::countOccurrences("abc", "d"), 0);
+    EXPECT_EQ(SearchIndex::countOccurrences("abc", ""), 0);
+}
+
+TEST(SearchIndex, testElementText) {
+    DocumentHandler handler;
+    Document doc(&handler);
+
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 3; ++i) {
+        auto page = std::make_shared<XojPage>(100, 100);
+        doc.addPage(page);
+        pages.push_back(page);
+    }
+    addText(pages[0]->getSelectedLayer(), "Hello World");
+    addText(pages[0]->getSelectedLayer(), "hello again");
+    addText(pages[2]->getSelectedLayer(), "Goodbye");
+
+    SearchIndex index(&doc, nullptr);
+    index.reset();
+    EXPECT_TRUE(index.isComplete());
+
+    EXPECT_EQ(index.countMatches(0, "HELLO"), 2);
+    EXPECT_EQ(index.countMatches(1, "hello"), 0);
+    EXPECT_EQ(index.countMatches(2, "bye"), 1);
+    EXPECT_EQ(index.countMatches(0, ""), 0);
+
+    // Matches do not span two elements
+    EXPECT_EQ(index.countMatches(0, "worldhello"), 0);
+
+    // The text of a page is only extracted again after it was invalidated
+    addText(pages[1]->getSelectedLayer(), "hello");
+    EXPECT_EQ(index.countMatches(1, "hello"), 0);
+    index.invalidatePage(pages[1]);
+    EXPECT_EQ(index.countMatches(1, "hello"), 1);
+}
+
+TEST(SearchIndex, testCountInDocument) {
+    DocumentHandler handler;
+    Document doc(&handler);
+
+    std::vector<PageRef> pages;
+    for (int i = 0; i < 3; ++i) {
+        auto page = std::make_shared<XojPage>(100, 100);
+        doc.addPage(page);
+        pages.push_back(page);
+    }
+    addText(pages[0]->getSelectedLayer(), "Hello World");
+    addText(pages[1]->getSelectedLayer(), "help");
+    addText(pages[2]->getSelectedLayer(), "hello hello");
+
+    SearchIndex index(&doc, nullptr);
+    index.reset();
+
+    // As the text is typed
+    EXPECT_EQ(index.countInDocument("h"), 4);
+    EXPECT_EQ(index.countInDocument("hel"), 4);
+    EXPECT_EQ(index.countInDocument("hell"), 3);
+    EXPECT_EQ(index.countInDocument("hello"), 3);
+    EXPECT_EQ(index.countInDocument("hello w"), 1);
+    EXPECT_EQ(index.countInDocument("hello"), 3);
+    EXPECT_EQ(index.countInDocument("help"), 1);
+    EXPECT_EQ(index.countInDocument(""), 0);
+
+    // A changed page is counted again, the others are not
+    addText(pages[1]->getSelectedLayer(), "hello");
+    EXPECT_EQ(index.countInDocument("help"), 1);
+    index.invalidatePage(pages[1]);
+    EXPECT_EQ(index.countInDocument("hello"), 4);
+    EXPECT_EQ(index.countMatches(1, "hello"), 1);
+}
@@ -0,0 +1,103 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <iterator>
+#include <memory>
+#include <optional>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "control/ThumbnailCache.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+#include "filesystem.h"
+
+class ThumbnailCacheTest: public ::testing::Test {
+protected:
+    void SetUp() override {
+        dir = fs::temp_directory_path() / "xournalpp-thumbnail-cache-test";
+        fs::remove_all(dir);
+        fs::create_directories(dir);
+    }
+
+    void TearDown() override { fs::remove_all(dir); }
+
+    fs::path dir;
+};
+
+TEST_F(ThumbnailCacheTest, testKey) {
+    auto page = std::make_shared<XojPage>(100, 100);
+    auto key = ThumbnailCache::computeKey("doc", 0, page, 20, 30, 0.15);
+    ASSERT_TRUE(key);
+    auto sameKey = [](const std::optional<ThumbnailCache::Key>& a, const std::optional<ThumbnailCache::Key>& b) {
+        return a && b && a->file == b->file && a->contents == b->contents;
+    };
+    EXPECT_TRUE(sameKey(key, ThumbnailCache::computeKey("doc", 0, page, 20, 30, 0.15)));
+    EXPECT_NE(key->contents, ThumbnailCache::computeKey("other", 0, page, 20, 30, 0.15)->contents);
+    EXPECT_NE(key->contents, ThumbnailCache::computeKey("doc", 0, page, 21, 30, 0.15)->contents);
+    EXPECT_NE(key->contents, ThumbnailCache::computeKey("doc", 0, page, 20, 30, 0.2)->contents);
+    EXPECT_NE(key->file, ThumbnailCache::computeKey("doc", 0, page, 21, 30, 0.15)->file);
+
+    // The same contents on another page have the same preview, in another file
+    auto copy = std::make_shared<XojPage>(100, 100);
+    auto copyKey = ThumbnailCache::computeKey("doc", 1, copy, 20, 30, 0.15);
+    EXPECT_EQ(key->contents, copyKey->contents);
+    EXPECT_NE(key->file, copyKey->file);
+
+    // The changes of the page only change its contents: the preview of the page is replaced
+    auto* s = new Stroke();
+    s->addPoint(Point(1, 1));
+    s->addPoint(Point(2, 2));
+    page->getSelectedLayer()->addElement(s);
+    auto changed = ThumbnailCache::computeKey("doc", 0, page, 20, 30, 0.15);
+    EXPECT_EQ(key->file, changed->file);
+    EXPECT_NE(key->contents, changed->contents);
+
+    s->move(1, 0);
+    EXPECT_NE(changed->contents, ThumbnailCache::computeKey("doc", 0, page, 20, 30, 0.15)->contents);
+
+    // The points of compact strokes are hashed without decoding them
+    s->compact(StrokeStorage::QUANTIZED);
+    EXPECT_TRUE(ThumbnailCache::computeKey("doc", 0, page, 20, 30, 0.15));
+    EXPECT_EQ(s->getDecodedMemoryUsage(), 0);
+}
+
+TEST_F(ThumbnailCacheTest, testStoreAndLookup) {
+    ThumbnailCache cache(dir / "cache");
+    const ThumbnailCache::Key a{"page", "a"};
+    EXPECT_EQ(cache.lookup(a, 20, 30), nullptr);
+
+    cairo_surface_t* thumbnail = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, 20, 30);
+    cache.store(a, thumbnail);
+
+    cairo_surface_t* cached = cache.lookup(a, 20, 30);
+    ASSERT_NE(cached, nullptr);
+    EXPECT_EQ(cairo_image_surface_get_width(cached), 20);
+    EXPECT_EQ(cairo_image_surface_get_height(cached), 30);
+    cairo_surface_destroy(cached);
+
+    // A preview of another size is useless
+    EXPECT_EQ(cache.lookup(a, 30, 30), nullptr);
+
+    // A new version of the page replaces the previous one
+    const ThumbnailCache::Key b{"page", "b"};
+    EXPECT_EQ(cache.lookup(b, 20, 30), nullptr);
+    cache.store(b, thumbnail);
+    cairo_surface_destroy(thumbnail);
+    EXPECT_EQ(cache.lookup(a, 20, 30), nullptr);
+    cached = cache.lookup(b, 20, 30);
+    EXPECT_NE(cached, nullptr);
+    cairo_surface_destroy(cached);
+    EXPECT_EQ(std::distance(fs::directory_iterator(dir / "cache"), fs::directory_iterator()), 1);
+}
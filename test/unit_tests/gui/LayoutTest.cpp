@@ -0,0 +1,87 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "gui/Layout.h"
+
+/**
+ * The rows intersecting [from, to], as computed by the linear scan Layout::updateVisibility() used to do
+ */
+static auto visibleRangeLinear(const std::vector<unsigned>& ends, double from, double to) -> std::pair<size_t, size_t> {
+    size_t first = ends.size();
+    size_t end = 0;
+    double start = 0;
+    for (size_t i = 0; i < ends.size(); ++i) {
+        if (!(from > ends[i] || to < start)) {
+            first = std::min(first, i);
+            end = i + 1;
+        }
+        start = ends[i];
+    }
+    return first < end ? std::make_pair(first, end) : std::make_pair(ends.size(), ends.size());
+}
+
+static auto makeRows(size_t count) -> std::vector<unsigned> {
+    // Pages of alternating heights, 15px between them, 10px above the first one
+    std::vector<unsigned> ends;
+    unsigned y = 10;
+    for (size_t i = 0; i < count; ++i) {
+        y += (i % 3 == 0 ? 1123 : 842) + 15;
+        ends.push_back(y);
+    }
+    return ends;
+}
+
+TEST(Layout, testVisibleRange) {
+    auto ends = makeRows(50);
+    for (double from = -100; from < ends.back() + 200; from += 97) {
+        for (double height: {0.0, 10.0, 600.0, 3000.0}) {
+            auto [first, end] = Layout::visibleRange(ends, from, from + height);
+            auto [expectedFirst, expectedEnd] = visibleRangeLinear(ends, from, from + height);
+            if (expectedFirst == expectedEnd) {
+                EXPECT_TRUE(first == end || (first == 0 && end == 1)) << from << " " << height;
+                continue;
+            }
+            EXPECT_EQ(first, expectedFirst) << from << " " << height;
+            EXPECT_EQ(end, expectedEnd) << from << " " << height;
+        }
+    }
+
+    auto [first, end] = Layout::visibleRange({}, 0, 100);
+    EXPECT_EQ(first, end);
+}
+
+#ifdef TEST_CHECK_SPEED
+TEST(Layout, benchmarkScrollVisibleRange) {
+    auto ends = makeRows(5000);
+    constexpr double viewportHeight = 900;
+
+    auto scroll = [&](auto&& visibleRange) {
+        auto start = std::chrono::steady_clock::now();
+        size_t checked = 0;
+        for (double y = 0; y < ends.back(); y += 40) {
+            auto [first, end] = visibleRange(ends, y, y + viewportHeight);
+            checked += end - first;
+        }
+        EXPECT_GT(checked, 0U);
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    std::cout << "Scrolling through 5000 pages: linear scan " << scroll(visibleRangeLinear) << " ms, binary search "
+              << scroll(Layout::visibleRange) << " ms" << std::endl;
+}
+#endif
@@ -0,0 +1,86 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cstdint>
+
+#include <config-test.h>
+#include <gtest/gtest.h>
+
+#include "gui/PagePrefetcher.h"
+
+using Direction = PagePrefetcher::Direction;
+
+constexpr int64_t FRAME = 16000;  // 16ms between two scroll events
+
+/**
+ * Scrolls at a constant velocity (in pages per second) for the given number of events
+ */
+static auto scroll(PagePrefetcher& prefetcher, double& position, int64_t& time, double velocity, int events) -> bool {
+    bool reversed = false;
+    for (int i = 0; i < events; i++) {
+        position += velocity * FRAME / 1e6;
+        time += FRAME;
+        reversed |= prefetcher.update(position, time);
+    }
+    return reversed;
+}
+
+TEST(PagePrefetcher, testVelocityAndRange) {
+    PagePrefetcher prefetcher;
+    double position = 10;
+    int64_t time = 1000000;
+    prefetcher.update(position, time);
+    EXPECT_EQ(Direction::NONE, prefetcher.getDirection());
+    EXPECT_EQ(std::make_pair(size_t(0), size_t(0)), prefetcher.getRange(10, 11, 100, 1));
+
+    EXPECT_FALSE(scroll(prefetcher, position, time, 4, 50));
+    EXPECT_EQ(Direction::FORWARD, prefetcher.getDirection());
+    EXPECT_NEAR(4, prefetcher.getVelocity(), 0.01);
+    EXPECT_EQ(4, prefetcher.getPagesAhead(1));
+    EXPECT_EQ(std::make_pair(size_t(12), size_t(16)), prefetcher.getRange(10, 11, 100, 1));
+    // Clamped to the document
+    EXPECT_EQ(std::make_pair(size_t(98), size_t(100)), prefetcher.getRange(96, 97, 100, 1));
+
+    // Fast flicks are bounded
+    scroll(prefetcher, position, time, 100, 50);
+    EXPECT_EQ(PagePrefetcher::MAX_PAGES_AHEAD, prefetcher.getPagesAhead(1));
+
+    // ... and so is the memory
+    prefetcher.setMemoryBudget(10);
+    EXPECT_EQ(3, prefetcher.getPagesAhead(3));
+    EXPECT_EQ(0, prefetcher.getPagesAhead(11));
+}
+
+TEST(PagePrefetcher, testReversal) {
+    PagePrefetcher prefetcher;
+    double position = 50;
+    int64_t time = 0;
+    prefetcher.update(position, time);
+
+    EXPECT_FALSE(scroll(prefetcher, position, time, 3, 30));
+    EXPECT_EQ(Direction::FORWARD, prefetcher.getDirection());
+
+    EXPECT_TRUE(scroll(prefetcher, position, time, -3, 30));
+    EXPECT_EQ(Direction::BACKWARD, prefetcher.getDirection());
+    EXPECT_EQ(std::make_pair(size_t(17), size_t(20)), prefetcher.getRange(20, 21, 100, 1));
+    EXPECT_EQ(std::make_pair(size_t(0), size_t(2)), prefetcher.getRange(2, 3, 100, 1));
+
+    // Stopping and going on in the same direction is no reversal
+    time += 2 * PagePrefetcher::IDLE_TIME;
+    prefetcher.update(position, time);
+    EXPECT_EQ(Direction::NONE, prefetcher.getDirection());
+    EXPECT_FALSE(scroll(prefetcher, position, time, -3, 30));
+
+    // A jump forgets the history
+    prefetcher.reset();
+    prefetcher.update(position, time);
+    EXPECT_FALSE(scroll(prefetcher, position, time, 3, 30));
+}
@@ -0,0 +1,64 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+#include "model/AudioIndex.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+#include "model/XojPage.h"
+
+static auto addStroke(Layer* layer, size_t timestamp, const fs::path& file) -> Stroke* {
+    auto* s = new Stroke();
+    s->addPoint(Point(1, 1));
+    s->addPoint(Point(2, 2));
+    s->setTimestamp(timestamp);
+    s->setAudioFilename(file);
+    layer->addElement(s);
+    return s;
+}
+
+TEST(AudioIndex, testPageEntries) {
+    auto page0 = std::make_shared<XojPage>(100, 100);
+    auto page1 = std::make_shared<XojPage>(100, 100);
+    Layer* layer0 = page0->getSelectedLayer();
+    Layer* layer1 = page1->getSelectedLayer();
+
+    Stroke* a300 = addStroke(layer0, 300, "a.ogg");
+    addStroke(layer0, 50, "");
+    Stroke* b200 = addStroke(layer1, 200, "b.ogg");
+
+    AudioIndex index;
+
+    // The stroke without recording is not indexed
+    ASSERT_EQ(index.getPageEntries(page0).size(), 1);
+    EXPECT_EQ(index.getPageEntries(page0)[0].element, a300);
+    EXPECT_EQ(index.getPageEntries(page0)[0].layer, layer0);
+    ASSERT_EQ(index.getPageEntries(page1).size(), 1);
+    EXPECT_EQ(index.getPageEntries(page1)[0].element, b200);
+
+    // Only the invalidated page is indexed again
+    addStroke(layer0, 400, "a.ogg");
+    addStroke(layer1, 400, "b.ogg");
+    EXPECT_EQ(index.getPageEntries(page0).size(), 1);
+    index.invalidatePage(page0);
+    EXPECT_EQ(index.getPageEntries(page0).size(), 2);
+    EXPECT_EQ(index.getPageEntries(page1).size(), 1);
+
+    index.clear();
+    EXPECT_EQ(index.getPageEntries(page1).size(), 2);
+
+    // A new page is not mistaken for a deleted one
+    auto page2 = std::make_shared<XojPage>(100, 100);
+    EXPECT_TRUE(index.getPageEntries(page2).empty());
+}
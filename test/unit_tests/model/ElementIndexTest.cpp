@@ -0,0 +1,160 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/ElementIndex.h"
+#include "model/Layer.h"
+#include "model/Stroke.h"
+
+/**
+ * A short horizontal stroke from (x, y) to (x + 4, y)
+ */
+static auto makeStroke(double x, double y) -> Stroke* {
+    auto* s = new Stroke();
+    s->setWidth(1);
+    s->addPoint(Point(x, y));
+    s->addPoint(Point(x + 4, y));
+    return s;
+}
+
+static auto boxDistance(Element* e, double x, double y) -> double {
+    return ElementIndex::distance(
+            xoj::util::Rectangle<double>(e->getX(), e->getY(), e->getElementWidth(), e->getElementHeight()), x, y);
+}
+
+TEST(ElementIndex, testFindNearest) {
+    Layer layer;
+    Stroke* a = makeStroke(0, 0);
+    Stroke* b = makeStroke(20, 0);
+    Stroke* c = makeStroke(0, 20);
+    layer.addElement(a);
+    layer.addElement(b);
+    layer.addElement(c);
+
+    auto acceptAll = [](Element*) { return true; };
+    EXPECT_EQ(layer.getElementIndex().findNearest(1, 0, 10, acceptAll), a);
+    EXPECT_EQ(layer.getElementIndex().findNearest(18, 1, 10, acceptAll), b);
+    EXPECT_EQ(layer.getElementIndex().findNearest(2, 17, 10, acceptAll), c);
+
+    // Nothing within the maximal distance
+    EXPECT_EQ(layer.getElementIndex().findNearest(100, 100, 10, acceptAll), nullptr);
+
+    // Rejected candidates are skipped for the next closest one
+    EXPECT_EQ(layer.getElementIndex().findNearest(1, 0, 30, [a](Element* e) { return e != a; }), c);
+    EXPECT_EQ(layer.getElementIndex().findNearest(1, 0, 10, [a](Element* e) { return e != a; }), nullptr);
+
+    // The index follows the removals and insertions
+    layer.removeElement(a, true);
+    EXPECT_EQ(layer.getElementIndex().findNearest(1, 0, 30, acceptAll), c);
+    Stroke* d = makeStroke(0, 2);
+    layer.addElement(d);
+    EXPECT_EQ(layer.getElementIndex().findNearest(1, 0, 30, acceptAll), d);
+
+    // And the elements moved in place, once reported
+    d->move(50, 50);
+    layer.updateElementIndex(d);
+    EXPECT_EQ(layer.getElementIndex().findNearest(1, 0, 30, acceptAll), c);
+    EXPECT_EQ(layer.getElementIndex().findNearest(52, 52, 10, acceptAll), d);
+}
+
+TEST(ElementIndex, testIncrementalUpdates) {
+    std::vector<std::unique_ptr<Stroke>> strokes;
+    std::vector<Element*> elements;
+    for (int i = 0; i < 300; i++) {
+        double x = std::fmod(i * 37.3, 500);
+        double y = std::fmod(i * 91.7, 700);
+        strokes.emplace_back(makeStroke(x, y));
+        elements.push_back(strokes.back().get());
+    }
+    ElementIndex index(std::vector<Element*>(elements.begin(), elements.begin() + 200));
+
+    // Remove every other element of the tree, insert the last ones
+    std::vector<Element*> expected;
+    for (size_t i = 0; i < 200; i++) {
+        if (i % 2 == 0) {
+            index.remove(elements[i]);
+        } else {
+            expected.push_back(elements[i]);
+        }
+    }
+    for (size_t i = 200; i < elements.size(); i++) {
+        index.insert(elements[i]);
+        expected.push_back(elements[i]);
+    }
+    EXPECT_TRUE(index.needsRebuild());
+
+    for (double x = -20; x < 520; x += 23.1) {
+        for (double y = -20; y < 720; y += 29.3) {
+            Element* found = index.findNearest(x, y, 15, [](Element*) { return true; });
+            double best = 15;
+            bool any = false;
+            for (Element* e: expected) {
+                if (double d = boxDistance(e, x, y); d <= best) {
+                    best = d;
+                    any = true;
+                }
+            }
+            if (!any) {
+                EXPECT_EQ(found, nullptr);
+            } else {
+                ASSERT_NE(found, nullptr);
+                EXPECT_NE(std::find(expected.begin(), expected.end(), found), expected.end());
+                EXPECT_DOUBLE_EQ(boxDistance(found, x, y), best);
+            }
+        }
+    }
+}
+
+TEST(ElementIndex, testMatchesLinearSearch) {
+    std::vector<std::unique_ptr<Stroke>> strokes;
+    std::vector<Element*> elements;
+    for (int i = 0; i < 1000; i++) {
+        // Pseudo random, deterministic positions
+        double x = std::fmod(i * 37.3, 500);
+        double y = std::fmod(i * 91.7, 700);
+        strokes.emplace_back(makeStroke(x, y));
+        elements.push_back(strokes.back().get());
+    }
+    ElementIndex index(elements);
+
+    for (double x = -20; x < 520; x += 13.7) {
+        for (double y = -20; y < 720; y += 17.9) {
+            // Only every third element is accepted
+            auto accept = [&](Element* e) {
+                auto pos = std::find(elements.begin(), elements.end(), e) - elements.begin();
+                return pos % 3 == 0;
+            };
+            Element* found = index.findNearest(x, y, 15, accept);
+
+            double best = 15;
+            bool any = false;
+            for (size_t i = 0; i < elements.size(); i += 3) {
+                double d = boxDistance(elements[i], x, y);
+                if (d <= best) {
+                    best = d;
+                    any = true;
+                }
+            }
+            if (!any) {
+                EXPECT_EQ(found, nullptr);
+            } else {
+                ASSERT_NE(found, nullptr);
+                EXPECT_DOUBLE_EQ(boxDistance(found, x, y), best);
+            }
+        }
+    }
+}
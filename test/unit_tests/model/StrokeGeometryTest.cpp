@@ -0,0 +1,288 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Document.h"
+#include "model/DocumentHandler.h"
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "model/StrokeDecodeCache.h"
+#include "model/StrokeGeometry.h"
+#include "model/XojPage.h"
+
+#include "config-test.h"
+
+static std::vector<Point> makePoints(size_t n, bool withPressure) {
+    std::vector<Point> points;
+    for (size_t i = 0; i < n; ++i) {
+        double t = static_cast<double>(i);
+        points.emplace_back(10.0 + t * 0.25, 20.0 - t * 0.125, withPressure ? 1.0 + 0.01 * t : Point::NO_PRESSURE);
+    }
+    return points;
+}
+
+TEST(StrokeGeometry, testRoundTripDouble) {
+    auto points = makePoints(100, true);
+    StrokeGeometry geometry(points, StrokeStorage::COMPACT);
+
+    ASSERT_EQ(geometry.size(), points.size());
+    ASSERT_TRUE(geometry.hasPressure());
+    ASSERT_FALSE(geometry.isSinglePrecision());
+
+    auto decoded = geometry.toPoints();
+    ASSERT_EQ(decoded.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(decoded[i].x, points[i].x);
+        EXPECT_EQ(decoded[i].y, points[i].y);
+        EXPECT_EQ(decoded[i].z, points[i].z);
+        EXPECT_EQ(geometry.getPoint(i).x, points[i].x);
+        EXPECT_EQ(geometry.getPoint(i).z, points[i].z);
+    }
+}
+
+TEST(StrokeGeometry, testNoPressure) {
+    auto points = makePoints(10, false);
+    StrokeGeometry geometry(points, StrokeStorage::COMPACT);
+
+    ASSERT_FALSE(geometry.hasPressure());
+    for (auto&& p: geometry.toPoints()) { EXPECT_EQ(p.z, Point::NO_PRESSURE); }
+
+    // Without pressure, only the coordinates are stored
+    EXPECT_LE(geometry.getMemoryUsage(), 2 * sizeof(double) * points.size());
+}
+
+TEST(StrokeGeometry, testSinglePrecision) {
+    auto points = makePoints(1000, false);
+    StrokeGeometry geometry(points, StrokeStorage::COMPACT_FLOAT);
+
+    ASSERT_TRUE(geometry.isSinglePrecision());
+    EXPECT_LE(geometry.getMemoryUsage(), 2 * sizeof(float) * points.size());
+
+    size_t i = 0;
+    geometry.forEachPosition([&](double x, double y) {
+        EXPECT_NEAR(x, points[i].x, 1e-4);
+        EXPECT_NEAR(y, points[i].y, 1e-4);
+        ++i;
+    });
+    EXPECT_EQ(i, points.size());
+}
+
+TEST(StrokeGeometry, testBoundsAndFind) {
+    std::vector<Point> points = {{1, 5, 2}, {-3, 2, 4}, {7, -1, 1}, {0, 0, 3}};
+    StrokeGeometry geometry(points, StrokeStorage::COMPACT);
+
+    double minX, minY, maxX, maxY, maxPressure;
+    geometry.getBounds(minX, minY, maxX, maxY, maxPressure);
+    EXPECT_EQ(minX, -3);
+    EXPECT_EQ(minY, -1);
+    EXPECT_EQ(maxX, 7);
+    EXPECT_EQ(maxY, 5);
+    EXPECT_EQ(maxPressure, 4);
+
+    int visited = 0;
+    EXPECT_TRUE(geometry.findPosition([&visited](double x, double) {
+        ++visited;
+        return x > 5;
+    }));
+    EXPECT_EQ(visited, 3);
+    EXPECT_FALSE(geometry.findPosition([](double x, double) { return x > 100; }));
+}
+
+TEST(StrokeGeometry, testQuantizedMatchesFilePrecision) {
+    auto points = makePoints(500, true);
+    points.emplace_back(-12.345678914, 1e6 + 0.123456789, 0.5);
+    StrokeGeometry geometry(points, StrokeStorage::QUANTIZED);
+
+    ASSERT_EQ(geometry.getStorage(), StrokeStorage::QUANTIZED);
+    ASSERT_FALSE(geometry.hasRandomAccess());
+    ASSERT_EQ(geometry.size(), points.size());
+    ASSERT_TRUE(geometry.hasPressure());
+
+    // Decoding gives the values read back from a saved file
+    auto reparse = [](double v) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.8f", v);
+        return strtod(buffer, nullptr);
+    };
+    auto decoded = geometry.toPoints();
+    ASSERT_EQ(decoded.size(), points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        EXPECT_EQ(decoded[i].x, reparse(points[i].x));
+        EXPECT_EQ(decoded[i].y, reparse(points[i].y));
+        EXPECT_EQ(decoded[i].z, reparse(points[i].z));
+    }
+    EXPECT_EQ(geometry.getPoint(points.size() - 1).y, decoded.back().y);
+    EXPECT_EQ(geometry.getPoint(3).z, decoded[3].z);
+
+    // Small deltas are cheaper than floats
+    EXPECT_LT(geometry.getMemoryUsage(), 3 * sizeof(float) * points.size());
+}
+
+TEST(StrokeGeometry, testQuantizedBoundsAndFind) {
+    std::vector<Point> points = {{1, 5}, {-3, 2}, {7, -1}, {0, 0}};
+    StrokeGeometry geometry(points, StrokeStorage::QUANTIZED);
+
+    ASSERT_FALSE(geometry.hasPressure());
+    double minX, minY, maxX, maxY, maxPressure;
+    geometry.getBounds(minX, minY, maxX, maxY, maxPressure);
+    EXPECT_EQ(minX, -3);
+    EXPECT_EQ(minY, -1);
+    EXPECT_EQ(maxX, 7);
+    EXPECT_EQ(maxY, 5);
+    EXPECT_EQ(maxPressure, 0);
+
+    int visited = 0;
+    EXPECT_TRUE(geometry.findPosition([&visited](double x, double) {
+        ++visited;
+        return x > 5;
+    }));
+    EXPECT_EQ(visited, 3);
+}
+
+TEST(StrokeGeometry, testQuantizedOutOfRange) {
+    std::vector<Point> points = {{1, 5}, {1e12, 2}};
+    StrokeGeometry geometry(points, StrokeStorage::QUANTIZED);
+
+    EXPECT_EQ(geometry.getStorage(), StrokeStorage::COMPACT);
+    EXPECT_EQ(geometry.getPoint(1).x, 1e12);
+}
+
+TEST(StrokeGeometry, testCompactStrokeCopyOnWrite) {
+    Stroke stroke;
+    for (const Point& p: makePoints(100, true)) { stroke.addPoint(p); }
+    stroke.compact(StrokeStorage::COMPACT);
+
+    // The copy shares the geometry, and does not decode it
+    std::unique_ptr<Stroke> copy(stroke.cloneStroke());
+    EXPECT_EQ(stroke.getCompactGeometry(), copy->getCompactGeometry());
+    EXPECT_EQ(0, copy->getDecodedMemoryUsage());
+    EXPECT_EQ(stroke.getPoint(42).x, copy->getPoint(42).x);
+
+    // Editing the copy leaves the original unchanged
+    copy->move(1, 0);
+    EXPECT_EQ(nullptr, copy->getCompactGeometry());
+    EXPECT_NE(nullptr, stroke.getCompactGeometry());
+    EXPECT_DOUBLE_EQ(stroke.getPoint(42).x + 1, copy->getPoint(42).x);
+}
+
+TEST(StrokeGeometry, testDecodeCacheTrim) {
+    DocumentHandler handler;
+    Document doc(&handler);
+    auto page = std::make_shared<XojPage>(100, 100);
+    doc.addPage(page);
+    std::vector<Stroke*> strokes;
+    for (int i = 0; i < 4; ++i) {
+        auto* s = new Stroke();
+        for (const Point& p: makePoints(1000, true)) { s->addPoint(p); }
+        s->compact(StrokeStorage::COMPACT);
+        page->getSelectedLayer()->addElement(s);
+        strokes.push_back(s);
+    }
+
+    // Nothing was decoded
+    EXPECT_EQ(0, StrokeDecodeCache::trim(&doc, 0));
+
+    for (Stroke* s: strokes) { s->getPointVector(); }
+    const size_t copySize = strokes[0]->getDecodedMemoryUsage();
+    ASSERT_GT(copySize, 0);
+
+    // The least recently used copies are released first
+    EXPECT_EQ(2 * copySize, StrokeDecodeCache::trim(&doc, 2 * copySize));
+    EXPECT_EQ(0, strokes[0]->getDecodedMemoryUsage());
+    EXPECT_EQ(0, strokes[1]->getDecodedMemoryUsage());
+    EXPECT_EQ(copySize, strokes[3]->getDecodedMemoryUsage());
+
+    // Under the budget, until more points are decoded
+    EXPECT_EQ(0, StrokeDecodeCache::trim(&doc, 2 * copySize));
+    strokes[0]->getPointVector();
+    EXPECT_EQ(copySize, StrokeDecodeCache::trim(&doc, 2 * copySize));
+    EXPECT_EQ(0, strokes[2]->getDecodedMemoryUsage());
+}
+
+TEST(StrokeGeometry, testQuantizedHitTestWithoutDecoding) {
+    Stroke stroke;
+    stroke.setWidth(1);
+    for (const Point& p: makePoints(100, true)) { stroke.addPoint(p); }
+    stroke.compact(StrokeStorage::QUANTIZED);
+
+    EXPECT_TRUE(stroke.intersects(10.0 + 42 * 0.25, 20.0 - 42 * 0.125, 0.5));
+    EXPECT_FALSE(stroke.intersects(100, 100, 0.5));
+    EXPECT_EQ(0, stroke.getDecodedMemoryUsage());
+}
+
+#ifdef TEST_CHECK_SPEED
+TEST(StrokeGeometry, benchmarkStorages) {
+    // A synthetic document: 20000 strokes of 200 points without pressure
+    constexpr size_t STROKE_COUNT = 20000;
+    constexpr size_t POINT_COUNT = 200;
+
+    for (StrokeStorage storage:
+         {StrokeStorage::POINTS, StrokeStorage::COMPACT, StrokeStorage::COMPACT_FLOAT, StrokeStorage::QUANTIZED}) {
+        std::vector<Stroke> strokes(STROKE_COUNT);
+        size_t memory = 0;
+        for (size_t i = 0; i < STROKE_COUNT; ++i) {
+            Stroke& stroke = strokes[i];
+            stroke.setWidth(1);
+            double x0 = static_cast<double>(i % 100) * 6;
+            double y0 = static_cast<double>(i / 100) * 4;
+            for (size_t j = 0; j < POINT_COUNT; ++j) {
+                double t = static_cast<double>(j) * 0.025;
+                stroke.addPoint(Point(x0 + t, y0 + std::sin(t)));
+            }
+            stroke.freeUnusedPointItems();
+            stroke.compact(storage);
+            const StrokeGeometry* geometry = stroke.getCompactGeometry();
+            memory += geometry ? geometry->getMemoryUsage() : stroke.getPointVector().capacity() * sizeof(Point);
+        }
+
+        // Point-in-box hit test over all the strokes, as the eraser does
+        size_t hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (double x = 0; x < 600; x += 60) {
+            for (const Stroke& stroke: strokes) { hits += stroke.intersects(x + 2.5, 300, 0.5); }
+        }
+        auto time = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        EXPECT_GT(hits, 0);
+
+        size_t decoded = 0;
+        for (const Stroke& stroke: strokes) { decoded += stroke.getDecodedMemoryUsage(); }
+        EXPECT_EQ(0, decoded);
+
+        std::cout << "Storage " << static_cast<int>(storage) << ": " << memory / 1000000
+                  << " MB of points, hit test in " << time << " ms" << std::endl;
+    }
+}
+#endif
+
+TEST(StrokeGeometry, testStrokeCopyOnWrite) {
+    Stroke stroke;
+    for (const Point& p: makePoints(100, true)) { stroke.addPoint(p); }
+    ASSERT_FALSE(stroke.isCompact());
+
+    // The copies share the points
+    std::unique_ptr<Stroke> copy(stroke.cloneStroke());
+    std::unique_ptr<Stroke> copyOfCopy(copy->cloneStroke());
+    EXPECT_EQ(stroke.getPoints(), copy->getPoints());
+    EXPECT_EQ(stroke.getPoints(), copyOfCopy->getPoints());
+
+    // Editing a copy detaches it, the others are unchanged
+    const double x = stroke.getPoint(42).x;
+    copy->move(1, 0);
+    EXPECT_NE(stroke.getPoints(), copy->getPoints());
+    EXPECT_EQ(stroke.getPoints(), copyOfCopy->getPoints());
+    EXPECT_DOUBLE_EQ(x, stroke.getPoint(42).x);
+    EXPECT_DOUBLE_EQ(x + 1, copy->getPoint(42).x);
+
+    // So does editing the original
+    stroke.addPoint(Point(0, 0));
+    EXPECT_EQ(101, stroke.getPointCount());
+    EXPECT_EQ(100, copyOfCopy->getPointCount());
+    EXPECT_DOUBLE_EQ(x, copyOfCopy->getPoint(42).x);
+}
@@ -0,0 +1,132 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <cmath>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/PathParameter.h"
+#include "model/Stroke.h"
+#include "model/StrokeGeometry.h"
+#include "model/StrokeSegmentTree.h"
+#include "model/eraser/PaddedBox.h"
+#include "util/Rectangle.h"
+#include "util/SmallVector.h"
+
+using xoj::util::Rectangle;
+
+/**
+ * A spiral, whose segments are in every direction and whose leaves overlap
+ */
+static auto spiral(size_t n) -> std::vector<Point> {
+    std::vector<Point> points;
+    for (size_t i = 0; i < n; i++) {
+        double t = 0.05 * static_cast<double>(i);
+        points.emplace_back(100 + t * std::cos(t), 100 + t * std::sin(t));
+    }
+    return points;
+}
+
+TEST(StrokeSegmentTree, testFindSegments) {
+    auto points = spiral(1000);
+    StrokeSegmentTree tree(points);
+    ASSERT_EQ(tree.getSegmentCount(), 999);
+
+    for (double x = 50; x < 150; x += 7.3) {
+        for (double y = 50; y < 150; y += 9.1) {
+            Rectangle<double> rect(x, y, 3, 2);
+            auto runs = tree.findSegments(rect, 100, 900);
+
+            // Every segment meeting the rectangle is reported, within the requested interval
+            std::vector<bool> reported(tree.getSegmentCount(), false);
+            for (size_t i = 0; i < runs.size(); i++) {
+                ASSERT_LE(100, runs[i].min);
+                ASSERT_LE(runs[i].min, runs[i].max);
+                ASSERT_LE(runs[i].max, 900);
+                if (i > 0) {
+                    // Sorted and maximal
+                    ASSERT_LT(runs[i - 1].max + 1, runs[i].min);
+                }
+                for (size_t s = runs[i].min; s <= runs[i].max; s++) { reported[s] = true; }
+            }
+            for (size_t s = 100; s <= 900; s++) {
+                Rectangle<double> box(std::min(points[s].x, points[s + 1].x), std::min(points[s].y, points[s + 1].y),
+                                      std::abs(points[s].x - points[s + 1].x), std::abs(points[s].y - points[s + 1].y));
+                if (StrokeSegmentTree::touches(box, rect)) {
+                    EXPECT_TRUE(reported[s]) << "segment " << s;
+                }
+            }
+        }
+    }
+}
+
+TEST(StrokeSegmentTree, testStrokeQueries) {
+    // A long horizontal line, so that the segment tree is used
+    Stroke stroke;
+    stroke.setWidth(1);
+    for (int i = 0; i < 1000; i++) { stroke.addPoint(Point(i, 0)); }
+
+    EXPECT_TRUE(stroke.intersects(500.3, 0.5, 1));
+    EXPECT_TRUE(stroke.intersects(0, 0, 1));
+    EXPECT_FALSE(stroke.intersects(500.3, 10, 1));
+    EXPECT_FALSE(stroke.intersects(1100, 0, 1));
+
+    PaddedBox box{{500.5, 0}, 1, 3};
+    auto params = stroke.intersectWithPaddedBox(box);
+    ASSERT_EQ(params.size(), 2);
+    EXPECT_EQ(params[0].index, 497);
+    EXPECT_DOUBLE_EQ(params[0].t, 0.5);
+    EXPECT_EQ(params[1].index, 503);
+    EXPECT_DOUBLE_EQ(params[1].t, 0.5);
+
+    // The tree follows the geometry
+    stroke.move(0, 10);
+    EXPECT_FALSE(stroke.intersects(500.3, 0.5, 1));
+    EXPECT_TRUE(stroke.intersects(500.3, 10, 1));
+    EXPECT_TRUE(stroke.intersectWithPaddedBox(box).empty());
+
+    // Copies share the tree until one of them is changed
+    Stroke copy = stroke;
+    copy.move(0, -10);
+    EXPECT_TRUE(stroke.intersects(500.3, 10, 1));
+    EXPECT_TRUE(copy.intersects(500.3, 0.5, 1));
+}
+
+TEST(StrokeSegmentTree, testCompactStroke) {
+    auto points = spiral(1000);
+    StrokeSegmentTree tree(points);
+
+    // The tree of the compact geometry is the same, and built without decoding it
+    for (StrokeStorage storage: {StrokeStorage::COMPACT, StrokeStorage::QUANTIZED}) {
+        StrokeGeometry geometry(points, storage);
+        StrokeSegmentTree compactTree(geometry);
+        ASSERT_EQ(tree.getSegmentCount(), compactTree.getSegmentCount());
+        for (double x = 50; x < 150; x += 7.3) {
+            Rectangle<double> rect(x, x, 3, 2);
+            auto runs = tree.findSegments(rect);
+            auto compactRuns = compactTree.findSegments(rect);
+            ASSERT_EQ(runs.size(), compactRuns.size());
+            for (size_t i = 0; i < runs.size(); i++) {
+                EXPECT_EQ(runs[i].min, compactRuns[i].min);
+                EXPECT_EQ(runs[i].max, compactRuns[i].max);
+            }
+        }
+
+        Stroke stroke;
+        stroke.setWidth(1);
+        for (const Point& p: points) { stroke.addPoint(p); }
+        stroke.compact(storage);
+        EXPECT_TRUE(stroke.intersects(points[500].x, points[500].y, 0.5));
+        EXPECT_FALSE(stroke.intersects(500, 500, 0.5));
+        EXPECT_EQ(0, stroke.getDecodedMemoryUsage());
+    }
+}
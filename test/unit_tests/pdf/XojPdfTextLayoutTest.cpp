@@ -0,0 +1,60 @@
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "pdf/base/XojPdfTextLayout.h"
+
+/**
+ * Two lines of 10 x 10 characters: "ab cd\n" at y = 0 and "ef" at y = 20
+ */
+static XojPdfTextLayout makeLayout() {
+    std::string text = "ab cd\nef";
+    std::vector<XojPdfRectangle> rects;
+    for (int i = 0; i < 6; i++) { rects.emplace_back(10 * i, 0, 10 * i + 10, 10); }
+    for (int i = 0; i < 2; i++) { rects.emplace_back(10 * i, 20, 10 * i + 10, 30); }
+    return XojPdfTextLayout(text, rects);
+}
+
+TEST(XojPdfTextLayout, testLines) {
+    auto layout = makeLayout();
+    EXPECT_EQ(layout.getCharCount(), 8);
+    EXPECT_EQ(layout.getLineCount(), 2);
+}
+
+TEST(XojPdfTextLayout, testLinearSelection) {
+    auto layout = makeLayout();
+
+    // From the middle of "b" to the middle of "d"
+    XojPdfRectangle rect(12, 5, 44, 5);
+    EXPECT_EQ(layout.selectText(rect, XojPdfPageSelectionStyle::Linear), "b c");
+
+    // Selecting backwards gives the same result
+    XojPdfRectangle backwards(44, 5, 12, 5);
+    EXPECT_EQ(layout.selectText(backwards, XojPdfPageSelectionStyle::Linear), "b c");
+
+    // Across the lines, one rectangle per line
+    XojPdfRectangle twoLines(22, 5, 12, 25);
+    EXPECT_EQ(layout.selectText(twoLines, XojPdfPageSelectionStyle::Linear), " cd\ne");
+    auto selection = layout.selectTextLines(twoLines, XojPdfPageSelectionStyle::Linear);
+    ASSERT_EQ(selection.rects.size(), 2);
+    EXPECT_EQ(selection.rects[0].x1, 20);
+    EXPECT_EQ(selection.rects[0].x2, 50);
+    EXPECT_EQ(selection.rects[1].x1, 0);
+    EXPECT_EQ(selection.rects[1].x2, 10);
+    EXPECT_EQ(selection.rects[1].y1, 20);
+    cairo_region_destroy(selection.region);
+}
+
+TEST(XojPdfTextLayout, testWordAndLineSelection) {
+    auto layout = makeLayout();
+
+    // Double click on "d"
+    XojPdfRectangle click(42, 5, 42, 5);
+    EXPECT_EQ(layout.selectText(click, XojPdfPageSelectionStyle::Word), "cd");
+    EXPECT_EQ(layout.selectText(click, XojPdfPageSelectionStyle::Line), "ab cd\n");
+
+    // Points outside of the text select from the nearest line
+    XojPdfRectangle below(-5, 100, 100, 100);
+    EXPECT_EQ(layout.selectText(below, XojPdfPageSelectionStyle::Linear), "ef");
+}
@@ -0,0 +1,128 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include "config-features.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <memory>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "plugin/PluginJob.h"
+
+extern "C" {
+#include <lauxlib.h>
+#include <lualib.h>
+}
+
+namespace {
+struct StateDeleter {
+    void operator()(lua_State* L) const { lua_close(L); }
+};
+using State = std::unique_ptr<lua_State, StateDeleter>;
+
+auto newState() -> State {
+    State L(luaL_newstate());
+    luaL_openlibs(L.get());
+    return L;
+}
+
+/**
+ * Copies the value of the Lua expression from one state to a new one, which is returned with the copy on its stack
+ */
+auto copyExpression(const std::string& expression) -> State {
+    State from = newState();
+    EXPECT_EQ(luaL_dostring(from.get(), ("return " + expression).c_str()), LUA_OK);
+    LuaValue value = LuaValue::fromStack(from.get(), -1);
+
+    State to = newState();
+    value.push(to.get());
+    lua_setglobal(to.get(), "copy");
+    return to;
+}
+
+/**
+ * Evaluates a boolean Lua expression in the state
+ */
+auto check(const State& L, const std::string& expression) -> bool {
+    EXPECT_EQ(luaL_dostring(L.get(), ("return " + expression).c_str()), LUA_OK) << lua_tostring(L.get(), -1);
+    bool result = lua_toboolean(L.get(), -1);
+    lua_pop(L.get(), 1);
+    return result;
+}
+
+/**
+ * @return The error raised by LuaValue::fromStack() on the value of the expression, empty if there is none
+ */
+auto fromStackError(const std::string& expression) -> std::string {
+    State L = newState();
+    EXPECT_EQ(luaL_dostring(L.get(), ("return " + expression).c_str()), LUA_OK);
+    lua_pushcfunction(L.get(), +[](lua_State* L) -> int {
+        LuaValue::fromStack(L, 1);
+        return 0;
+    });
+    lua_insert(L.get(), -2);
+    if (lua_pcall(L.get(), 1, 0, 0) == LUA_OK) {
+        return {};
+    }
+    return lua_tostring(L.get(), -1);
+}
+}  // namespace
+
+TEST(PluginLuaValue, testScalars) {
+    EXPECT_TRUE(check(copyExpression("nil"), "copy == nil"));
+    EXPECT_TRUE(check(copyExpression("true"), "copy == true"));
+    EXPECT_TRUE(check(copyExpression("false"), "copy == false"));
+    EXPECT_TRUE(check(copyExpression("-42"), "math.type(copy) == 'integer' and copy == -42"));
+    EXPECT_TRUE(check(copyExpression("math.maxinteger"), "copy == math.maxinteger"));
+    EXPECT_TRUE(check(copyExpression("0.1"), "math.type(copy) == 'float' and copy == 0.1"));
+    EXPECT_TRUE(check(copyExpression("2.0"), "math.type(copy) == 'float' and copy == 2.0"));
+    EXPECT_TRUE(check(copyExpression("'abc'"), "copy == 'abc'"));
+    // Packed buffers hold arbitrary bytes
+    EXPECT_TRUE(check(copyExpression("'a\\0b\\255'"), "copy == 'a\\0b\\255' and #copy == 4"));
+}
+
+TEST(PluginLuaValue, testTables) {
+    State L = copyExpression("{10, 20, [5] = 50, x = {y = {z = 'deep'}}, [true] = 'key', [1.5] = 'float'}");
+    EXPECT_TRUE(check(L, "copy[1] == 10 and copy[2] == 20 and copy[3] == nil and copy[5] == 50"));
+    EXPECT_TRUE(check(L, "copy.x.y.z == 'deep'"));
+    EXPECT_TRUE(check(L, "copy[true] == 'key' and copy[1.5] == 'float'"));
+
+    int count = 0;
+    lua_getglobal(L.get(), "copy");
+    lua_pushnil(L.get());
+    while (lua_next(L.get(), -2) != 0) {
+        count++;
+        lua_pop(L.get(), 1);
+    }
+    EXPECT_EQ(count, 6);
+
+    EXPECT_TRUE(check(copyExpression("{}"), "type(copy) == 'table' and next(copy) == nil"));
+}
+
+TEST(PluginLuaValue, testUnsupportedValues) {
+    EXPECT_EQ(fromStackError("{1, 2, {3}}"), "");
+    EXPECT_NE(fromStackError("print").find("not function"), std::string::npos);
+    EXPECT_NE(fromStackError("{f = print}").find("not function"), std::string::npos);
+    EXPECT_NE(fromStackError("coroutine.create(print)").find("not thread"), std::string::npos);
+
+    // Cycles are caught by the depth limit
+    EXPECT_NE(fromStackError("(function() local t = {} t.t = t return t end)()").find("nested too deeply"),
+              std::string::npos);
+    EXPECT_NE(fromStackError("(function() local t = {} for i = 1, 40 do t = {t} end return t end)()")
+                      .find("nested too deeply"),
+              std::string::npos);
+    EXPECT_EQ(fromStackError("(function() local t = {} for i = 1, 20 do t = {t} end return t end)()"), "");
+}
+
+#endif
@@ -0,0 +1,159 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include "config-features.h"
+
+#ifdef ENABLE_PLUGINS
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "model/Layer.h"
+#include "model/Point.h"
+#include "model/Stroke.h"
+#include "plugin/PackedStrokes.h"
+
+#include "config-test.h"
+
+/**
+ * Packs the coordinates as app.addStrokesPacked expects them
+ */
+static auto pack(const std::vector<double>& values) -> std::string {
+    return std::string(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+}
+
+TEST(PluginPackedStrokes, testCreate) {
+    Stroke style;
+    style.setWidth(2.5);
+    style.setColor(Color(0x808000U));
+
+    // Unaligned buffer: the points start one byte into the string
+    std::string data = "x" + pack({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+    auto strokes = createPackedStrokes(data.data() + 1, {3, 1, 1}, false, style);
+    ASSERT_EQ(strokes.size(), 1U);
+    auto* s = dynamic_cast<Stroke*>(strokes[0]);
+    ASSERT_TRUE(s);
+    ASSERT_EQ(s->getPointCount(), 3);
+    EXPECT_EQ(s->getPoint(2).x, 5);
+    EXPECT_EQ(s->getPoint(2).y, 6);
+    EXPECT_EQ(s->getPoint(2).z, Point::NO_PRESSURE);
+    EXPECT_EQ(s->getWidth(), 2.5);
+    EXPECT_EQ(s->getColor(), Color(0x808000U));
+    delete s;
+
+    data = pack({1, 2, 0.5, 3, 4, 0.75, 5, 6, 1, 7, 8, 1.25});
+    strokes = createPackedStrokes(data.data(), {2, 2}, true, style);
+    ASSERT_EQ(strokes.size(), 2U);
+    s = dynamic_cast<Stroke*>(strokes[1]);
+    ASSERT_TRUE(s);
+    EXPECT_EQ(s->getPoint(0).x, 5);
+    EXPECT_EQ(s->getPoint(0).z, 1);
+    for (Element* e: strokes) { delete e; }
+}
+
+#ifdef TEST_CHECK_SPEED
+/**
+ * A synthetic import: STROKE_COUNT strokes of POINT_COUNT points with pressure
+ */
+constexpr size_t STROKE_COUNT = 20000;
+constexpr size_t POINT_COUNT = 50;
+
+static auto makeCoordinates() -> std::vector<double> {
+    std::vector<double> values;
+    values.reserve(STROKE_COUNT * POINT_COUNT * 3);
+    for (size_t i = 0; i < STROKE_COUNT; ++i) {
+        for (size_t j = 0; j < POINT_COUNT; ++j) {
+            double t = static_cast<double>(j) * 0.1;
+            values.push_back(static_cast<double>(i % 100) * 6 + t);
+            values.push_back(static_cast<double>(i / 100) * 4 + std::sin(t));
+            values.push_back(0.5 + 0.01 * static_cast<double>(j));
+        }
+    }
+    return values;
+}
+
+TEST(PluginPackedStrokes, benchmarkAddStrokes) {
+    const std::vector<double> values = makeCoordinates();
+    Stroke style;
+    style.setWidth(1.0);
+
+    // As app.addStrokes, once the coordinates are read from the tables: point by point, stroke by stroke
+    auto start = std::chrono::steady_clock::now();
+    {
+        Layer layer;
+        for (size_t i = 0; i < STROKE_COUNT; ++i) {
+            auto* stroke = new Stroke();
+            stroke->applyStyleFrom(&style);
+            for (size_t j = i * POINT_COUNT; j < (i + 1) * POINT_COUNT; ++j) {
+                stroke->addPoint(Point(values[3 * j], values[3 * j + 1], values[3 * j + 2]));
+            }
+            layer.addElement(stroke);
+        }
+        EXPECT_EQ(layer.getElements().size(), STROKE_COUNT);
+    }
+    auto perStroke = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // As app.addStrokesPacked
+    const std::string data = pack(values);
+    const std::vector<size_t> counts(STROKE_COUNT, POINT_COUNT);
+    start = std::chrono::steady_clock::now();
+    {
+        Layer layer;
+        layer.addElements(createPackedStrokes(data.data(), counts, true, style));
+        EXPECT_EQ(layer.getElements().size(), STROKE_COUNT);
+    }
+    auto packed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << STROKE_COUNT << " strokes: " << perStroke << " ms with addStrokes, " << packed
+              << " ms with addStrokesPacked" << std::endl;
+}
+
+TEST(PluginPackedStrokes, benchmarkLayerAddElements) {
+    Stroke style;
+    auto makeStrokes = [&style] {
+        std::vector<Element*> strokes;
+        strokes.reserve(STROKE_COUNT);
+        for (size_t i = 0; i < STROKE_COUNT; ++i) {
+            auto* stroke = new Stroke();
+            stroke->applyStyleFrom(&style);
+            strokes.push_back(stroke);
+        }
+        return strokes;
+    };
+
+    auto strokes = makeStrokes();
+    auto start = std::chrono::steady_clock::now();
+    {
+        Layer layer;
+        for (Element* e: strokes) { layer.addElement(e); }
+    }
+    auto repeated = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    strokes = makeStrokes();
+    start = std::chrono::steady_clock::now();
+    {
+        Layer layer;
+        layer.addElements(strokes);
+    }
+    auto batch = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << STROKE_COUNT << " elements: " << repeated << " ms with addElement, " << batch
+              << " ms with addElements" << std::endl;
+}
+#endif
+
+#endif
@@ -1,4 +1,9 @@
 #include <array>
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
 #include <random>
 #include <string>
 #include <tuple>
@@ -13,7 +18,10 @@
 #include "util/serializing/ObjectInputStream.h"
 #include "util/serializing/ObjectOutputStream.h"
 
+#include "config-test.h"
+
 extern const char* XML_VERSION_STR;
+extern const char* XML_FAST_VERSION_STR;
 
 
 template <typename T, unsigned N>
@@ -349,3 +357,121 @@ TEST(UtilObjectIOStream, testReadStroke) {
         FAIL();
     }
 }
+
+/**
+ * Strokes of a handwriting-like page
+ */
+static auto makeStrokes(size_t count, size_t pointCount) -> std::vector<Stroke> {
+    std::mt19937 gen(4242);
+    std::uniform_real_distribution<double> distrib(-0.5, 0.5);
+
+    std::vector<Stroke> strokes(count);
+    for (size_t i = 0; i < count; ++i) {
+        double x = static_cast<double>(i % 20) * 25;
+        double y = static_cast<double>(i / 20) * 25;
+        for (size_t j = 0; j < pointCount; ++j) {
+            x += distrib(gen);
+            y += distrib(gen);
+            strokes[i].addPoint(Point(x, y, 0.5 + distrib(gen)));
+        }
+        strokes[i].setWidth(1.41);
+    }
+    return strokes;
+}
+
+static auto serializeStrokes(ObjectOutputStream& out, const std::vector<Stroke>& strokes) -> std::string {
+    out.writeSizeT(strokes.size());
+    for (const Stroke& stroke: strokes) { stroke.serialize(out); }
+    auto outStr = out.getStr();
+    std::string str(outStr->str, outStr->len);
+    g_string_free(outStr, true);
+    return str;
+}
+
+static auto readStrokes(const std::string& str) -> std::vector<Stroke> {
+    ObjectInputStream in;
+    EXPECT_TRUE(in.read(str.c_str(), static_cast<int>(str.size())));
+    std::vector<Stroke> strokes(in.readSizeT());
+    for (Stroke& stroke: strokes) { stroke.readSerialized(in); }
+    return strokes;
+}
+
+TEST(UtilObjectIOStream, testReadFastStream) {
+    auto strokes = makeStrokes(20, 100);
+    // Redundant data, which is compressed
+    strokes.emplace_back();
+    for (int i = 0; i < 1000; ++i) { strokes.back().addPoint(Point(i % 10, 0)); }
+
+    std::string legacy;
+    {
+        ObjectOutputStream out(new BinObjectEncoding);
+        legacy = serializeStrokes(out, strokes);
+    }
+
+    for (auto compression: {ObjectOutputStream::Compression::NONE, ObjectOutputStream::Compression::FAST}) {
+        ObjectOutputStream out(compression);
+        std::string str = serializeStrokes(out, strokes);
+        if (compression == ObjectOutputStream::Compression::NONE) {
+            // Older versions read the uncompressed stream
+            EXPECT_EQ(legacy, str);
+        } else {
+            EXPECT_LT(str.size(), legacy.size());
+            EXPECT_EQ(0, str.compare(2 + sizeof(int), strlen(XML_FAST_VERSION_STR), XML_FAST_VERSION_STR));
+        }
+
+        try {
+            auto inStrokes = readStrokes(str);
+            ASSERT_EQ(strokes.size(), inStrokes.size());
+            for (size_t i = 0; i < strokes.size(); ++i) { assertStrokeEquality(strokes[i], inStrokes[i]); }
+        } catch (InputStreamException& e) {
+            std::cerr << "InputStreamException testing fast stream: " << e.what() << std::endl;
+            FAIL();
+        }
+    }
+
+    // Both versions are read
+    EXPECT_EQ(strokes.size(), readStrokes(legacy).size());
+}
+
+TEST(UtilObjectIOStream, testReadCorruptStream) {
+    auto strokes = makeStrokes(10, 100);
+    ObjectOutputStream out(ObjectOutputStream::Compression::FAST);
+    std::string str = serializeStrokes(out, strokes);
+
+    ObjectInputStream stream;
+    EXPECT_FALSE(stream.read(str.c_str(), static_cast<int>(str.size() / 2)));
+
+    ObjectInputStream truncated;
+    str = serializeString("Hello World");
+    EXPECT_TRUE(truncated.read(str.c_str(), static_cast<int>(str.size() - 3)));
+    EXPECT_THROW(truncated.readString(), InputStreamException);
+}
+
+#ifdef TEST_CHECK_SPEED
+TEST(UtilObjectIOStream, benchmarkStrokes) {
+    auto strokes = makeStrokes(2000, 500);
+
+    auto benchmark = [&](const char* name, const std::function<ObjectOutputStream*()>& makeStream, bool readable) {
+        auto start = std::chrono::steady_clock::now();
+        std::unique_ptr<ObjectOutputStream> out(makeStream());
+        std::string str = serializeStrokes(*out, strokes);
+        auto write = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << name << ": " << str.size() / 1000 << " kB, written in " << write << " ms";
+        if (readable) {
+            start = std::chrono::steady_clock::now();
+            auto inStrokes = readStrokes(str);
+            auto read = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            EXPECT_EQ(strokes.size(), inStrokes.size());
+            std::cout << ", read in " << read << " ms";
+        }
+        std::cout << std::endl;
+    };
+
+    benchmark("Binary encoding", [] { return new ObjectOutputStream(new BinObjectEncoding); }, true);
+    benchmark("Hex encoding", [] { return new ObjectOutputStream(new HexObjectEncoding); }, false);
+    benchmark("Binary stream", [] { return new ObjectOutputStream; }, true);
+    benchmark("Compressed binary stream", [] { return new ObjectOutputStream(ObjectOutputStream::Compression::FAST); },
+              true);
+}
+#endif
@@ -9,11 +9,16 @@
  * @license GNU GPLv2 or later
  */
 
+#include <chrono>
 #include <cstdlib>
 #include <ctime>
+#include <iostream>
 
 #include <gtest/gtest.h>
+#include <zlib.h>
 
+#include "util/GzUtil.h"
+#include "util/PathUtil.h"
 #include "util/XojPreviewExtractor.h"
 
 #include "config-test.h"
@@ -104,3 +109,78 @@ TEST(UtilXojPreviewExtractor, testInvalidFile) {
 
     EXPECT_EQ(PREVIEW_RESULT_ERROR_READING_PREVIEW, result);
 }
+
+/**
+ * Write a gzipped document whose preview decodes to previewLen times "xxx", followed by pages of strokes
+ */
+static void writeDocument(const fs::path& path, size_t previewLen, int pageCount) {
+    gzFile fp = GzUtil::openPath(path, "w");
+    ASSERT_TRUE(fp);
+    gzputs(fp, "<?xml version=\"1.0\" standalone=\"no\"?>\n<xournal creator=\"xournalpp\" fileversion=\"4\">\n"
+               "<title>Xournal++ document - see https://github.com/xournalpp/xournalpp</title>\n<preview>");
+    for (size_t i = 0; i < previewLen; i++) { gzputs(fp, "eHh4"); }
+    gzputs(fp, "</preview>\n");
+
+    string coordinates;
+    for (int i = 0; i < 200; i++) {
+        coordinates += std::to_string(100 + i * 0.37) + " " + std::to_string(300 - i * 0.21) + " ";
+    }
+    for (int page = 0; page < pageCount; page++) {
+        gzputs(fp, "<page width=\"595.27\" height=\"841.89\"><background type=\"solid\" color=\"#ffffffff\" "
+                   "style=\"lined\"/>\n<layer>\n");
+        for (int s = 0; s < 100; s++) {
+            gzputs(fp, "<stroke tool=\"pen\" color=\"#000000ff\" width=\"1.41\">");
+            gzputs(fp, coordinates.c_str());
+            gzputs(fp, "</stroke>\n");
+        }
+        gzputs(fp, "</layer>\n</page>\n");
+    }
+    gzputs(fp, "</xournal>\n");
+    gzclose(fp);
+}
+
+TEST(UtilXojPreviewExtractor, testLoadLargePreview) {
+    // The preview does not fit into the first block of the inflated document
+    auto path = Util::getTmpDirSubfolder() / "large-preview.xopp";
+    writeDocument(path, 10000, 2);
+
+    XojPreviewExtractor extractor;
+    EXPECT_EQ(PREVIEW_RESULT_IMAGE_READ, extractor.readFile(path));
+
+    gsize dataLen = 0;
+    unsigned char* imageData = extractor.getData(dataLen);
+    EXPECT_EQ(string(30000, 'x'), string((char*)imageData, (size_t)dataLen));
+}
+
+#ifdef TEST_CHECK_SPEED
+TEST(UtilXojPreviewExtractor, benchmarkLargeFiles) {
+    auto dir = Util::getTmpDirSubfolder("preview-bench");
+    std::vector<fs::path> files;
+    for (int i = 0; i < 10; i++) {
+        files.push_back(dir / ("large" + std::to_string(i) + ".xopp"));
+        writeDocument(files.back(), 2000, 20);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& f: files) {
+        XojPreviewExtractor extractor;
+        EXPECT_EQ(PREVIEW_RESULT_IMAGE_READ, extractor.readFile(f));
+    }
+    auto previews = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    // For comparison: inflating the whole files
+    start = std::chrono::steady_clock::now();
+    std::vector<char> buffer(1 << 16);
+    size_t inflated = 0;
+    for (const auto& f: files) {
+        gzFile fp = GzUtil::openPath(f, "r");
+        int len = 0;
+        while ((len = gzread(fp, buffer.data(), static_cast<unsigned>(buffer.size()))) > 0) { inflated += len; }
+        gzclose(fp);
+    }
+    auto full = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Extracting the previews of " << files.size() << " files of " << inflated / files.size() / 1000000
+              << " MB: " << previews << " ms, inflating the whole files: " << full << " ms" << std::endl;
+}
+#endif
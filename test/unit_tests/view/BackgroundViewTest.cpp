@@ -0,0 +1,154 @@
+/*
+ * Xournal++
+ *
+ * This file is part of the Xournal UnitTests
+ *
+ * @author Xournal++ Team
+ * https://github.com/xournalpp/xournalpp
+ *
+ * @license GNU GPLv2 or later
+ */
+
+#include <algorithm>
+#include <cstdlib>
+
+#include <cairo.h>
+#include <gtest/gtest.h>
+
+#include "model/BackgroundConfig.h"
+#include "view/background/DottedBackgroundView.h"
+#include "view/background/GraphBackgroundView.h"
+#include "view/background/RuledBackgroundView.h"
+
+constexpr int WIDTH = 200;
+constexpr int HEIGHT = 300;
+
+/**
+ * Renders the background with the transformation (zoom, offset), directly onto an image surface, or through a
+ * recording surface, on which the pattern is drawn line by line
+ */
+static auto render(const xoj::view::BackgroundView& view, double zoom, double offset, bool direct)
+        -> cairo_surface_t* {
+    cairo_surface_t* image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, WIDTH, HEIGHT);
+    cairo_surface_t* target = direct ? cairo_recording_surface_create(CAIRO_CONTENT_COLOR_ALPHA, nullptr) : image;
+
+    cairo_t* cr = cairo_create(target);
+    cairo_rectangle(cr, 0, 0, WIDTH, HEIGHT);
+    cairo_clip(cr);
+    cairo_translate(cr, offset, offset);
+    cairo_scale(cr, zoom, zoom);
+    view.draw(cr);
+    cairo_destroy(cr);
+
+    if (direct) {
+        cr = cairo_create(image);
+        cairo_set_source_surface(cr, target, 0, 0);
+        cairo_paint(cr);
+        cairo_destroy(cr);
+        cairo_surface_destroy(target);
+    }
+    cairo_surface_flush(image);
+    return image;
+}
+
+/**
+ * Largest difference of a channel between the tiled and the direct rendering
+ */
+static auto maxDifference(const xoj::view::BackgroundView& view, double zoom, double offset) -> int {
+    cairo_surface_t* tiled = render(view, zoom, offset, false);
+    cairo_surface_t* direct = render(view, zoom, offset, true);
+
+    const unsigned char* a = cairo_image_surface_get_data(tiled);
+    const unsigned char* b = cairo_image_surface_get_data(direct);
+    const int stride = cairo_image_surface_get_stride(tiled);
+    int difference = 0;
+    for (int i = 0; i < stride * HEIGHT; i++) {
+        difference = std::max(difference, std::abs(a[i] - b[i]));
+    }
+
+    cairo_surface_destroy(tiled);
+    cairo_surface_destroy(direct);
+    return difference;
+}
+
+/**
+ * Sum of the darkness of all channels, i.e. the amount of ink on a white background
+ */
+static auto ink(cairo_surface_t* image) -> long {
+    const unsigned char* data = cairo_image_surface_get_data(image);
+    const int stride = cairo_image_surface_get_stride(image);
+    long sum = 0;
+    for (int i = 0; i < stride * HEIGHT; i++) {
+        sum += 255 - data[i];
+    }
+    return sum;
+}
+
+/**
+ * Exposes the tiling of the pattern
+ */
+class PeriodicGraphView: public xoj::view::GraphBackgroundView {
+public:
+    using GraphBackgroundView::GraphBackgroundView;
+    using OneColorBackgroundView::paintPeriodic;
+};
+
+TEST(BackgroundView, testPeriodicTileMatchesDirectDrawing) {
+    BackgroundConfig config("");
+    xoj::view::RuledBackgroundView view(WIDTH, HEIGHT, Color(0xffffffU), config);
+
+    // Whole numbers of pixels per period, and sub-pixel offsets
+    for (double zoom: {1.0, 0.75}) {
+        for (double offset: {0.0, 0.3, 7.5}) {
+            // Only the rounding of the antialiasing may differ
+            EXPECT_LE(maxDifference(view, zoom, offset), 2) << "zoom " << zoom << ", offset " << offset;
+        }
+    }
+}
+
+TEST(BackgroundView, testPeriodicTileAtFractionalZoom) {
+    BackgroundConfig config("");
+    xoj::view::RuledBackgroundView ruled(WIDTH, HEIGHT, Color(0xffffffU), config);
+    xoj::view::GraphBackgroundView graph(WIDTH, HEIGHT, Color(0xffffffU), config);
+    xoj::view::DottedBackgroundView dotted(WIDTH, HEIGHT, Color(0xffffffU), config);
+
+    // Fractional numbers of pixels per period, for which several periods fit in a whole number of pixels
+    for (double zoom: {1.3, 0.61, 96.0 / 72.0}) {
+        for (double offset: {0.0, 0.3, 7.5}) {
+            // The pixels of the tile are shifted by at most 1/16 pixel from those of the target
+            EXPECT_LE(maxDifference(ruled, zoom, offset), 24) << "ruled, zoom " << zoom << ", offset " << offset;
+            EXPECT_LE(maxDifference(graph, zoom, offset), 24) << "graph, zoom " << zoom << ", offset " << offset;
+            EXPECT_LE(maxDifference(dotted, zoom, offset), 24) << "dotted, zoom " << zoom << ", offset " << offset;
+        }
+    }
+}
+
+TEST(BackgroundView, testPeriodicTileInterpolated) {
+    BackgroundConfig config("");
+    PeriodicGraphView view(WIDTH, HEIGHT, Color(0xffffffU), config);
+
+    // 14.17 * 2 pixels per period: no tile of at most 512 pixels stays aligned with the target
+    const double zoom = 2.0;
+    cairo_surface_t* image = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, WIDTH, HEIGHT);
+    cairo_t* cr = cairo_create(image);
+    cairo_scale(cr, zoom, zoom);
+    const bool painted = view.paintPeriodic(cr, 0, 0, WIDTH, HEIGHT, 0, 0, 14.17, 14.17, CAIRO_LINE_CAP_SQUARE,
+                                            [](cairo_t* cr) {
+                                                cairo_move_to(cr, 0, 0);
+                                                cairo_line_to(cr, 14.17, 0);
+                                            });
+    cairo_destroy(cr);
+    cairo_surface_destroy(image);
+    EXPECT_TRUE(painted);
+
+    // The interpolated pattern keeps its period: the amount of ink matches the direct drawing
+    for (double offset: {0.0, 0.3, 7.5}) {
+        cairo_surface_t* tiled = render(view, zoom, offset, false);
+        cairo_surface_t* direct = render(view, zoom, offset, true);
+        const long tiledInk = ink(tiled);
+        const long directInk = ink(direct);
+        EXPECT_NEAR(static_cast<double>(tiledInk) / static_cast<double>(directInk), 1.0, 0.03) << "offset " << offset;
+        cairo_surface_destroy(tiled);
+        cairo_surface_destroy(direct);
+    }
+}